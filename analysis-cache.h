@@ -0,0 +1,411 @@
+#ifndef ANALYSIS_CACHE_H
+#define ANALYSIS_CACHE_H
+
+//** Remembering analysis results between runs **//
+
+// Running naming-check over a big tree again usually means analyzing files that haven't changed since last time.
+// AnalysisCache keeps each file's NamingAnalysis (naming-rules.h) in a file on disk, so the next run can reuse it:
+
+//     const AnalysisCache cache{ "naming-check.cache" };        // empty if the file is missing or unusable
+//     const CacheEntry* entry{ cache.find(path) };
+//     if (entry && stampOf(path, stamp) && entry->stamp == stamp && cache.analysis(*entry, analysis))
+//         ...                                                   // unchanged: no need to even open the file
+//     saveAnalysisCache("naming-check.cache", records);         // the results of this run, for the next one
+
+// Deciding whether a file changed takes two steps:
+    // The stamp (modification time and size, from one stat call) is compared first. If both match, the file is
+    // taken to be unchanged without reading it.
+    // If the stamp differs, the file is read and its xxHash64 (xxhash.h) is compared with the stored one. A file
+    // that was touched or checked out again without changing its content is still a hit.
+// A file modified in the same instant the cache is written could get a new stamp that looks identical to the old
+// one on a file system with coarse timestamps. So an entry whose file changed less than two seconds before saving
+// is stored without a stamp, and its content is hashed on the next run. The stamp is taken before the file is read,
+// and a file whose stamp has changed by the time the read finishes isn't stored at all (CacheRecord::cacheable).
+
+// The cache file is memory mapped (MappedInput, mapped-input.h) and used in place. Loading it only checks its
+// checksum (xxHash64 again, at several GB/s); nothing is copied or parsed up front. Finding a file is a search in a
+// sorted table of fixed-size entries, and a file's analysis is decoded only when it's asked for. (The search is an
+// interpolation search: hashes are evenly spread, so a hash's value says roughly where its entry is.) Its layout:
+    // header:  magic, format version, namingRulesVersion, byte order check, entry count, checksum
+    // entries: one CacheEntry per file, sorted by path hash (then path)
+    // data:    for each entry, its path followed by its analysis
+// The file is written in the machine's byte order and isn't meant to be moved between machines. A cache that is
+// damaged, from another format or rules version, or from a machine with the other byte order is ignored; the run
+// then analyzes everything and writes a fresh one. Writing goes to a temporary file that is then renamed over the
+// old one, so an interrupted run never leaves a half-written cache.
+
+#include <algorithm>
+#include <cerrno>
+#include <cstddef>
+#include <cstdint>
+#include <cstdio>
+#include <cstring>
+#include <ctime>
+#include <fcntl.h>
+#include <string>
+#include <string_view>
+#include <sys/stat.h>
+#include <unistd.h>
+#include <vector>
+
+#include "mapped-input.h"
+#include "naming-rules.h"
+#include "xxhash.h"
+
+// What one stat call says about a file.
+struct FileStamp
+{
+    std::int64_t modified{ 0 }; // nanoseconds since the epoch; 0 means unknown
+    std::uint64_t size{ 0 };
+
+    friend bool operator==(const FileStamp&, const FileStamp&) = default;
+};
+
+inline bool stampOf(const char* path, FileStamp& stamp)
+{
+    struct stat info{ };
+    if (::stat(path, &info) != 0)
+        return false;
+    stamp.modified = static_cast<std::int64_t>(info.st_mtim.tv_sec) * 1'000'000'000 + info.st_mtim.tv_nsec;
+    stamp.size = static_cast<std::uint64_t>(info.st_size);
+    return true;
+}
+
+struct CacheEntry
+{
+    std::uint64_t pathHash{ };
+    std::uint64_t contentHash{ };
+    FileStamp stamp{ };
+    std::uint64_t dataOffset{ }; // from the start of the cache file: the path, then the analysis
+    std::uint32_t pathSize{ };
+    std::uint32_t analysisSize{ };
+};
+
+// One file's results, to be saved.
+struct CacheRecord
+{
+    std::string path{ };
+    FileStamp stamp{ };
+    std::uint64_t contentHash{ };
+    NamingAnalysis analysis{ };
+    bool cacheable{ true }; // false if the file changed while it was read: not saved by saveAnalysisCache()
+};
+
+namespace analysisCacheDetail
+{
+    constexpr char magic[8]{ 'N', 'A', 'M', 'I', 'N', 'G', 'C', 'H' };
+    constexpr std::uint32_t formatVersion{ 1 };
+    constexpr std::uint32_t byteOrderCheck{ 0x01020304 };
+    constexpr std::int64_t racyWindow{ 2'000'000'000 }; // nanoseconds
+
+    struct Header
+    {
+        char magic[8]{ };
+        std::uint32_t formatVersion{ };
+        std::uint32_t rulesVersion{ };
+        std::uint32_t byteOrder{ };
+        std::uint32_t reserved{ 0 };
+        std::uint64_t entryCount{ };
+        std::uint64_t checksum{ }; // xxHash64 of everything after the header
+    };
+
+    inline std::uint64_t hashPath(std::string_view path) { return xxHash64(path.data(), path.size()); }
+
+    // The analysis is stored as a sequence of 32-bit numbers and raw name bytes:
+    //     identifiers, keywords, contextual keywords, numbers,
+    //     count of keywords used, then (keyword index, uses) for each,
+    //     count of violations, then (line, column, rule, name size, name bytes) for each.
+    class Writer
+    {
+    public:
+        explicit Writer(std::string& out)
+            : m_out{ out }
+        {
+        }
+
+        void number(std::uint64_t value)
+        {
+            const std::uint32_t narrow{ static_cast<std::uint32_t>(value) };
+            bytes(&narrow, sizeof(narrow));
+        }
+
+        void bytes(const void* data, std::size_t size) { m_out.append(static_cast<const char*>(data), size); }
+
+    private:
+        std::string& m_out;
+    };
+
+    // Reads what Writer wrote. Stops (and fails) instead of reading past the end.
+    class Reader
+    {
+    public:
+        explicit Reader(std::string_view data)
+            : m_data{ data }
+        {
+        }
+
+        std::uint32_t number()
+        {
+            std::uint32_t value{ 0 };
+            if (m_data.size() < sizeof(value))
+            {
+                m_ok = false;
+                return 0;
+            }
+            std::memcpy(&value, m_data.data(), sizeof(value));
+            m_data.remove_prefix(sizeof(value));
+            return value;
+        }
+
+        std::string_view bytes(std::size_t size)
+        {
+            if (m_data.size() < size)
+            {
+                m_ok = false;
+                return { };
+            }
+            const std::string_view result{ m_data.substr(0, size) };
+            m_data.remove_prefix(size);
+            return result;
+        }
+
+        bool ok() const { return m_ok; }
+
+    private:
+        std::string_view m_data{ };
+        bool m_ok{ true };
+    };
+
+    inline void writeAnalysis(const NamingAnalysis& analysis, std::string& out)
+    {
+        Writer writer{ out };
+        const WordCounts& counts{ analysis.counts };
+        writer.number(counts.identifiers);
+        writer.number(counts.keywords);
+        writer.number(counts.contextualKeywords);
+        writer.number(counts.numbers);
+
+        writer.number(static_cast<std::size_t>(
+            std::count_if(counts.byKeyword.begin(), counts.byKeyword.end(), [](std::uint32_t uses) { return uses != 0; })));
+        for (std::size_t i{ 0 }; i < counts.byKeyword.size(); ++i)
+        {
+            if (counts.byKeyword[i] != 0)
+            {
+                writer.number(i);
+                writer.number(counts.byKeyword[i]);
+            }
+        }
+
+        writer.number(analysis.violations.size());
+        for (const NamingViolation& violation : analysis.violations)
+        {
+            writer.number(violation.line);
+            writer.number(violation.column);
+            writer.number(static_cast<std::uint32_t>(violation.rule));
+            writer.number(violation.name.size());
+            writer.bytes(violation.name.data(), violation.name.size());
+        }
+    }
+
+    inline bool readAnalysis(std::string_view data, NamingAnalysis& analysis)
+    {
+        Reader reader{ data };
+        WordCounts& counts{ analysis.counts };
+        counts = { };
+        counts.identifiers = reader.number();
+        counts.keywords = reader.number();
+        counts.contextualKeywords = reader.number();
+        counts.numbers = reader.number();
+
+        for (std::uint32_t used{ reader.number() }; used != 0 && reader.ok(); --used)
+        {
+            const std::uint32_t index{ reader.number() };
+            const std::uint32_t uses{ reader.number() };
+            if (index >= counts.byKeyword.size())
+                return false;
+            counts.byKeyword[index] = uses;
+        }
+
+        analysis.violations.clear();
+        std::uint32_t remaining{ reader.number() };
+        analysis.violations.reserve(std::min<std::size_t>(remaining, data.size() / 16)); // 16: the fixed part of each
+        for (; remaining != 0 && reader.ok(); --remaining)
+        {
+            NamingViolation violation{ };
+            violation.line = reader.number();
+            violation.column = reader.number();
+            violation.rule = static_cast<NamingRule>(reader.number());
+            violation.name = reader.bytes(reader.number());
+            analysis.violations.push_back(std::move(violation));
+        }
+        return reader.ok();
+    }
+}
+
+class AnalysisCache
+{
+public:
+    explicit AnalysisCache(const char* path)
+        : m_input{ path }
+    {
+        using namespace analysisCacheDetail;
+
+        const std::string_view text{ m_input.text() };
+        Header header{ };
+        if (!m_input || text.size() < sizeof(header))
+            return;
+        std::memcpy(&header, text.data(), sizeof(header));
+        if (std::memcmp(header.magic, magic, sizeof(magic)) != 0 || header.formatVersion != formatVersion
+            || header.rulesVersion != namingRulesVersion || header.byteOrder != byteOrderCheck
+            || header.entryCount > (text.size() - sizeof(header)) / sizeof(CacheEntry)
+            || xxHash64(text.data() + sizeof(header), text.size() - sizeof(header)) != header.checksum)
+        {
+            return;
+        }
+
+        // The entries start right after the header, which keeps them 8-byte aligned in the mapping.
+        m_entries = reinterpret_cast<const CacheEntry*>(text.data() + sizeof(header));
+        m_entryCount = header.entryCount;
+    }
+
+    std::size_t size() const { return m_entryCount; }
+
+    // The entry for path, or nullptr if the cache doesn't have one.
+    const CacheEntry* find(std::string_view path) const
+    {
+        if (m_entryCount == 0)
+            return nullptr;
+
+        // Path hashes are spread evenly over all 64-bit values, so the entry is almost always within a few places
+        // of where its hash says it should be. Start there and step toward it, instead of binary searching.
+        const std::uint64_t pathHash{ analysisCacheDetail::hashPath(path) };
+        std::size_t position{ static_cast<std::size_t>((static_cast<unsigned __int128>(pathHash) * m_entryCount) >> 64) };
+        while (position > 0 && m_entries[position].pathHash >= pathHash)
+            --position;
+        while (position < m_entryCount && m_entries[position].pathHash < pathHash)
+            ++position;
+
+        for (; position < m_entryCount && m_entries[position].pathHash == pathHash; ++position)
+        {
+            if (pathOf(m_entries[position]) == path)
+                return &m_entries[position];
+        }
+        return nullptr;
+    }
+
+    std::string_view pathOf(const CacheEntry& entry) const
+    {
+        return bytesAt(entry.dataOffset, entry.pathSize);
+    }
+
+    // The stored analysis. False (and the cache should be treated as missing this file) if it's damaged.
+    bool analysis(const CacheEntry& entry, NamingAnalysis& analysis) const
+    {
+        const std::string_view data{ bytesAt(entry.dataOffset + entry.pathSize, entry.analysisSize) };
+        return data.size() == entry.analysisSize && analysisCacheDetail::readAnalysis(data, analysis);
+    }
+
+private:
+    std::string_view bytesAt(std::uint64_t offset, std::uint64_t size) const
+    {
+        const std::string_view text{ m_input.text() };
+        if (offset > text.size() || size > text.size() - offset)
+            return { };
+        return text.substr(offset, size);
+    }
+
+    MappedInput m_input;
+    const CacheEntry* m_entries{ nullptr };
+    std::size_t m_entryCount{ 0 };
+};
+
+// Write a cache holding records, replacing the file at path. False (with errno set) if it couldn't be written.
+inline bool saveAnalysisCache(const char* path, const std::vector<const CacheRecord*>& records)
+{
+    using namespace analysisCacheDetail;
+
+    struct Sorted
+    {
+        std::uint64_t pathHash{ };
+        const CacheRecord* record{ };
+    };
+    std::vector<Sorted> sorted{ };
+    sorted.reserve(records.size());
+    for (const CacheRecord* record : records)
+    {
+        if (record->cacheable)
+            sorted.push_back({ hashPath(record->path), record });
+    }
+    std::sort(sorted.begin(), sorted.end(), [](const Sorted& a, const Sorted& b) {
+        return a.pathHash != b.pathHash ? a.pathHash < b.pathHash : a.record->path < b.record->path;
+    });
+
+    timespec now{ };
+    ::clock_gettime(CLOCK_REALTIME, &now);
+    const std::int64_t nowNanoseconds{ static_cast<std::int64_t>(now.tv_sec) * 1'000'000'000 + now.tv_nsec };
+
+    std::vector<CacheEntry> entries{ };
+    entries.reserve(sorted.size());
+    std::string data{ };
+    const std::uint64_t dataStart{ sizeof(Header) + sorted.size() * sizeof(CacheEntry) };
+    for (const Sorted& item : sorted)
+    {
+        const CacheRecord& record{ *item.record };
+        CacheEntry entry{ };
+        entry.pathHash = item.pathHash;
+        entry.contentHash = record.contentHash;
+        entry.stamp = record.stamp;
+        if (nowNanoseconds - record.stamp.modified < racyWindow)
+            entry.stamp.modified = 0; // too recent to trust: check the content next time
+        entry.dataOffset = dataStart + data.size();
+        entry.pathSize = static_cast<std::uint32_t>(record.path.size());
+        data += record.path;
+        const std::size_t analysisStart{ data.size() };
+        writeAnalysis(record.analysis, data);
+        entry.analysisSize = static_cast<std::uint32_t>(data.size() - analysisStart);
+        entries.push_back(entry);
+    }
+
+    std::string file(sizeof(Header), '\0');
+    file.append(reinterpret_cast<const char*>(entries.data()), entries.size() * sizeof(CacheEntry));
+    file += data;
+
+    Header header{ };
+    std::memcpy(header.magic, magic, sizeof(magic));
+    header.formatVersion = formatVersion;
+    header.rulesVersion = namingRulesVersion;
+    header.byteOrder = byteOrderCheck;
+    header.entryCount = entries.size();
+    header.checksum = xxHash64(file.data() + sizeof(header), file.size() - sizeof(header));
+    std::memcpy(file.data(), &header, sizeof(header));
+
+    const std::string temporary{ std::string{ path } + ".tmp" };
+    const int fd{ ::open(temporary.c_str(), O_WRONLY | O_CREAT | O_TRUNC | O_CLOEXEC, 0644) };
+    if (fd < 0)
+        return false;
+    for (std::size_t written{ 0 }; written < file.size();)
+    {
+        const ssize_t result{ ::write(fd, file.data() + written, file.size() - written) };
+        if (result < 0 && errno == EINTR)
+            continue;
+        if (result < 0)
+        {
+            const int writeError{ errno };
+            ::close(fd);
+            ::unlink(temporary.c_str());
+            errno = writeError;
+            return false;
+        }
+        written += static_cast<std::size_t>(result);
+    }
+    if (::close(fd) != 0 || std::rename(temporary.c_str(), path) != 0)
+    {
+        const int saveError{ errno };
+        ::unlink(temporary.c_str());
+        errno = saveError;
+        return false;
+    }
+    return true;
+}
+
+#endif
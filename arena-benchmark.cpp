@@ -0,0 +1,133 @@
+//** Benchmark: MonotonicArena vs the default allocator **//
+
+// Build and run:
+//     g++ -std=c++20 -O2 -pthread arena-benchmark.cpp -o arena-benchmark
+//     ./arena-benchmark [records per batch, default 1000000] [batches, default 10] [threads, default all cores]
+
+// Each batch creates many short-lived records and throws them all away, in three shapes:
+    // single:     one new Record per record, deleted at the end of the batch
+    // containers: a small vector of doubles per record (std::vector vs std::pmr::vector)
+    // threaded:   "single" on every thread at once (the default allocator vs threadArena())
+
+#include <algorithm>
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <memory_resource>
+#include <thread>
+#include <vector>
+
+#include "arena.h"
+
+struct Record
+{
+    int id{ };
+    double value{ };
+};
+
+volatile double benchmarkSink{ };
+
+template <typename Run>
+double timeIt(Run&& run)
+{
+    const auto start{ std::chrono::steady_clock::now() };
+    run();
+    const std::chrono::duration<double> elapsed{ std::chrono::steady_clock::now() - start };
+    return elapsed.count();
+}
+
+void singleWithNew(std::size_t records, int batches)
+{
+    std::vector<Record*> live(records);
+    for (int batch{ 0 }; batch < batches; ++batch)
+    {
+        for (std::size_t i{ 0 }; i < records; ++i)
+            live[i] = new Record{ static_cast<int>(i), i * 0.5 };
+        double total{ 0 };
+        for (const Record* record : live)
+            total += record->value;
+        benchmarkSink = total;
+        for (const Record* record : live)
+            delete record;
+    }
+}
+
+void singleWithArena(std::size_t records, int batches, MonotonicArena& arena)
+{
+    std::vector<Record*> live(records);
+    for (int batch{ 0 }; batch < batches; ++batch)
+    {
+        for (std::size_t i{ 0 }; i < records; ++i)
+            live[i] = ::new (arena.allocate(sizeof(Record), alignof(Record))) Record{ static_cast<int>(i), i * 0.5 };
+        double total{ 0 };
+        for (const Record* record : live)
+            total += record->value;
+        benchmarkSink = total;
+        arena.reset(); // Record is trivially destructible, so there is nothing else to clean up
+    }
+}
+
+void containersWithNew(std::size_t records, int batches)
+{
+    for (int batch{ 0 }; batch < batches; ++batch)
+    {
+        std::vector<std::vector<double>> rows{ };
+        rows.reserve(records);
+        for (std::size_t i{ 0 }; i < records; ++i)
+            rows.emplace_back(4, i * 0.5);
+        benchmarkSink = rows[records / 2][1];
+    }
+}
+
+void containersWithArena(std::size_t records, int batches, MonotonicArena& arena)
+{
+    for (int batch{ 0 }; batch < batches; ++batch)
+    {
+        {
+            std::pmr::vector<std::pmr::vector<double>> rows{ &arena };
+            rows.reserve(records);
+            for (std::size_t i{ 0 }; i < records; ++i)
+                rows.emplace_back(4, i * 0.5);
+            benchmarkSink = rows[records / 2][1];
+        }
+        arena.reset();
+    }
+}
+
+template <typename Work>
+double onThreads(unsigned threads, Work&& work)
+{
+    return timeIt([&] {
+        std::vector<std::thread> workers{ };
+        for (unsigned i{ 0 }; i < threads; ++i)
+            workers.emplace_back(work);
+        for (std::thread& worker : workers)
+            worker.join();
+    });
+}
+
+int main(int argc, char* argv[])
+{
+    const std::size_t records{ argc > 1 ? std::strtoull(argv[1], nullptr, 10) : 1'000'000 };
+    const int batches{ argc > 2 ? std::atoi(argv[2]) : 10 };
+    const unsigned threads{ argc > 3 ? static_cast<unsigned>(std::atoi(argv[3]))
+                                     : std::max(1u, std::thread::hardware_concurrency()) };
+
+    MonotonicArena arena{ };
+    const double operations{ static_cast<double>(records) * batches };
+
+    auto report{ [&](const char* name, double defaultSeconds, double arenaSeconds, double scale) {
+        std::printf("%-11s default %8.2f ns/record   arena %8.2f ns/record   %5.2fx\n", name,
+                    defaultSeconds * 1e9 / (operations * scale), arenaSeconds * 1e9 / (operations * scale),
+                    defaultSeconds / arenaSeconds);
+    } };
+
+    std::printf("%zu records x %d batches, %u threads\n", records, batches, threads);
+    report("single", timeIt([&] { singleWithNew(records, batches); }),
+           timeIt([&] { singleWithArena(records, batches, arena); }), 1);
+    report("containers", timeIt([&] { containersWithNew(records, batches); }),
+           timeIt([&] { containersWithArena(records, batches, arena); }), 1);
+    report("threaded", onThreads(threads, [&] { singleWithNew(records, batches); }),
+           onThreads(threads, [&] { singleWithArena(records, batches, threadArena()); }), threads);
+    return 0;
+}
@@ -0,0 +1,160 @@
+#ifndef ARENA_H
+#define ARENA_H
+
+//** An arena allocator for batches of short-lived objects **//
+
+// obj-var.cpp explains that a variable is "instantiated" at runtime: it is created and given a memory address.
+// For objects created with new, finding that address is the job of the general-purpose allocator, which has to
+// handle objects of any size that are freed in any order. When a program creates millions of small records for one
+// batch of work and throws them all away together, that generality is wasted effort.
+
+// MonotonicArena hands out memory by bumping a pointer through large blocks. Freeing a single object does nothing;
+// instead, reset() makes the whole arena available again at once. The blocks are kept, so after the first batch a
+// program using reset() between batches doesn't call the general-purpose allocator at all.
+
+// MonotonicArena is a std::pmr::memory_resource, so standard containers can use it directly:
+
+//     MonotonicArena arena{ };
+//     for (const Batch& batch : batches)
+//     {
+//         std::pmr::vector<double> values{ &arena };
+//         ...                    // everything values allocates comes from the arena
+//         arena.reset();         // after values is gone: the whole batch's memory is reusable
+//     }
+
+// An arena is not thread-safe. For multi-threaded programs, threadArena() gives each thread its own arena, so
+// threads never contend on it. Memory from a thread's arena must only be used on that thread until its reset().
+
+// Unlike std::pmr::monotonic_buffer_resource, whose release() gives its memory back to the upstream allocator,
+// reset() keeps every block for the next batch.
+
+#include <algorithm>
+#include <cstddef>
+#include <cstdint>
+#include <memory_resource>
+#include <new>
+#include <vector>
+
+class MonotonicArena : public std::pmr::memory_resource
+{
+public:
+    static constexpr std::size_t defaultBlockSize{ 1 << 16 };
+
+    explicit MonotonicArena(std::size_t blockSize = defaultBlockSize,
+                            std::pmr::memory_resource* upstream = std::pmr::new_delete_resource())
+        : m_blockSize{ std::max<std::size_t>(blockSize, 256) }
+        , m_upstream{ upstream }
+    {
+    }
+
+    MonotonicArena(const MonotonicArena&) = delete;
+    MonotonicArena& operator=(const MonotonicArena&) = delete;
+
+    ~MonotonicArena() override { release(); }
+
+    // Make all memory handed out so far available again. Every object allocated from the arena must be gone.
+    void reset()
+    {
+        m_current = 0;
+        m_position = m_blocks.empty() ? nullptr : m_blocks.front().data;
+        m_end = m_blocks.empty() ? nullptr : m_blocks.front().data + m_blocks.front().size;
+        m_allocated = 0;
+    }
+
+    // Like reset(), but also return the blocks to the upstream allocator.
+    void release()
+    {
+        for (const Block& block : m_blocks)
+            m_upstream->deallocate(block.data, block.size, alignof(std::max_align_t));
+        m_blocks.clear();
+        reset();
+    }
+
+    std::size_t bytesAllocated() const { return m_allocated; } // handed out since the last reset
+    std::size_t bytesReserved() const                          // held in blocks
+    {
+        std::size_t total{ 0 };
+        for (const Block& block : m_blocks)
+            total += block.size;
+        return total;
+    }
+
+private:
+    struct Block
+    {
+        std::byte* data{ };
+        std::size_t size{ };
+    };
+
+    void* do_allocate(std::size_t bytes, std::size_t alignment) override
+    {
+        for (;;)
+        {
+            if (m_position)
+            {
+                const std::uintptr_t address{ reinterpret_cast<std::uintptr_t>(m_position) };
+                const std::uintptr_t aligned{ (address + alignment - 1) & ~(static_cast<std::uintptr_t>(alignment) - 1) };
+                std::byte* start{ m_position + (aligned - address) };
+                if (start <= m_end && static_cast<std::size_t>(m_end - start) >= bytes)
+                {
+                    m_position = start + bytes;
+                    m_allocated += bytes;
+                    return start;
+                }
+            }
+            nextBlock(bytes + alignment);
+        }
+    }
+
+    void do_deallocate(void*, std::size_t, std::size_t) override
+    {
+        // Nothing to do: memory comes back all at once with reset().
+    }
+
+    bool do_is_equal(const std::pmr::memory_resource& other) const noexcept override
+    {
+        return this == &other;
+    }
+
+    // Move on to the next kept block that is big enough, or get a new one from upstream.
+    void nextBlock(std::size_t minimumSize)
+    {
+        while (m_current + 1 < m_blocks.size())
+        {
+            ++m_current;
+            const Block& block{ m_blocks[m_current] };
+            if (block.size >= minimumSize)
+            {
+                m_position = block.data;
+                m_end = block.data + block.size;
+                return;
+            }
+        }
+
+        // Each new block is twice the size of the last, so a big batch needs only a few of them.
+        const std::size_t lastSize{ m_blocks.empty() ? m_blockSize : m_blocks.back().size * 2 };
+        const std::size_t size{ std::max(lastSize, minimumSize) };
+        Block block{ static_cast<std::byte*>(m_upstream->allocate(size, alignof(std::max_align_t))), size };
+        m_blocks.push_back(block);
+        m_current = m_blocks.size() - 1;
+        m_position = block.data;
+        m_end = block.data + block.size;
+    }
+
+    std::size_t m_blockSize{ };
+    std::pmr::memory_resource* m_upstream{ };
+    std::vector<Block> m_blocks{ };
+    std::size_t m_current{ 0 };      // index of the block being carved up
+    std::byte* m_position{ nullptr }; // next free byte in it
+    std::byte* m_end{ nullptr };
+    std::size_t m_allocated{ 0 };
+};
+
+// This thread's own arena, created on first use and destroyed when the thread exits.
+inline MonotonicArena& threadArena()
+{
+    thread_local MonotonicArena arena{ };
+    return arena;
+}
+
+#endif
@@ -0,0 +1,135 @@
+//** Benchmark: memset vs streaming stores vs streaming on several threads **//
+
+// Build and run:
+//     g++ -std=c++20 -O2 -pthread bulk-zero-benchmark.cpp -o bulk-zero-benchmark
+//     ./bulk-zero-benchmark [largest size in MB, default 512] [repetitions, default 5]
+
+// For buffer sizes from 64 KB up to the largest, this zeroes an already-faulted-in buffer with memset, with each
+// streaming kernel the CPU supports on one thread, and with the best one on every thread. Each is reported in GB/s,
+// together with how long it then takes to read a 1 MB working set that was in the cache before the fill: memset
+// pushes it out, streaming doesn't. The last lines are the crossover points, the smallest sizes at which streaming
+// beat memset and several threads beat one, which are what BulkZeroOptions' thresholds should be set to on this
+// machine.
+
+#include <algorithm>
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <vector>
+
+#include "bulk-zero.h"
+
+volatile long benchmarkSink{ };
+
+template <typename Run>
+double bestOf(int repetitions, Run&& run)
+{
+    double best{ 1e30 };
+    for (int i{ 0 }; i < repetitions; ++i)
+    {
+        const auto start{ std::chrono::steady_clock::now() };
+        run();
+        const std::chrono::duration<double> elapsed{ std::chrono::steady_clock::now() - start };
+        best = std::min(best, elapsed.count());
+    }
+    return best;
+}
+
+double seconds(std::chrono::steady_clock::time_point start)
+{
+    const std::chrono::duration<double> elapsed{ std::chrono::steady_clock::now() - start };
+    return elapsed.count();
+}
+
+long readAll(const std::vector<long>& values)
+{
+    long sum{ 0 };
+    for (const long value : values)
+        sum += value;
+    return sum;
+}
+
+struct Method
+{
+    const char* name{ };
+    BulkZeroOptions options{ };
+    double crossover{ 0 }; // the smallest size, in bytes, at which this beat what it's compared with
+};
+
+int main(int argc, char* argv[])
+{
+    const double largestMegabytes{ argc > 1 ? std::atof(argv[1]) : 512 };
+    const int repetitions{ argc > 2 ? std::atoi(argv[2]) : 5 };
+    const std::size_t largest{ static_cast<std::size_t>(largestMegabytes * (1 << 20)) };
+
+    ThreadPool pool{ };
+    constexpr std::size_t always{ 1 };
+    constexpr std::size_t never{ ~std::size_t{ 0 } };
+
+    std::vector<Method> methods{ };
+    methods.push_back({ "memset", BulkZeroOptions{ .kernel = ZeroKernel::memset } });
+    __builtin_cpu_init();
+    methods.push_back({ "sse2", BulkZeroOptions{ always, never, nullptr, ZeroKernel::sse2 } });
+    if (__builtin_cpu_supports("avx2"))
+        methods.push_back({ "avx2", BulkZeroOptions{ always, never, nullptr, ZeroKernel::avx2 } });
+    if (__builtin_cpu_supports("avx512f"))
+        methods.push_back({ "avx512", BulkZeroOptions{ always, never, nullptr, ZeroKernel::avx512 } });
+    methods.push_back({ "threaded", BulkZeroOptions{ always, always, &pool, ZeroKernel::best } });
+
+    std::vector<char> buffer(largest);
+    std::memset(buffer.data(), 1, buffer.size()); // fault every page in, so the fills measure only the stores
+    std::vector<long> hotSet((1 << 20) / sizeof(long), 1);
+
+    std::printf("%zu threads; each cell is fill GB/s / ms to read a 1 MB hot set afterwards\n", pool.threadCount());
+    std::printf("%10s", "size");
+    for (const Method& method : methods)
+        std::printf(" %18s", method.name);
+    std::printf("\n");
+
+    for (std::size_t size{ std::size_t{ 64 } << 10 }; size <= largest; size *= 2)
+    {
+        // Small fills are repeated so that each timing is long enough to be meaningful.
+        const std::size_t rounds{ std::max<std::size_t>(1, (std::size_t{ 64 } << 20) / size) };
+        std::printf("%8zuKB", size >> 10);
+        double memsetTime{ 0 };
+        double fastestSingle{ 1e30 };
+        for (std::size_t m{ 0 }; m < methods.size(); ++m)
+        {
+            Method& method{ methods[m] };
+            double reread{ 1e30 };
+            const double fill{ bestOf(repetitions, [&] {
+                benchmarkSink = readAll(hotSet);
+                for (std::size_t round{ 0 }; round < rounds; ++round)
+                    bulkZero(buffer.data(), size, method.options);
+                const auto start{ std::chrono::steady_clock::now() };
+                benchmarkSink = readAll(hotSet);
+                reread = std::min(reread, seconds(start));
+            }) };
+            const double time{ fill - reread };
+            std::printf(" %9.1f / %6.3f", size * rounds / time / 1e9, reread * 1e3);
+
+            // Streaming kernels are compared with memset, the threaded fill with the fastest single thread.
+            const bool threaded{ m == methods.size() - 1 };
+            if (m == 0)
+                memsetTime = time;
+            else if (method.crossover == 0 && time < (threaded ? fastestSingle : memsetTime))
+                method.crossover = static_cast<double>(size);
+            if (!threaded)
+                fastestSingle = std::min(fastestSingle, time);
+        }
+        std::printf("\n");
+    }
+
+    for (std::size_t m{ 1 }; m < methods.size(); ++m)
+    {
+        const Method& method{ methods[m] };
+        const char* against{ m == methods.size() - 1 ? "one thread" : "memset" };
+        if (method.crossover != 0)
+            std::printf("%s beat %s from %.0f KB\n", method.name, against, method.crossover / 1024);
+        else
+            std::printf("%s never beat %s\n", method.name, against);
+    }
+
+    return 0;
+}
@@ -0,0 +1,219 @@
+#ifndef BULK_ZERO_H
+#define BULK_ZERO_H
+
+//** Zero-filling big buffers **//
+
+// assignment-initilization.cpp recommends int width{ }; value initialization sets it to zero. Doing the same to a
+// buffer of hundreds of megabytes (std::vector<int>(n), or memset) writes every byte through the cache: each cache
+// line is first read from memory, then zeroed, and later written back, pushing everything useful out of the cache
+// on the way. Most of that buffer won't be read again before it leaves the cache anyway.
+
+// bulkZero() uses streaming (non-temporal) stores for big buffers instead. They go straight to memory in whole
+// cache lines, without reading them first and without evicting anything. Above a second threshold the buffer is
+// also split into chunks zeroed on several threads, because one core can't use all the memory bandwidth. Small
+// buffers just use memset, which is faster when the data fits in the cache and will be used soon:
+
+//     bulkZero(buffer, bytes);                         // memset, streaming, or streaming on several threads
+//     bulkValueInitialize(values, count);              // the same for an array of int, double, plain structs...
+
+// The streaming kernels use the widest stores the running CPU has (AVX-512, AVX2, or SSE2, which every x86-64 CPU
+// has), picked the first time they're needed. Other CPUs always use memset. Where the thresholds should be depends
+// on the machine; bulk-zero-benchmark.cpp finds the crossover points, and BulkZeroOptions overrides the defaults.
+// Unless given a ThreadPool of their own, all callers share one; a big buffer zeroed while another thread is using
+// it is zeroed on the calling thread alone, rather than waiting for the pool (whose cores are busy anyway).
+
+// None of this helps memory that comes straight from the operating system, which is zero already: std::vector<int>(n)
+// for a big n gets fresh pages that the kernel zeroes as they're first touched, and zeroing them again first would
+// only add a pass. bulkZero() is for buffers that are reused.
+
+#include <algorithm>
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <functional>
+#include <thread>
+#include <type_traits>
+#include <unistd.h>
+
+#include "thread-pool.h"
+
+#if defined(__x86_64__) || defined(_M_X64)
+#define BULK_ZERO_X86 1
+#include <immintrin.h>
+#endif
+
+enum class ZeroKernel
+{
+    best,
+    memset,
+    sse2,
+    avx2,
+    avx512,
+};
+
+struct BulkZeroOptions
+{
+    std::size_t streamingThreshold{ 0 }; // bytes; smaller buffers use memset. 0 means the default for this machine
+    std::size_t parallelThreshold{ 0 };  // bytes; bigger buffers are split across threads. 0 means the default
+    ThreadPool* pool{ nullptr };         // threads for big buffers; nullptr means a pool shared by all callers
+    ZeroKernel kernel{ ZeroKernel::best };
+};
+
+namespace bulkZeroDetail
+{
+    constexpr std::size_t cacheLine{ 64 };
+
+    // Streaming only pays off for a buffer that doesn't fit in the last-level cache: a smaller one could have stayed
+    // there, ready for whatever reads it next. Each core's share of the cache is what counts.
+    inline std::size_t defaultStreamingThreshold()
+    {
+        static const std::size_t threshold{ [] {
+            const long cacheSize{ ::sysconf(_SC_LEVEL3_CACHE_SIZE) };
+            const std::size_t cores{ std::max(1u, std::thread::hardware_concurrency()) };
+            const std::size_t perCore{ cacheSize > 0 ? static_cast<std::size_t>(cacheSize) / cores : 0 };
+            return std::clamp<std::size_t>(perCore, std::size_t{ 1 } << 20, std::size_t{ 32 } << 20);
+        }() };
+        return threshold;
+    }
+
+    // Below this, starting threads costs more than a single core loses to the memory bandwidth it can't use.
+    constexpr std::size_t defaultParallelThreshold{ std::size_t{ 32 } << 20 };
+    constexpr std::size_t minimumChunk{ std::size_t{ 8 } << 20 };
+
+    inline ThreadPool& sharedPool()
+    {
+        static ThreadPool pool{ };
+        return pool;
+    }
+
+    using StreamFunction = void (*)(char* first, std::size_t size);
+
+#ifdef BULK_ZERO_X86
+    // first and size are multiples of the cache line size. The sfence makes the stores visible to other threads
+    // in order with this thread's later ones, like ordinary stores.
+    inline void streamSse2(char* first, std::size_t size)
+    {
+        const __m128i zero{ _mm_setzero_si128() };
+        for (char* const last{ first + size }; first != last; first += cacheLine)
+        {
+            _mm_stream_si128(reinterpret_cast<__m128i*>(first), zero);
+            _mm_stream_si128(reinterpret_cast<__m128i*>(first + 16), zero);
+            _mm_stream_si128(reinterpret_cast<__m128i*>(first + 32), zero);
+            _mm_stream_si128(reinterpret_cast<__m128i*>(first + 48), zero);
+        }
+        _mm_sfence();
+    }
+
+    [[gnu::target("avx2")]] inline void streamAvx2(char* first, std::size_t size)
+    {
+        const __m256i zero{ _mm256_setzero_si256() };
+        for (char* const last{ first + size }; first != last; first += cacheLine)
+        {
+            _mm256_stream_si256(reinterpret_cast<__m256i*>(first), zero);
+            _mm256_stream_si256(reinterpret_cast<__m256i*>(first + 32), zero);
+        }
+        _mm_sfence();
+    }
+
+    [[gnu::target("avx512f")]] inline void streamAvx512(char* first, std::size_t size)
+    {
+        const __m512i zero{ _mm512_setzero_si512() };
+        for (char* const last{ first + size }; first != last; first += cacheLine)
+            _mm512_stream_si512(reinterpret_cast<__m512i*>(first), zero);
+        _mm_sfence();
+    }
+#endif
+
+    inline StreamFunction streamFunction(ZeroKernel kernel)
+    {
+#ifdef BULK_ZERO_X86
+        if (kernel == ZeroKernel::best)
+        {
+            static const ZeroKernel best{ [] {
+                __builtin_cpu_init();
+                if (__builtin_cpu_supports("avx512f"))
+                    return ZeroKernel::avx512;
+                if (__builtin_cpu_supports("avx2"))
+                    return ZeroKernel::avx2;
+                return ZeroKernel::sse2;
+            }() };
+            kernel = best;
+        }
+        switch (kernel)
+        {
+        case ZeroKernel::sse2: return streamSse2;
+        case ZeroKernel::avx2: return streamAvx2;
+        case ZeroKernel::avx512: return streamAvx512;
+        default: break;
+        }
+#endif
+        return nullptr;
+    }
+
+    // memset the unaligned ends, stream the cache lines in between.
+    inline void streamZero(char* first, std::size_t size, StreamFunction stream)
+    {
+        const std::uintptr_t address{ reinterpret_cast<std::uintptr_t>(first) };
+        const std::size_t head{ std::min(size, (cacheLine - address % cacheLine) % cacheLine) };
+        std::memset(first, 0, head);
+        first += head;
+        size -= head;
+        const std::size_t body{ size - size % cacheLine };
+        stream(first, body);
+        std::memset(first + body, 0, size - body);
+    }
+}
+
+// Set size bytes at data to zero, in whichever of the ways above is fastest for that size.
+inline void bulkZero(void* data, std::size_t size, const BulkZeroOptions& options = { })
+{
+    using namespace bulkZeroDetail;
+
+    char* const bytes{ static_cast<char*>(data) };
+    const std::size_t streamingThreshold{ options.streamingThreshold ? options.streamingThreshold
+                                                                     : defaultStreamingThreshold() };
+    const StreamFunction stream{ options.kernel == ZeroKernel::memset ? nullptr : streamFunction(options.kernel) };
+    if (!stream || size < streamingThreshold)
+    {
+        std::memset(bytes, 0, size);
+        return;
+    }
+
+    const std::size_t parallelThreshold{ options.parallelThreshold ? options.parallelThreshold
+                                                                   : defaultParallelThreshold };
+    if (size < parallelThreshold || (!options.pool && std::thread::hardware_concurrency() <= 1))
+    {
+        streamZero(bytes, size, stream);
+        return;
+    }
+    ThreadPool& pool{ options.pool ? *options.pool : sharedPool() };
+
+    // Chunks of whole cache lines, a few per thread so a thread that's slowed down doesn't hold up the rest.
+    const std::size_t chunkCount{ std::clamp<std::size_t>(size / minimumChunk, 1, 4 * pool.threadCount()) };
+    std::size_t chunkSize{ (size + chunkCount - 1) / chunkCount };
+    chunkSize += (cacheLine - chunkSize % cacheLine) % cacheLine;
+    const std::function<void(std::size_t)> zeroChunk{ [&](std::size_t chunk) {
+        const std::size_t offset{ chunk * chunkSize };
+        streamZero(bytes + offset, std::min(chunkSize, size - offset), stream);
+    } };
+    if (options.pool)
+        pool.run((size + chunkSize - 1) / chunkSize, zeroChunk);
+    else if (!pool.tryRun((size + chunkSize - 1) / chunkSize, zeroChunk))
+        streamZero(bytes, size, stream); // another thread is zeroing with the shared pool: its cores are busy anyway
+}
+
+// Whether value-initializing a T is the same as setting all its bytes to zero. (Pointers to members are the
+// exception among trivial types: a null one isn't all zero bytes.)
+template <typename T>
+constexpr bool isZeroInitializable{ std::is_trivially_default_constructible_v<T> && std::is_trivially_copyable_v<T>
+                                    && !std::is_member_pointer_v<T> };
+
+// Value-initialize count Ts at first, like T{ } for each but with bulkZero().
+template <typename T>
+void bulkValueInitialize(T* first, std::size_t count, const BulkZeroOptions& options = { })
+{
+    static_assert(isZeroInitializable<T>, "bulkValueInitialize is for types whose zero value is all zero bytes");
+    bulkZero(first, count * sizeof(T), options);
+}
+
+#endif
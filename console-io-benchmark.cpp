@@ -0,0 +1,303 @@
+//** Benchmark: console input and output **//
+
+// iostream.cpp says '\n' "preforms better" than std::endl, and uninitialized-undefined.cpp says initializing
+// 100,000 values you are about to overwrite "would be slow". This program measures those claims (and the usual
+// fixes for slow console I/O) so the numbers can be compared from one release to the next.
+
+// Build and run:
+//     g++ -std=c++20 -O2 console-io-benchmark.cpp -o console-io-benchmark
+//     ./console-io-benchmark --sizes 1000,100000,1000000 --repetitions 20 --warmup 3 > results.json
+
+// Options:
+//     --sizes a,b,c        number of lines / values per run, each at least 1 (default 100000)
+//     --repetitions n      timed runs per variant and size (default 10)
+//     --warmup n           untimed runs before those (default 2)
+//     --output path        where the printed text goes (default /dev/null)
+//     --variants a,b,c     only run these variants (default all)
+
+// Each run happens in a freshly forked process, because std::ios::sync_with_stdio(false) and std::cin.tie() change
+// global state that can't be undone reliably. Results are written to standard output as JSON.
+
+#include <algorithm>
+#include <charconv>
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <fcntl.h>
+#include <iostream>
+#include <memory>
+#include <string>
+#include <string_view>
+#include <sys/wait.h>
+#include <unistd.h>
+#include <vector>
+
+#include "fast-input.h"
+#include "fast-output.h"
+
+struct Variant
+{
+    const char* name{ };
+    const char* description{ };
+    bool readsInput{ false };
+    void (*run)(int count){ };
+};
+
+// Keeps the compiler from optimizing away work whose result is otherwise unused.
+volatile int benchmarkSink{ };
+
+const Variant variants[]{
+    { "endl", "std::cout << ... << std::endl", false,
+      [](int count) {
+          for (int x{ 0 }; x < count; ++x)
+              std::cout << "x is equal to: " << x << std::endl;
+      } },
+    { "newline", "std::cout << ... << '\\n'", false,
+      [](int count) {
+          for (int x{ 0 }; x < count; ++x)
+              std::cout << "x is equal to: " << x << '\n';
+          std::cout.flush();
+      } },
+    { "unsynced", "std::ios::sync_with_stdio(false), then '\\n'", false,
+      [](int count) {
+          std::ios::sync_with_stdio(false);
+          for (int x{ 0 }; x < count; ++x)
+              std::cout << "x is equal to: " << x << '\n';
+          std::cout.flush();
+      } },
+    { "printf", "std::printf(\"x is equal to: %d\\n\")", false,
+      [](int count) {
+          for (int x{ 0 }; x < count; ++x)
+              std::printf("x is equal to: %d\n", x);
+          std::fflush(stdout);
+      } },
+    { "fastWriter", "FastWriter (fast-output.h), whenFull", false,
+      [](int count) {
+          FastWriter output{ STDOUT_FILENO, FlushPolicy::whenFull };
+          for (int x{ 0 }; x < count; ++x)
+              output << "x is equal to: " << x << '\n';
+      } },
+    { "cinTied", "std::cin >> x, echoed with std::cout (default: tied and synced)", true,
+      [](int count) {
+          int x{ };
+          for (int i{ 0 }; i < count && std::cin >> x; ++i)
+              std::cout << "You entered " << x << '\n';
+          std::cout.flush();
+      } },
+    { "cinUntied", "as cinTied, after sync_with_stdio(false) and std::cin.tie(nullptr)", true,
+      [](int count) {
+          std::ios::sync_with_stdio(false);
+          std::cin.tie(nullptr);
+          int x{ };
+          for (int i{ 0 }; i < count && std::cin >> x; ++i)
+              std::cout << "You entered " << x << '\n';
+          std::cout.flush();
+      } },
+    { "fastReader", "as cinTied, with FastReader and FastWriter", true,
+      [](int count) {
+          FastReader input{ };
+          FastWriter output{ STDOUT_FILENO, FlushPolicy::whenFull };
+          int x{ };
+          for (int i{ 0 }; i < count && input >> x; ++i)
+              output << "You entered " << x << '\n';
+      } },
+    { "valueInit", "new int[count]() and then overwrite every value", false,
+      [](int count) {
+          std::unique_ptr<int[]> values{ new int[static_cast<std::size_t>(count)]() };
+          for (int i{ 0 }; i < count; ++i)
+              values[static_cast<std::size_t>(i)] = i;
+          benchmarkSink = values[static_cast<std::size_t>(count / 2)];
+      } },
+    { "defaultInit", "new int[count] (uninitialized) and then overwrite every value", false,
+      [](int count) {
+          std::unique_ptr<int[]> values{ new int[static_cast<std::size_t>(count)] };
+          for (int i{ 0 }; i < count; ++i)
+              values[static_cast<std::size_t>(i)] = i;
+          benchmarkSink = values[static_cast<std::size_t>(count / 2)];
+      } },
+};
+
+struct Options
+{
+    std::vector<int> sizes{ 100000 };
+    int repetitions{ 10 };
+    int warmup{ 2 };
+    std::string output{ "/dev/null" };
+    std::vector<std::string> only{ };
+};
+
+std::vector<std::string> splitList(std::string_view list)
+{
+    std::vector<std::string> items{ };
+    while (!list.empty())
+    {
+        const std::size_t comma{ list.find(',') };
+        items.emplace_back(list.substr(0, comma));
+        list = (comma == std::string_view::npos) ? std::string_view{ } : list.substr(comma + 1);
+    }
+    return items;
+}
+
+bool parseOptions(int argc, char* argv[], Options& options)
+{
+    for (int i{ 1 }; i + 1 < argc; i += 2)
+    {
+        const std::string_view name{ argv[i] };
+        const char* value{ argv[i + 1] };
+        if (name == "--sizes")
+        {
+            options.sizes.clear();
+            for (const std::string& item : splitList(value))
+            {
+                int size{ };
+                const std::from_chars_result result{ std::from_chars(item.data(), item.data() + item.size(), size) };
+                if (result.ec != std::errc{ } || result.ptr != item.data() + item.size() || size < 1)
+                    return false; // the variants index into an array of size values
+                options.sizes.push_back(size);
+            }
+            if (options.sizes.empty())
+                return false;
+        }
+        else if (name == "--repetitions")
+            options.repetitions = std::max(1, std::atoi(value));
+        else if (name == "--warmup")
+            options.warmup = std::max(0, std::atoi(value));
+        else if (name == "--output")
+            options.output = value;
+        else if (name == "--variants")
+            options.only = splitList(value);
+        else
+            return false;
+    }
+    return argc % 2 == 1;
+}
+
+// Write count numbers, one per line, to a temporary file for the input variants to read. Returns its descriptor.
+int makeInputFile(int count)
+{
+    std::FILE* file{ std::tmpfile() };
+    for (int x{ 0 }; x < count; ++x)
+        std::fprintf(file, "%d\n", x * 37 - 5000);
+    std::fflush(file);
+    const int fd{ ::dup(fileno(file)) }; // the temporary file lives on as long as a descriptor refers to it
+    std::fclose(file);
+    return fd;
+}
+
+// Run one variant once in a child process and return the elapsed time in nanoseconds (or a negative number).
+double runOnce(const Variant& variant, int count, const Options& options, int inputFd)
+{
+    int results[2]{ };
+    if (::pipe(results) != 0)
+        return -1;
+
+    const pid_t child{ ::fork() };
+    if (child == 0)
+    {
+        ::close(results[0]);
+        const int outputFd{ ::open(options.output.c_str(), O_WRONLY | O_CREAT | O_TRUNC, 0644) };
+        if (outputFd < 0 || ::dup2(outputFd, STDOUT_FILENO) < 0)
+            std::_Exit(1); // without writing a time, so the run counts as failed instead of printing over the report
+        if (variant.readsInput)
+        {
+            ::lseek(inputFd, 0, SEEK_SET);
+            ::dup2(inputFd, STDIN_FILENO);
+        }
+
+        const auto start{ std::chrono::steady_clock::now() };
+        variant.run(count);
+        const auto stop{ std::chrono::steady_clock::now() };
+
+        const double nanoseconds{ std::chrono::duration<double, std::nano>{ stop - start }.count() };
+        [[maybe_unused]] const ssize_t written{ ::write(results[1], &nanoseconds, sizeof(nanoseconds)) };
+        std::_Exit(0); // skip static destructors and stdio flushing: the timed work already flushed
+    }
+
+    ::close(results[1]);
+    double nanoseconds{ -1 };
+    if (::read(results[0], &nanoseconds, sizeof(nanoseconds)) != sizeof(nanoseconds))
+        nanoseconds = -1;
+    ::close(results[0]);
+    ::waitpid(child, nullptr, 0);
+    return nanoseconds;
+}
+
+std::string jsonEscape(std::string_view text)
+{
+    std::string escaped{ };
+    for (const char c : text)
+    {
+        if (c == '"' || c == '\\')
+            escaped += '\\';
+        escaped += c;
+    }
+    return escaped;
+}
+
+// Nearest-rank percentile of sorted samples.
+double percentile(const std::vector<double>& sorted, double p)
+{
+    const std::size_t rank{ static_cast<std::size_t>(p / 100.0 * static_cast<double>(sorted.size()) + 0.999999) };
+    return sorted[std::clamp<std::size_t>(rank, 1, sorted.size()) - 1];
+}
+
+int main(int argc, char* argv[])
+{
+    Options options{ };
+    if (!parseOptions(argc, argv, options))
+    {
+        std::fprintf(stderr, "usage: %s [--sizes a,b,c] [--repetitions n] [--warmup n] [--output path] "
+                             "[--variants a,b,c]\n", argv[0]);
+        return 1;
+    }
+
+    std::printf("{\n  \"benchmark\": \"console-io\",\n  \"repetitions\": %d,\n  \"warmup\": %d,\n  \"results\": [",
+                options.repetitions, options.warmup);
+    std::fflush(stdout); // so the forked children don't inherit (and repeat) buffered output
+
+    bool first{ true };
+    for (const int count : options.sizes)
+    {
+        const int inputFd{ makeInputFile(count) };
+        for (const Variant& variant : variants)
+        {
+            if (!options.only.empty() && std::find(options.only.begin(), options.only.end(), variant.name) == options.only.end())
+                continue;
+
+            for (int i{ 0 }; i < options.warmup; ++i)
+                runOnce(variant, count, options, inputFd);
+
+            std::vector<double> samples{ };
+            for (int i{ 0 }; i < options.repetitions; ++i)
+            {
+                const double nanoseconds{ runOnce(variant, count, options, inputFd) };
+                if (nanoseconds >= 0)
+                    samples.push_back(nanoseconds);
+            }
+            if (samples.empty())
+            {
+                std::fprintf(stderr, "%s: every run failed\n", variant.name);
+                continue;
+            }
+            std::sort(samples.begin(), samples.end());
+
+            double total{ 0 };
+            for (const double sample : samples)
+                total += sample;
+            const double mean{ total / static_cast<double>(samples.size()) };
+
+            std::printf("%s\n    { \"variant\": \"%s\", \"description\": \"%s\", \"count\": %d, \"runs\": %zu, "
+                        "\"ns\": { \"min\": %.0f, \"p50\": %.0f, \"p90\": %.0f, \"p99\": %.0f, \"max\": %.0f, "
+                        "\"mean\": %.0f }, \"nsPerItem\": %.3f }",
+                        first ? "" : ",", variant.name, jsonEscape(variant.description).c_str(), count, samples.size(), samples.front(),
+                        percentile(samples, 50), percentile(samples, 90), percentile(samples, 99), samples.back(),
+                        mean, percentile(samples, 50) / std::max(count, 1));
+            std::fflush(stdout);
+            first = false;
+        }
+        ::close(inputFd);
+    }
+    std::printf("\n  ]\n}\n");
+    return 0;
+}
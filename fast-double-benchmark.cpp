@@ -0,0 +1,365 @@
+//** Benchmark: parsing and printing doubles **//
+
+// Build and run:
+//     g++ -std=c++20 -O2 fast-double-benchmark.cpp -o fast-double-benchmark
+//     ./fast-double-benchmark [millions of numbers, default 5] [repetitions, default 3]
+
+// The input is one number per line, half of them telemetry-like (a few hundred to a few thousand, with 0 to 4
+// decimals, like 1523.25) and half random doubles over a wide range of exponents at full precision (shortest
+// round-trip form, like 3.0517578125e-05 or 8.329150286384946e+123). Each parser reads all of them:
+    // strtod           the C library, which std::cin >> width ends up calling
+    // istringstream    while (input >> width), the loop std::cin runs
+    // from_chars       std::from_chars on each number
+    // parseDouble      fast-double.h
+    // FastReader       reader >> width, from a file (in the page cache) rather than memory
+// Before timing, every parser's results are checked bit for bit against strtod's, and parseDouble is checked on a
+// sweep of random bit patterns (printed with %.17g, %.<random>e and in shortest form) and on known hard cases:
+// subnormals, numbers halfway between two doubles, the largest double, and integers just past 2^53. FastReader is
+// checked against std::istringstream on inputs that make std::cin fail.
+
+// For output, every number is printed with std::ostringstream at precision 17 (the fewest digits that always read
+// back the same) and with FastWriter's std::to_chars (the shortest form that reads back the same); both must
+// read back to the same doubles.
+
+#include <algorithm>
+#include <charconv>
+#include <chrono>
+#include <cmath>
+#include <cstdint>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <fcntl.h>
+#include <iomanip>
+#include <limits>
+#include <random>
+#include <sstream>
+#include <string>
+#include <system_error>
+#include <unistd.h>
+#include <vector>
+
+#include "fast-double.h"
+#include "fast-input.h"
+#include "fast-output.h"
+
+volatile double benchmarkSink{ };
+
+template <typename Run>
+double bestOf(int repetitions, Run&& run)
+{
+    double best{ 1e30 };
+    for (int i{ 0 }; i < repetitions; ++i)
+    {
+        const auto start{ std::chrono::steady_clock::now() };
+        run();
+        const std::chrono::duration<double> elapsed{ std::chrono::steady_clock::now() - start };
+        best = std::min(best, elapsed.count());
+    }
+    return best;
+}
+
+bool sameBits(double a, double b) { return std::memcmp(&a, &b, sizeof(double)) == 0; }
+
+// parseDouble must agree with strtod on the whole of text, value and length both.
+bool checkAgainstStrtod(const char* text)
+{
+    char* strtodEnd{ };
+    const double expected{ std::strtod(text, &strtodEnd) };
+    double value{ };
+    const char* const last{ text + std::strlen(text) };
+    const std::from_chars_result result{ parseDouble(text, last, value) };
+    if (!sameBits(value, expected) || result.ptr != strtodEnd)
+    {
+        std::printf("MISMATCH: parseDouble(\"%s\") gave %.17g, strtod gave %.17g\n", text, value, expected);
+        return false;
+    }
+    return true;
+}
+
+bool checkHardCases()
+{
+    const char* const cases[]{
+        "0", "-0", "1", "0.1", "0.3", "1e23", "8.98846567431158e307", "1.7976931348623157e308",
+        "1.7976931348623158e308",        // rounds down to the largest double
+        "2.2250738585072011e-308",       // just below the smallest normal double
+        "2.2250738585072014e-308",       // the smallest normal double
+        "4.9406564584124654e-324",       // the smallest subnormal
+        "2.4703282292062328e-324",       // just over half of it: rounds up
+        "9007199254740993",              // 2^53 + 1, halfway between two doubles: rounds to even
+        "9007199254740995",              // 2^53 + 3: rounds up to even
+        "9007199254740993.0000000000000000000000001", // just past halfway: rounds up
+        "123456789012345678901234567890", "0.000000000000000000000000000000000000001",
+        "7.2057594037927933e16",
+        "4503599627370496.5",            // halfway at 2^52: rounds to even
+        "4503599627370497.5",
+        "1.00000000000000011102230246251565404236316680908203125", // exactly halfway between 1 and the next double
+        "1.00000000000000011102230246251565404236316680908203126",
+        "2.225073858507201136057409796709131975934819546351645648e-308",
+        "1e22", "1e-22", "123456789e-22", "9007199254740992e22", "1.5e-45", "3.4028235e38",
+    };
+    for (const char* text : cases)
+    {
+        if (!checkAgainstStrtod(text))
+            return false;
+    }
+    return true;
+}
+
+bool checkRandomBits(std::size_t count)
+{
+    std::mt19937_64 random{ 2024 };
+    char text[64]{ };
+    for (std::size_t i{ 0 }; i < count; ++i)
+    {
+        const std::uint64_t bits{ random() };
+        double value{ };
+        std::memcpy(&value, &bits, sizeof(double));
+        if (!std::isfinite(value))
+            continue;
+
+        std::snprintf(text, sizeof text, "%.17g", value);
+        if (!checkAgainstStrtod(text))
+            return false;
+        std::snprintf(text, sizeof text, "%.*e", static_cast<int>(random() % 25), value);
+        if (!checkAgainstStrtod(text))
+            return false;
+        *std::to_chars(text, text + sizeof text - 1, value).ptr = '\0';
+        if (!checkAgainstStrtod(text))
+            return false;
+    }
+    return true;
+}
+
+// Run text through FastReader by way of a temporary file, reading doubles until it fails.
+std::vector<double> readWithFastReader(const std::string& text, bool& reachedEnd)
+{
+    char path[]{ "/tmp/fast-double-benchmark-XXXXXX" };
+    const int fd{ ::mkstemp(path) };
+    if (::write(fd, text.data(), text.size()) != static_cast<ssize_t>(text.size()))
+        std::perror("write");
+    ::lseek(fd, 0, SEEK_SET);
+    std::vector<double> values{ };
+    {
+        FastReader input{ fd };
+        double value{ };
+        while (input >> value)
+            values.push_back(value);
+        values.push_back(value); // what the failed read left behind
+        reachedEnd = input.eof();
+    }
+    ::close(fd);
+    ::unlink(path);
+    return values;
+}
+
+std::vector<double> readWithStream(const std::string& text, bool& reachedEnd)
+{
+    std::istringstream input{ text };
+    std::vector<double> values{ };
+    double value{ };
+    while (input >> value)
+        values.push_back(value);
+    values.push_back(value);
+    reachedEnd = input.eof();
+    return values;
+}
+
+// The ways std::cin >> width can fail (or stop short), read both ways.
+bool checkFailures()
+{
+    const char* const inputs[]{ "1.5 2.5", "-0 +7", "2e 3", "2e+x", "1e400 5", "-1e400", "1e-400 1", ".5 5.", ".",
+                                "-x",      "5-6",   "1.5.3", "abc", "",        "  \n", "1e5e5", "0x10", "inf",  "--1" };
+    for (const char* text : inputs)
+    {
+        bool streamEnd{ };
+        bool readerEnd{ };
+        const std::vector<double> expected{ readWithStream(text, streamEnd) };
+        const std::vector<double> got{ readWithFastReader(text, readerEnd) };
+        bool same{ expected.size() == got.size() && streamEnd == readerEnd };
+        for (std::size_t i{ 0 }; same && i < got.size(); ++i)
+            same = sameBits(got[i], expected[i]);
+        if (!same)
+        {
+            std::printf("MISMATCH: FastReader and std::istringstream disagree on \"%s\"\n", text);
+            return false;
+        }
+    }
+    return true;
+}
+
+struct Input
+{
+    std::string text{ };
+    std::vector<std::size_t> starts{ }; // where each number begins in text
+    std::vector<double> expected{ };    // strtod's value for each
+};
+
+Input makeInput(std::size_t count)
+{
+    Input input{ };
+    std::mt19937_64 random{ 12345 };
+    std::uniform_real_distribution<double> reading{ -500.0, 5000.0 };
+    std::uniform_real_distribution<double> mantissa{ 1.0, 10.0 };
+    std::uniform_int_distribution<int> exponent{ -300, 300 };
+    char number[64]{ };
+    for (std::size_t i{ 0 }; i < count; ++i)
+    {
+        int length{ };
+        if (i % 2 == 0)
+            length = std::snprintf(number, sizeof number, "%.*f", static_cast<int>(random() % 5), reading(random));
+        else
+        {
+            const double value{ mantissa(random) * std::pow(10.0, exponent(random)) };
+            length = static_cast<int>(std::to_chars(number, number + sizeof number, value).ptr - number);
+        }
+        input.starts.push_back(input.text.size());
+        input.text.append(number, static_cast<std::size_t>(length));
+        input.text += '\n';
+    }
+    for (const std::size_t start : input.starts)
+        input.expected.push_back(std::strtod(input.text.c_str() + start, nullptr));
+    return input;
+}
+
+template <typename Parse>
+bool checkParser(const char* name, const Input& input, Parse&& parse)
+{
+    std::vector<double> values(input.expected.size());
+    parse(values.data());
+    for (std::size_t i{ 0 }; i < values.size(); ++i)
+    {
+        if (!sameBits(values[i], input.expected[i]))
+        {
+            std::printf("MISMATCH: %s read number %zu as %.17g, strtod as %.17g\n", name, i, values[i],
+                        input.expected[i]);
+            return false;
+        }
+    }
+    return true;
+}
+
+int main(int argc, char* argv[])
+{
+    const std::size_t count{ static_cast<std::size_t>((argc > 1 ? std::atof(argv[1]) : 5) * 1e6) };
+    const int repetitions{ argc > 2 ? std::atoi(argv[2]) : 3 };
+
+    if (!checkHardCases() || !checkRandomBits(1'000'000) || !checkFailures())
+        return 1;
+
+    const Input input{ makeInput(count) };
+    const char* const text{ input.text.c_str() };
+    const char* const textEnd{ text + input.text.size() };
+
+    char path[]{ "/tmp/fast-double-benchmark-XXXXXX" };
+    const int fd{ ::mkstemp(path) };
+    if (::write(fd, input.text.data(), input.text.size()) != static_cast<ssize_t>(input.text.size()))
+    {
+        std::perror(path);
+        return 1;
+    }
+
+    const auto withStrtod{ [&](double* values) {
+        char* p{ const_cast<char*>(text) };
+        for (std::size_t i{ 0 }; i < count; ++i)
+            values[i] = std::strtod(p, &p);
+    } };
+    const auto withStream{ [&](double* values) {
+        std::istringstream stream{ input.text };
+        for (std::size_t i{ 0 }; i < count; ++i)
+            stream >> values[i];
+    } };
+    const auto withFromChars{ [&](double* values) {
+        const char* p{ text };
+        for (std::size_t i{ 0 }; i < count; ++i)
+            p = std::from_chars(p, textEnd, values[i]).ptr + 1;
+    } };
+    const auto withParseDouble{ [&](double* values) {
+        const char* p{ text };
+        for (std::size_t i{ 0 }; i < count; ++i)
+            p = parseDouble(p, textEnd, values[i]).ptr + 1;
+    } };
+    const auto withFastReader{ [&](double* values) {
+        ::lseek(fd, 0, SEEK_SET);
+        FastReader reader{ fd };
+        for (std::size_t i{ 0 }; i < count; ++i)
+            reader >> values[i];
+    } };
+
+    if (!checkParser("strtod", input, withStrtod) || !checkParser("istringstream", input, withStream) ||
+        !checkParser("from_chars", input, withFromChars) || !checkParser("parseDouble", input, withParseDouble) ||
+        !checkParser("FastReader", input, withFastReader))
+    {
+        return 1;
+    }
+
+    std::vector<double> values(count);
+    const auto time{ [&](const char* name, auto&& parse) {
+        const double seconds{ bestOf(repetitions, [&] {
+            parse(values.data());
+            benchmarkSink = values[count / 2];
+        }) };
+        std::printf("%-14s %9.1f ms %7.1f ns/number %7.0f MB/s\n", name, seconds * 1e3,
+                    seconds * 1e9 / static_cast<double>(count),
+                    static_cast<double>(input.text.size()) / seconds / 1e6);
+    } };
+
+    std::printf("%zu numbers, %zu bytes, best of %d\n\nparsing\n", count, input.text.size(), repetitions);
+    time("strtod", withStrtod);
+    time("istringstream", withStream);
+    time("from_chars", withFromChars);
+    time("parseDouble", withParseDouble);
+    time("FastReader", withFastReader);
+    ::close(fd);
+    ::unlink(path);
+
+    // Output: each way of printing must read back to exactly the same doubles.
+    std::string printed{ };
+    const auto withStreamOut{ [&] {
+        std::ostringstream stream{ };
+        stream << std::setprecision(std::numeric_limits<double>::max_digits10);
+        for (const double value : input.expected)
+            stream << value << '\n';
+        printed = std::move(stream).str();
+    } };
+    const auto withToChars{ [&] {
+        printed.resize(count * 32);
+        char* p{ printed.data() };
+        for (const double value : input.expected)
+        {
+            p = std::to_chars(p, p + 32, value).ptr;
+            *p++ = '\n';
+        }
+        printed.resize(static_cast<std::size_t>(p - printed.data()));
+    } };
+    const auto readsBack{ [&](const char* name) {
+        const char* p{ printed.c_str() };
+        for (std::size_t i{ 0 }; i < count; ++i)
+        {
+            double value{ };
+            p = parseDouble(p, printed.c_str() + printed.size(), value).ptr + 1;
+            if (!sameBits(value, input.expected[i]))
+            {
+                std::printf("MISMATCH: %s printed %.17g so that it reads back as %.17g\n", name, input.expected[i],
+                            value);
+                return false;
+            }
+        }
+        return true;
+    } };
+
+    std::printf("\nprinting\n");
+    const double streamSeconds{ bestOf(repetitions, withStreamOut) };
+    if (!readsBack("ostringstream"))
+        return 1;
+    std::printf("%-14s %9.1f ms %7.1f ns/number %7.1f bytes/number\n", "ostringstream", streamSeconds * 1e3,
+                streamSeconds * 1e9 / static_cast<double>(count),
+                static_cast<double>(printed.size()) / static_cast<double>(count));
+    const double toCharsSeconds{ bestOf(repetitions, withToChars) };
+    if (!readsBack("to_chars"))
+        return 1;
+    std::printf("%-14s %9.1f ms %7.1f ns/number %7.1f bytes/number\n", "to_chars", toCharsSeconds * 1e3,
+                toCharsSeconds * 1e9 / static_cast<double>(count),
+                static_cast<double>(printed.size()) / static_cast<double>(count));
+    return 0;
+}
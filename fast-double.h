@@ -0,0 +1,81 @@
+#ifndef FAST_DOUBLE_H
+#define FAST_DOUBLE_H
+
+//** Parsing doubles quickly, and exactly **//
+
+// obj-var.cpp defines double width; next to int x;. Reading a double is much harder than reading an int: the decimal
+// text almost never has an exact binary value, and the result has to be the double nearest to it, which for some
+// inputs depends on the 17th digit or beyond. std::cin >> width gets that right by collecting the characters and
+// handing them to strtod, which is slow in its own right, on top of the cost of the stream.
+
+// parseDouble() gives exactly the double strtod would, bit for bit, at a fraction of the cost. The work is done by
+// std::from_chars, which in libstdc++ 12 is the fast_float library, in three tiers:
+    // Clinger's fast path: most numbers in real files have at most 15 or so significant digits and a small exponent
+    // (like 21.375 or -0.00042). Then the digits as an integer, and the power of ten, are both exact doubles, and
+    // one multiplication or division by the power of ten rounds correctly.
+    // Eisel-Lemire: otherwise, the digits are multiplied by a 128-bit approximation of the power of ten (from a
+    // table of powers of five), which is close enough to settle the rounding for all but a tiny fraction of inputs.
+    // Big-number arithmetic for those last few, such as numbers almost exactly halfway between two doubles.
+// What parseDouble() adds is std::cin's idea of a number, and strtod's answer when it doesn't fit: the numbers that
+// overflow, or underflow to zero, are given to strtod itself.
+
+//     double width{ };
+//     const std::from_chars_result result{ parseDouble(first, last, width) };
+//     if (result.ec == std::errc{ })
+//         ... // width is what strtod(first) would give, and result.ptr is just past the number
+
+// Numbers are written the way std::cin >> accepts them: an optional sign, digits with an optional decimal point
+// (at least one digit), and an optional exponent (e or E, an optional sign, digits). Unlike std::from_chars, a
+// leading '+' is accepted; unlike strtod, leading whitespace, hexadecimal, inf and nan aren't.
+
+// FastReader (fast-input.h) uses this for reader >> width. For output, FastWriter (fast-output.h) already prints
+// doubles with std::to_chars, in the shortest form that reads back as the same double, which is what parseDouble()
+// is checked against in fast-double-benchmark.cpp.
+
+#include <charconv>
+#include <cstdlib>
+#include <string>
+#include <system_error>
+
+namespace fastDoubleDetail
+{
+    inline bool isDigit(char c) { return static_cast<unsigned char>(c - '0') < 10; }
+
+    // What strtod gives for a number that std::from_chars reports as out of range.
+    inline double slowParse(const char* first, const char* last)
+    {
+        const std::string text{ first, last };
+        return std::strtod(text.c_str(), nullptr);
+    }
+}
+
+// Parse a decimal floating-point number at the start of [first, last) into value. On success, result.ptr is just
+// past it and value is what strtod would give. If the number's magnitude is too large for a double, or so small
+// that it rounds to zero, value is still what strtod gives (infinity or zero) and result.ec is
+// std::errc::result_out_of_range. If there is no number, result.ec is std::errc::invalid_argument, result.ptr is
+// first and value is left alone.
+inline std::from_chars_result parseDouble(const char* first, const char* last, double& value)
+{
+    using namespace fastDoubleDetail;
+
+    const char* p{ first };
+    const bool negative{ p != last && *p == '-' };
+    if (p != last && (*p == '-' || *p == '+'))
+        ++p;
+
+    // std::from_chars would also take inf and nan (and a second '-').
+    if (p == last || !(isDigit(*p) || (*p == '.' && last - p > 1 && isDigit(p[1]))))
+        return { first, std::errc::invalid_argument };
+
+    double magnitude{ };
+    const std::from_chars_result parsed{ std::from_chars(p, last, magnitude) };
+    if (parsed.ec == std::errc::result_out_of_range)
+    {
+        value = slowParse(first, parsed.ptr);
+        return parsed;
+    }
+    value = negative ? -magnitude : magnitude;
+    return { parsed.ptr, std::errc{ } };
+}
+
+#endif
@@ -0,0 +1,336 @@
+#ifndef FAST_INPUT_H
+#define FAST_INPUT_H
+
+//** A faster replacement for std::cin >> x **//
+
+// Every std::cin >> x builds a sentry object, consults the stream's locale to parse the digits and (unless
+// std::ios::sync_with_stdio(false) was called) synchronizes with C stdio. For a couple of numbers typed at the
+// keyboard this doesn't matter, but when a program reads millions of integers the stream machinery costs far
+// more than the parsing itself.
+
+// FastReader reads large blocks straight from a file descriptor with read(2) into its own buffer, and parses
+// decimal integers by hand. It gives the same values as std::cin >> x for the classic "C" locale, including the
+// failure behaviour:
+    // leading whitespace is skipped, an optional '+' or '-' sign is accepted, then one or more digits.
+    // input like 5-6 is read as 5 and then -6, because the '-' starts the next number.
+    // if no digits are found, the value is set to 0 and the reader enters a failed state.
+    // if the input ends before a number starts, the value is left alone and the reader fails.
+    // if the number doesn't fit in an int, the value is set to the largest (or smallest) int and the reader fails.
+    // once failed, every further read fails (leaving the value alone) until clear() is called.
+
+// Usage:
+
+//     FastReader input{ };            // reads from standard input
+//     int x{ };
+//     int y{ };
+//     if (input >> x >> y)
+//         ...
+
+// Doubles can be read the same way (input >> width), with the value strtod would give; see readDouble().
+
+// For bulk input, readInts() fills a whole array at once using the vectorized kernels from simd-parse.h.
+
+#include <cerrno>
+#include <cfloat>
+#include <charconv>
+#include <climits>
+#include <cmath>
+#include <cstddef>
+#include <cstring>
+#include <memory>
+#include <system_error>
+#include <unistd.h>
+
+#include "fast-double.h"
+#include "simd-parse.h"
+
+class FastReader
+{
+public:
+    static constexpr std::size_t defaultBufferSize{ 1 << 16 };
+
+    explicit FastReader(int fd = STDIN_FILENO, std::size_t bufferSize = defaultBufferSize)
+        : m_fd{ fd }
+        , m_buffer{ new char[bufferSize] }
+        , m_capacity{ bufferSize }
+    {
+    }
+
+    FastReader(const FastReader&) = delete;
+    FastReader& operator=(const FastReader&) = delete;
+
+    // Read one int. Returns false (and leaves the reader failed) if no valid int could be read.
+    bool readInt(int& value)
+    {
+        if (m_failed)
+            return false;
+
+        // Like std::cin, running out of input before any number starts leaves value untouched.
+        int c{ skipWhitespace() };
+        if (c == endOfInput)
+        {
+            m_failed = true;
+            return false;
+        }
+
+        bool negative{ false };
+        if (c == '+' || c == '-')
+        {
+            negative = (c == '-');
+            ++m_position;
+            c = peek();
+        }
+
+        if (!isDigit(c))
+        {
+            value = 0;
+            m_failed = true;
+            return false;
+        }
+
+        // Accumulate the magnitude in a wider type; anything past INT_MAX + 1 can stop accumulating.
+        long long magnitude{ 0 };
+        bool overflow{ false };
+        do
+        {
+            if (!overflow)
+            {
+                magnitude = magnitude * 10 + (c - '0');
+                overflow = magnitude > static_cast<long long>(INT_MAX) + 1;
+            }
+            ++m_position;
+            c = peek();
+        } while (isDigit(c));
+
+        if (negative)
+            magnitude = -magnitude;
+
+        if (overflow || magnitude > INT_MAX || magnitude < INT_MIN)
+        {
+            value = negative ? INT_MIN : INT_MAX;
+            m_failed = true;
+            return false;
+        }
+
+        value = static_cast<int>(magnitude);
+        return true;
+    }
+
+    FastReader& operator>>(int& value)
+    {
+        readInt(value);
+        return *this;
+    }
+
+    // Read one double. The value is exactly what strtod gives for the number (see fast-double.h), and the failures
+    // are std::cin's: no number sets it to 0, as does an exponent marker with no digits after it ("2e"), and a
+    // number too large for a double sets it to the largest double of its sign. All of them fail the reader.
+    bool readDouble(double& value)
+    {
+        if (m_failed)
+            return false;
+
+        if (skipWhitespace() == endOfInput)
+        {
+            m_failed = true;
+            return false;
+        }
+
+        // Parse what's buffered. If the bytes that could belong to the number run to the end of the buffer, it may
+        // go on in the input that hasn't been read yet, so read more and parse it again.
+        const char* first{ };
+        std::from_chars_result result{ };
+        for (;;)
+        {
+            first = m_buffer.get() + m_position;
+            const char* const last{ m_buffer.get() + m_size };
+            result = parseDouble(first, last, value);
+            const char* end{ result.ptr };
+            while (end != last && isNumberByte(*end))
+                ++end;
+            if (end != last || m_endOfFile)
+                break;
+            if (!refillKeepingTail())
+            {
+                // A "number" as long as the whole buffer.
+                value = 0;
+                m_failed = true;
+                return false;
+            }
+        }
+
+        if (result.ec == std::errc::invalid_argument)
+        {
+            // std::cin takes a sign and a decimal point before it finds there are no digits.
+            if (*first == '+' || *first == '-')
+                ++m_position;
+            if (m_position != m_size && m_buffer[m_position] == '.')
+                ++m_position;
+            value = 0;
+            m_failed = true;
+            return false;
+        }
+        const bool hasExponent{ std::memchr(first, 'e', static_cast<std::size_t>(result.ptr - first)) ||
+                                std::memchr(first, 'E', static_cast<std::size_t>(result.ptr - first)) };
+        m_position = static_cast<std::size_t>(result.ptr - m_buffer.get());
+
+        // "2e" or "2e+" with nothing after: std::cin takes the e (and sign) as the start of an exponent, then fails.
+        const int next{ peek() };
+        if (!hasExponent && (next == 'e' || next == 'E'))
+        {
+            ++m_position;
+            const int sign{ peek() };
+            if (sign == '+' || sign == '-')
+                ++m_position;
+            value = 0;
+            m_failed = true;
+            return false;
+        }
+        if (value == HUGE_VAL || value == -HUGE_VAL)
+        {
+            value = value > 0 ? DBL_MAX : -DBL_MAX;
+            m_failed = true;
+            return false;
+        }
+        return true;
+    }
+
+    FastReader& operator>>(double& value)
+    {
+        readDouble(value);
+        return *this;
+    }
+
+    // Read up to capacity ints into values, stopping early at the end of the input or at the first bad number
+    // (after which the reader is failed, exactly as if readInt had been called in a loop). Returns the count read.
+    std::size_t readInts(int* values, std::size_t capacity)
+    {
+        std::size_t count{ 0 };
+        while (count < capacity && !m_failed)
+        {
+            const char* first{ m_buffer.get() + m_position };
+            const char* last{ m_buffer.get() + m_size };
+
+            // The kernel treats the end of its range as the end of the input, so unless the input really has
+            // ended, only hand it the buffered text up to the last whitespace (a number may continue past it).
+            const char* end{ m_endOfFile ? last : lastSpace(first, last) };
+            if (end == first)
+            {
+                if (!m_endOfFile && refillKeepingTail())
+                    continue;
+
+                // A single number bigger than the buffer, or the end of the input: the slow path handles both.
+                if (readInt(values[count]))
+                    ++count;
+                continue;
+            }
+
+            const ParseResult result{ parseInts(first, end, values + count, capacity - count) };
+            count += result.count;
+            m_position = static_cast<std::size_t>(result.next - m_buffer.get());
+
+            // Let readInt reproduce std::cin's exact failure (and the value it stores).
+            if (result.stopped && readInt(values[count]))
+                ++count;
+        }
+        return count;
+    }
+
+    explicit operator bool() const { return !m_failed; }
+    bool fail() const { return m_failed; }
+
+    // True once all input has been consumed (trailing whitespace included).
+    bool eof()
+    {
+        return skipWhitespace() == endOfInput;
+    }
+
+    void clear() { m_failed = false; }
+
+private:
+    static constexpr int endOfInput{ -1 };
+
+    static bool isDigit(int c) { return static_cast<unsigned>(c - '0') < 10; }
+
+    static bool isNumberByte(char c) { return isDigit(c) || c == '.' || c == 'e' || c == 'E' || c == '+' || c == '-'; }
+
+    // Same set of characters as std::isspace in the "C" locale.
+    static bool isSpace(int c) { return c == ' ' || static_cast<unsigned>(c - '\t') < 5; }
+
+    int peek()
+    {
+        if (m_position == m_size && !refill())
+            return endOfInput;
+        return static_cast<unsigned char>(m_buffer[m_position]);
+    }
+
+    int skipWhitespace()
+    {
+        int c{ peek() };
+        while (isSpace(c))
+        {
+            ++m_position;
+            c = peek();
+        }
+        return c;
+    }
+
+    static const char* lastSpace(const char* first, const char* last)
+    {
+        while (last != first && !isSpace(last[-1]))
+            --last;
+        return last == first ? first : last - 1;
+    }
+
+    // Like refill(), but keeps the unconsumed bytes. Returns false if nothing changed (full buffer, or the input
+    // had already ended).
+    bool refillKeepingTail()
+    {
+        const std::size_t tail{ m_size - m_position };
+        if (m_endOfFile || tail == m_capacity)
+            return false;
+
+        std::memmove(m_buffer.get(), m_buffer.get() + m_position, tail);
+        m_position = 0;
+        m_size = tail;
+
+        ssize_t count{ };
+        do
+        {
+            count = ::read(m_fd, m_buffer.get() + tail, m_capacity - tail);
+        } while (count < 0 && errno == EINTR);
+
+        if (count > 0)
+            m_size += static_cast<std::size_t>(count);
+        else
+            m_endOfFile = true;
+        return true;
+    }
+
+    bool refill()
+    {
+        if (m_endOfFile)
+            return false;
+
+        ssize_t count{ };
+        do
+        {
+            count = ::read(m_fd, m_buffer.get(), m_capacity);
+        } while (count < 0 && errno == EINTR);
+
+        m_position = 0;
+        m_size = count > 0 ? static_cast<std::size_t>(count) : 0;
+        m_endOfFile = (count <= 0);
+        return m_size != 0;
+    }
+
+    int m_fd{ };
+    std::unique_ptr<char[]> m_buffer{ };
+    std::size_t m_capacity{ };
+    std::size_t m_position{ 0 };
+    std::size_t m_size{ 0 };
+    bool m_endOfFile{ false };
+    bool m_failed{ false };
+};
+
+#endif
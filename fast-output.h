@@ -0,0 +1,179 @@
+#ifndef FAST_OUTPUT_H
+#define FAST_OUTPUT_H
+
+//** A faster replacement for std::cout << x **//
+
+// iostream.cpp recommends '\n' over std::endl because std::endl flushes. Even with '\n', though, every
+// std::cout << x goes through a sentry, the stream's locale and (by default) C stdio. When a program prints
+// millions of lines, the formatting machinery and the write(2) system calls behind each flush dominate.
+
+// FastWriter formats numbers with std::to_chars straight into a large buffer, and hands the whole buffer to the
+// operating system with a single write(2) when it is drained. When that happens is chosen by a flush policy:
+    // whenFull:     write only when the buffer fills up (and when the writer is destroyed). Best for files and pipes.
+    // eachLine:     also write after every '\n', so a person at the console sees each line as it is completed.
+    // explicitOnly: never write until flush() is called; the buffer grows instead. Useful when a batch of output
+    //               should reach the file in one piece.
+    // automatic:    eachLine if the output is a terminal, whenFull otherwise (the default).
+
+// Usage:
+
+//     FastWriter output{ };            // writes to standard output
+//     int x{ 5 };
+//     output << "x is equal to: " << x << '\n';
+
+// Note that FastWriter has its own buffer: don't mix it with std::cout on the same descriptor without calling
+// flush() in between, or the output of the two can come out of order.
+
+#include <algorithm>
+#include <cerrno>
+#include <charconv>
+#include <cstddef>
+#include <cstring>
+#include <memory>
+#include <string_view>
+#include <type_traits>
+#include <unistd.h>
+
+enum class FlushPolicy
+{
+    whenFull,
+    eachLine,
+    explicitOnly,
+    automatic,
+};
+
+class FastWriter
+{
+public:
+    static constexpr std::size_t defaultBufferSize{ 1 << 16 };
+    static constexpr std::size_t minimumBufferSize{ 64 }; // room for any single formatted number
+
+    explicit FastWriter(int fd = STDOUT_FILENO, FlushPolicy policy = FlushPolicy::automatic,
+                        std::size_t bufferSize = defaultBufferSize)
+        : m_fd{ fd }
+        , m_buffer{ new char[std::max(bufferSize, minimumBufferSize)] }
+        , m_capacity{ std::max(bufferSize, minimumBufferSize) }
+        , m_policy{ policy == FlushPolicy::automatic
+                        ? (::isatty(fd) ? FlushPolicy::eachLine : FlushPolicy::whenFull)
+                        : policy }
+    {
+    }
+
+    FastWriter(const FastWriter&) = delete;
+    FastWriter& operator=(const FastWriter&) = delete;
+
+    ~FastWriter() { flush(); }
+
+    FlushPolicy policy() const { return m_policy; }
+
+    FastWriter& operator<<(std::string_view text)
+    {
+        append(text.data(), text.size());
+        if (m_policy == FlushPolicy::eachLine && text.find('\n') != std::string_view::npos)
+            flush();
+        return *this;
+    }
+
+    FastWriter& operator<<(const char* text) { return *this << std::string_view{ text }; }
+
+    FastWriter& operator<<(char c)
+    {
+        if (m_size == m_capacity)
+            makeRoom(1);
+        m_buffer[m_size++] = c;
+        if (c == '\n' && m_policy == FlushPolicy::eachLine)
+            flush();
+        return *this;
+    }
+
+    // Integers and floating point numbers are formatted with std::to_chars. Doubles are printed in their shortest
+    // round-trip form (which can differ from std::cout's default 6 significant digits).
+    template <typename T>
+        requires(std::is_arithmetic_v<T> && !std::is_same_v<T, char> && !std::is_same_v<T, bool>)
+    FastWriter& operator<<(T value)
+    {
+        constexpr std::size_t longestNumber{ 32 }; // enough for any integer or shortest-form double
+        if (m_capacity - m_size < longestNumber)
+            makeRoom(longestNumber);
+        const std::to_chars_result result{ std::to_chars(m_buffer.get() + m_size, m_buffer.get() + m_capacity, value) };
+        m_size = static_cast<std::size_t>(result.ptr - m_buffer.get());
+        return *this;
+    }
+
+    FastWriter& operator<<(bool value) { return *this << (value ? '1' : '0'); }
+
+    // Hand everything buffered to the operating system. Returns false if the write failed (the data is dropped,
+    // much like std::cout sets badbit).
+    bool flush()
+    {
+        const std::size_t size{ m_size };
+        m_size = 0;
+        writeDirect(m_buffer.get(), size);
+        return !m_failed;
+    }
+
+    bool fail() const { return m_failed; }
+
+private:
+    void append(const char* data, std::size_t size)
+    {
+        if (m_capacity - m_size < size)
+        {
+            makeRoom(size);
+
+            // Too large to be worth copying: write it straight through.
+            if (m_capacity - m_size < size)
+            {
+                writeDirect(data, size);
+                return;
+            }
+        }
+        std::memcpy(m_buffer.get() + m_size, data, size);
+        m_size += size;
+    }
+
+    // Ensure there is space for at least size more bytes, if the policy allows: drain the buffer, or (for
+    // explicitOnly) grow it.
+    void makeRoom(std::size_t size)
+    {
+        if (m_policy != FlushPolicy::explicitOnly)
+        {
+            flush();
+            return;
+        }
+
+        std::size_t capacity{ m_capacity * 2 };
+        while (capacity - m_size < size)
+            capacity *= 2;
+        std::unique_ptr<char[]> larger{ new char[capacity] };
+        std::memcpy(larger.get(), m_buffer.get(), m_size);
+        m_buffer = std::move(larger);
+        m_capacity = capacity;
+    }
+
+    void writeDirect(const char* data, std::size_t size)
+    {
+        while (size != 0)
+        {
+            const ssize_t written{ ::write(m_fd, data, size) };
+            if (written < 0)
+            {
+                if (errno == EINTR)
+                    continue;
+                m_failed = true;
+                return;
+            }
+            data += written;
+            size -= static_cast<std::size_t>(written);
+        }
+    }
+
+    int m_fd{ };
+    std::unique_ptr<char[]> m_buffer{ };
+    std::size_t m_capacity{ };
+    std::size_t m_size{ 0 };
+    FlushPolicy m_policy{ };
+    bool m_failed{ false };
+};
+
+#endif
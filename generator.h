@@ -0,0 +1,138 @@
+#ifndef GENERATOR_H
+#define GENERATOR_H
+
+//** A range whose elements are computed only when they're asked for **//
+
+// keywords-identifiers.cpp lists co_await, co_yield and co_return: the keywords that make a function a coroutine,
+// one that can stop part way through and carry on later from where it was. Generator<T> is the return type for a
+// coroutine that produces a sequence of values with co_yield:
+
+//     Generator<int> squares()
+//     {
+//         for (int i{ 0 };; ++i)
+//             co_yield i * i;      // hands i * i to the loop below, and waits here until it wants another
+//     }
+//
+//     for (int square : squares())
+//         ...                      // the loop runs the coroutine just far enough to get each value
+
+// The coroutine's local variables live in a frame on the heap, allocated once when it's called, so an endless
+// sequence takes no more memory than its first element. A Generator is a C++20 input range (and a view), so it
+// works with range-for and with std::views: squares() | std::views::take(10). It can be moved but not copied, and
+// it can be iterated only once.
+
+// Exceptions thrown inside the coroutine come out of whichever begin() or ++ resumed it. Nothing in it may use
+// co_await.
+
+#include <coroutine>
+#include <cstddef>
+#include <iterator>
+#include <memory>
+#include <ranges>
+#include <utility>
+
+template <typename T>
+class Generator : public std::ranges::view_interface<Generator<T>>
+{
+public:
+    struct promise_type
+    {
+        Generator get_return_object() { return Generator{ Handle::from_promise(*this) }; }
+
+        std::suspend_always initial_suspend() noexcept { return { }; }
+        std::suspend_always final_suspend() noexcept { return { }; }
+
+        // value lives in the coroutine until it's resumed, so a pointer to it is all that's needed.
+        std::suspend_always yield_value(const T& value) noexcept
+        {
+            m_value = std::addressof(value);
+            return { };
+        }
+
+        void return_void() noexcept { }
+        void unhandled_exception() { throw; }
+
+        template <typename U>
+        std::suspend_never await_transform(U&&) = delete;
+
+        const T* m_value{ nullptr };
+    };
+
+    using Handle = std::coroutine_handle<promise_type>;
+
+    class iterator
+    {
+    public:
+        using value_type = T;
+        using difference_type = std::ptrdiff_t;
+
+        iterator() = default;
+
+        explicit iterator(Handle coroutine)
+            : m_coroutine{ coroutine }
+        {
+        }
+
+        const T& operator*() const { return *m_coroutine.promise().m_value; }
+
+        iterator& operator++()
+        {
+            m_coroutine.resume();
+            return *this;
+        }
+
+        void operator++(int) { ++*this; }
+
+        friend bool operator==(const iterator& it, std::default_sentinel_t)
+        {
+            return !it.m_coroutine || it.m_coroutine.done();
+        }
+
+    private:
+        Handle m_coroutine{ };
+    };
+
+    Generator() = default;
+
+    Generator(Generator&& other) noexcept
+        : m_coroutine{ std::exchange(other.m_coroutine, { }) }
+    {
+    }
+
+    Generator& operator=(Generator&& other) noexcept
+    {
+        if (this != &other)
+        {
+            if (m_coroutine)
+                m_coroutine.destroy();
+            m_coroutine = std::exchange(other.m_coroutine, { });
+        }
+        return *this;
+    }
+
+    ~Generator()
+    {
+        if (m_coroutine)
+            m_coroutine.destroy();
+    }
+
+    // Runs the coroutine up to its first co_yield (or its end).
+    iterator begin()
+    {
+        if (m_coroutine)
+            m_coroutine.resume();
+        return iterator{ m_coroutine };
+    }
+
+    std::default_sentinel_t end() const { return { }; }
+
+private:
+    explicit Generator(Handle coroutine)
+        : m_coroutine{ coroutine }
+    {
+    }
+
+    Handle m_coroutine{ };
+};
+
+#endif
@@ -0,0 +1,41 @@
+//** Hello world, for a program that is started thousands of times a second **//
+
+// Build and run (statically linked, which is the point):
+//     g++ -std=c++20 -O2 -static hello-fast.cpp -o hello-fast
+//     ./hello-fast
+
+// statements-functions.cpp prints "Hello world!" with std::cout. Most of the time that program takes isn't spent
+// printing: before main() runs, the dynamic linker has to find, map and relocate libstdc++, libm, libgcc_s and libc,
+// and including <iostream> adds a static std::ios_base::Init object whose constructor builds the eight standard
+// streams, their buffers and the locale they all share. For a program that starts, prints a line and exits, that
+// start-up work is nearly all of its run time.
+
+// This version prints the same bytes with one write(2) to the standard output. It includes no iostream (so no
+// static initializer runs before main()) and uses nothing from libstdc++, and built with -static it needs no
+// dynamic linker either: the kernel maps one file and jumps to it. startup-benchmark.cpp measures the difference.
+
+// Like the original, it exits with 0, unless the text couldn't be written (a closed pipe, a full disk), which the
+// original doesn't check for.
+
+#include <cerrno>
+#include <cstddef>
+#include <unistd.h>
+
+int main()
+{
+    static constexpr char text[]{ "Hello world!" };
+    const char* next{ text };
+    const char* const end{ text + sizeof(text) - 1 };
+    while (next != end)
+    {
+        const ssize_t written{ ::write(STDOUT_FILENO, next, static_cast<std::size_t>(end - next)) };
+        if (written < 0)
+        {
+            if (errno == EINTR)
+                continue;
+            return 1;
+        }
+        next += written;
+    }
+    return 0;
+}
@@ -0,0 +1,136 @@
+//** Benchmark: lexing identifiers out of source files **//
+
+// Build and run:
+//     g++ -std=c++20 -O2 identifier-lexer-benchmark.cpp -o identifier-lexer-benchmark
+//     ./identifier-lexer-benchmark [megabytes, default 64] [source files...]
+
+// The corpus is made by repeating the given source files (by default, every .cpp and .h file in the current
+// directory) until it reaches the requested size. Every kernel must produce exactly the same tokens as the scalar
+// reference before anything is timed.
+
+#include <algorithm>
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <filesystem>
+#include <string>
+#include <string_view>
+#include <vector>
+
+#include "identifier-lexer.h"
+#include "mapped-input.h"
+
+struct Counts
+{
+    std::size_t identifiers{ 0 };
+    std::size_t keywords{ 0 };
+    std::size_t numbers{ 0 };
+};
+
+std::vector<Token> collectTokens(std::string_view source, LexerKernel kernel)
+{
+    std::vector<Token> tokens{ };
+    lexWords(source, [&](const Token& token) { tokens.push_back(token); }, kernel);
+    return tokens;
+}
+
+bool sameTokens(const std::vector<Token>& a, const std::vector<Token>& b)
+{
+    return std::equal(a.begin(), a.end(), b.begin(), b.end(), [](const Token& x, const Token& y) {
+        return x.text == y.text && x.offset == y.offset && x.kind == y.kind;
+    });
+}
+
+int main(int argc, char* argv[])
+{
+    const double megabytes{ argc > 1 ? std::atof(argv[1]) : 64 };
+
+    std::vector<std::string> paths{ };
+    for (int i{ 2 }; i < argc; ++i)
+        paths.emplace_back(argv[i]);
+    if (paths.empty())
+    {
+        for (const auto& entry : std::filesystem::directory_iterator{ "." })
+        {
+            const std::string extension{ entry.path().extension().string() };
+            if (entry.is_regular_file() && (extension == ".cpp" || extension == ".h"))
+                paths.push_back(entry.path().string());
+        }
+        std::sort(paths.begin(), paths.end());
+    }
+
+    std::string sample{ };
+    for (const std::string& path : paths)
+    {
+        const MappedInput input{ path.c_str() };
+        sample.append(input.text());
+        sample += '\n';
+    }
+
+    // Constructs that trip up a naive lexer, so the check below covers them too.
+    sample += R"cpp(
+        auto s{ u8"int x" }; auto r{ R"delim(int )" y)delim" }; char c{ '\'' }; long big{ 1'000'000 };
+        double e{ 1.5e+10 }; int _leading; /* int commented; */ // int alsoCommented;
+        const char* path{ "C:\\dir\\" }; int after;
+    )cpp";
+    if (sample.size() <= 1)
+    {
+        std::printf("no source files found\n");
+        return 1;
+    }
+
+    std::string corpus{ };
+    const std::size_t wanted{ static_cast<std::size_t>(megabytes * 1e6) };
+    while (corpus.size() < wanted)
+        corpus += sample;
+
+    struct Kernel
+    {
+        const char* name{ };
+        LexerKernel kernel{ };
+    };
+    std::vector<Kernel> kernels{ { "scalar", LexerKernel::scalar } };
+#ifdef IDENTIFIER_LEXER_X86
+    if (__builtin_cpu_supports("ssse3"))
+        kernels.push_back({ "ssse3", LexerKernel::ssse3 });
+    if (__builtin_cpu_supports("avx2"))
+        kernels.push_back({ "avx2", LexerKernel::avx2 });
+#endif
+
+    // Check on the sample and on a few shifted copies, so every construct lands at different offsets in the blocks.
+    for (std::size_t shift{ 0 }; shift < 64; shift += 7)
+    {
+        const std::string shifted{ std::string(shift, ' ') + sample };
+        const std::vector<Token> expected{ collectTokens(shifted, LexerKernel::scalar) };
+        for (const Kernel& kernel : kernels)
+        {
+            if (!sameTokens(collectTokens(shifted, kernel.kernel), expected))
+            {
+                std::printf("MISMATCH: %s (shift %zu)\n", kernel.name, shift);
+                return 1;
+            }
+        }
+    }
+    std::printf("%zu files, %.1f MB corpus, all kernels agree\n", paths.size(), static_cast<double>(corpus.size()) / 1e6);
+
+    for (const Kernel& kernel : kernels)
+    {
+        double best{ 1e30 };
+        Counts counts{ };
+        for (int repetition{ 0 }; repetition < 5; ++repetition)
+        {
+            counts = { };
+            const auto start{ std::chrono::steady_clock::now() };
+            lexWords(corpus, [&](const Token& token) {
+                counts.identifiers += token.kind == TokenKind::identifier;
+                counts.keywords += token.kind == TokenKind::keyword;
+                counts.numbers += token.kind == TokenKind::number;
+            }, kernel.kernel);
+            const std::chrono::duration<double> elapsed{ std::chrono::steady_clock::now() - start };
+            best = std::min(best, elapsed.count());
+        }
+        std::printf("%-7s %8.1f MB/s  (%zu identifiers, %zu keywords, %zu numbers)\n", kernel.name,
+                    static_cast<double>(corpus.size()) / best / 1e6, counts.identifiers, counts.keywords, counts.numbers);
+    }
+    return 0;
+}
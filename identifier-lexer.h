@@ -0,0 +1,400 @@
+#ifndef IDENTIFIER_LEXER_H
+#define IDENTIFIER_LEXER_H
+
+//** Finding every identifier in a source file, fast **//
+
+// keywords-identifiers.cpp gives the rules for identifiers: only letters, digits and underscores, not starting with
+// a digit, case sensitive, and not a keyword. lexWords() applies those rules to a whole source file and reports each
+// word it finds:
+
+//     lexWords(source, [](const Token& token) {
+//         if (token.kind == TokenKind::identifier)
+//             ...
+//     });
+
+// Comments, string literals (including raw strings and prefixes like u8"...") and character literals are skipped,
+// so words inside them aren't reported. Numbers (anything starting with a digit, like 42, 0x1F or 1'000'000) are
+// reported as TokenKind::number, never as identifiers.
+
+// Most bytes of a source file are either part of a word or a space or punctuation between words. The block kernels
+// classify 64 bytes at a time with vector table lookups (pshufb: each byte's low and high 4 bits index two 16-entry
+// tables, and ANDing the results gives the byte's class). That turns a block into two 64-bit masks: bytes that can be
+// part of a word, and bytes that start a comment or literal. Word boundaries then fall out of a few bit operations.
+// Only the comments and literals themselves, and numbers, are walked byte by byte. Each word found is checked
+// against the keyword table from keywords.h.
+
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <string_view>
+
+#include "keywords.h"
+
+#if defined(__x86_64__) || defined(_M_X64)
+#define IDENTIFIER_LEXER_X86 1
+#include <immintrin.h>
+#endif
+
+enum class TokenKind
+{
+    identifier,
+    keyword,
+    contextualKeyword,
+    number,
+};
+
+struct Token
+{
+    std::string_view text{ };
+    std::size_t offset{ }; // from the start of the source
+    TokenKind kind{ };
+};
+
+// The naming rules from keywords-identifiers.cpp, for a single word.
+constexpr bool isValidIdentifier(std::string_view word)
+{
+    if (word.empty() || (word[0] >= '0' && word[0] <= '9'))
+        return false;
+    for (const char c : word)
+    {
+        const bool letter{ (c >= 'a' && c <= 'z') || (c >= 'A' && c <= 'Z') };
+        if (!letter && !(c >= '0' && c <= '9') && c != '_')
+            return false;
+    }
+    return classifyWord(word) != WordKind::keyword;
+}
+
+namespace identifierLexerDetail
+{
+    inline bool isWordChar(char c)
+    {
+        return (c >= 'a' && c <= 'z') || (c >= 'A' && c <= 'Z') || (c >= '0' && c <= '9') || c == '_';
+    }
+
+    inline bool isDigit(char c) { return c >= '0' && c <= '9'; }
+
+    inline TokenKind kindOfWord(std::string_view word)
+    {
+        switch (classifyWord(word))
+        {
+        case WordKind::keyword:
+            return TokenKind::keyword;
+        case WordKind::contextualKeyword:
+            return TokenKind::contextualKeyword;
+        default:
+            return TokenKind::identifier;
+        }
+    }
+
+    inline bool isEncodingPrefix(std::string_view word)
+    {
+        return word == "u8" || word == "u" || word == "U" || word == "L";
+    }
+
+    inline bool isRawPrefix(std::string_view word)
+    {
+        return word == "R" || word == "u8R" || word == "uR" || word == "UR" || word == "LR";
+    }
+
+    // A pp-number: digits, letters, underscores, dots, digit separators, and a sign after an exponent.
+    inline std::size_t skipNumber(std::string_view source, std::size_t position)
+    {
+        ++position;
+        while (position < source.size())
+        {
+            const char c{ source[position] };
+            const char previous{ source[position - 1] };
+            const bool exponentSign{ (c == '+' || c == '-')
+                                     && (previous == 'e' || previous == 'E' || previous == 'p' || previous == 'P') };
+            const bool separator{ c == '\'' && position + 1 < source.size() && isWordChar(source[position + 1]) };
+            if (!isWordChar(c) && c != '.' && !exponentSign && !separator)
+                break;
+            ++position;
+        }
+        return position;
+    }
+
+    // A quoted literal starting at the quote; ends after the closing quote or at the end of the line.
+    inline std::size_t skipQuoted(std::string_view source, std::size_t position)
+    {
+        const char quote{ source[position++] };
+        while (position < source.size())
+        {
+            const char c{ source[position++] };
+            if (c == '\\' && position < source.size())
+                ++position;
+            else if (c == quote || c == '\n')
+                break;
+        }
+        return position;
+    }
+
+    // R"delimiter( ... )delimiter", starting at the opening quote.
+    inline std::size_t skipRawString(std::string_view source, std::size_t position)
+    {
+        const std::size_t open{ source.find('(', position) };
+        if (open == std::string_view::npos)
+            return source.size();
+        const std::string_view delimiter{ source.substr(position + 1, open - position - 1) };
+
+        for (std::size_t close{ source.find(')', open) }; close != std::string_view::npos; close = source.find(')', close + 1))
+        {
+            const std::size_t quote{ close + 1 + delimiter.size() };
+            if (quote < source.size() && source[quote] == '"' && source.substr(close + 1, delimiter.size()) == delimiter)
+                return quote + 1;
+        }
+        return source.size();
+    }
+
+    // Lex one unit starting at position (a word, a number, a comment, a literal, or a single other character) and
+    // return where the next one starts. This is the reference implementation; the block kernels only skip ahead of
+    // it when the answer is obvious.
+    template <typename Callback>
+    std::size_t lexAt(std::string_view source, std::size_t position, Callback& onToken)
+    {
+        const char c{ source[position] };
+
+        if (isDigit(c))
+        {
+            const std::size_t end{ skipNumber(source, position) };
+            onToken(Token{ source.substr(position, end - position), position, TokenKind::number });
+            return end;
+        }
+
+        if (isWordChar(c))
+        {
+            std::size_t end{ position + 1 };
+            while (end < source.size() && isWordChar(source[end]))
+                ++end;
+            const std::string_view word{ source.substr(position, end - position) };
+
+            if (end < source.size() && (source[end] == '"' || source[end] == '\''))
+            {
+                if (isEncodingPrefix(word))
+                    return end; // the literal itself is skipped next
+                if (source[end] == '"' && isRawPrefix(word))
+                    return skipRawString(source, end);
+            }
+
+            onToken(Token{ word, position, kindOfWord(word) });
+            return end;
+        }
+
+        if (c == '"' || c == '\'')
+            return skipQuoted(source, position);
+
+        if (c == '/' && position + 1 < source.size())
+        {
+            if (source[position + 1] == '/')
+            {
+                const std::size_t newline{ source.find('\n', position) };
+                return newline == std::string_view::npos ? source.size() : newline + 1;
+            }
+            if (source[position + 1] == '*')
+            {
+                const std::size_t close{ source.find("*/", position + 2) };
+                return close == std::string_view::npos ? source.size() : close + 2;
+            }
+        }
+
+        return position + 1;
+    }
+
+    struct BlockMasks
+    {
+        std::uint64_t word{ };    // letters, digits, underscore
+        std::uint64_t special{ }; // '"', '\'' and '/': may start a literal or comment
+    };
+
+    // Nibble tables for the byte classes. A byte's class is lowNibble[byte & 15] & highNibble[byte >> 4]:
+    //     1: letters 0x41-0x4F and 0x61-0x6F      2: letters 0x50-0x5A and 0x70-0x7A
+    //     4: digits 0x30-0x39                      8: underscore 0x5F
+    //    16: '"' 0x22, '\'' 0x27, '/' 0x2F
+    alignas(16) inline constexpr std::uint8_t lowNibble[16]{
+        2 | 4, 1 | 2 | 4, 1 | 2 | 4 | 16, 1 | 2 | 4, 1 | 2 | 4, 1 | 2 | 4, 1 | 2 | 4, 1 | 2 | 4 | 16,
+        1 | 2 | 4, 1 | 2 | 4, 1 | 2, 1, 1, 1, 1, 1 | 8 | 16,
+    };
+    alignas(16) inline constexpr std::uint8_t highNibble[16]{ 0, 0, 16, 4, 1, 2 | 8, 1, 2, 0, 0, 0, 0, 0, 0, 0, 0 };
+    constexpr std::uint8_t wordClasses{ 1 | 2 | 4 | 8 };
+    constexpr std::uint8_t specialClass{ 16 };
+
+    // The shared block walker. Classify::masks(p) returns the masks for the 64 bytes at p.
+    template <typename Classify, typename Callback>
+    [[gnu::always_inline]] inline void lexBlocks(std::string_view source, Callback& onToken)
+    {
+        const char* data{ source.data() };
+        std::size_t position{ 0 };
+
+        // Every window starts on a word boundary: its first byte is not the middle of a word.
+        while (source.size() - position >= 64)
+        {
+            const BlockMasks masks{ Classify::masks(data + position) };
+            const int firstSpecial{ masks.special ? __builtin_ctzll(masks.special) : 64 };
+
+            std::uint64_t starts{ masks.word & ~(masks.word << 1) };
+            std::size_t next{ position + 64 };
+            bool handedOff{ false }; // lexAt took over at or before the first special byte
+            while (starts != 0)
+            {
+                const int start{ __builtin_ctzll(starts) };
+                if (start >= firstSpecial)
+                    break;
+                starts &= starts - 1;
+
+                const std::uint64_t notWord{ (~masks.word) >> start };
+                if (notWord == 0 || isDigit(data[position + start]))
+                {
+                    // A word running into the next window, or a number: let lexAt handle it from its start.
+                    next = (notWord == 0 && start != 0) ? position + start : lexAt(source, position + start, onToken);
+                    handedOff = true;
+                    break;
+                }
+
+                const int length{ __builtin_ctzll(notWord) };
+                if (start + length == firstSpecial && data[position + firstSpecial] != '/')
+                {
+                    // A word right before a quote may be a literal prefix (u8"...", R"(...)").
+                    next = lexAt(source, position + start, onToken);
+                    handedOff = true;
+                    break;
+                }
+
+                const std::string_view word{ data + position + start, static_cast<std::size_t>(length) };
+                onToken(Token{ word, position + start, kindOfWord(word) });
+            }
+
+            if (!handedOff && firstSpecial < 64)
+            {
+                // Every word before the special byte is done; skip the comment or literal it starts.
+                next = lexAt(source, position + firstSpecial, onToken);
+            }
+            position = next;
+        }
+
+        while (position < source.size())
+            position = lexAt(source, position, onToken);
+    }
+
+#ifdef IDENTIFIER_LEXER_X86
+    struct Ssse3Classify
+    {
+        [[gnu::target("ssse3")]] static BlockMasks masks(const char* p)
+        {
+            const __m128i low{ _mm_load_si128(reinterpret_cast<const __m128i*>(lowNibble)) };
+            const __m128i high{ _mm_load_si128(reinterpret_cast<const __m128i*>(highNibble)) };
+            const __m128i nibbleMask{ _mm_set1_epi8(0x0F) };
+            const __m128i zero{ _mm_setzero_si128() };
+
+            BlockMasks result{ };
+            for (int i{ 0 }; i < 4; ++i)
+            {
+                const __m128i bytes{ _mm_loadu_si128(reinterpret_cast<const __m128i*>(p + 16 * i)) };
+                const __m128i classes{ _mm_and_si128(
+                    _mm_shuffle_epi8(low, _mm_and_si128(bytes, nibbleMask)),
+                    _mm_shuffle_epi8(high, _mm_and_si128(_mm_srli_epi16(bytes, 4), nibbleMask))) };
+
+                const __m128i word{ _mm_cmpeq_epi8(_mm_and_si128(classes, _mm_set1_epi8(wordClasses)), zero) };
+                const __m128i special{ _mm_cmpeq_epi8(_mm_and_si128(classes, _mm_set1_epi8(specialClass)), zero) };
+                result.word |= static_cast<std::uint64_t>(static_cast<std::uint16_t>(~_mm_movemask_epi8(word))) << (16 * i);
+                result.special |= static_cast<std::uint64_t>(static_cast<std::uint16_t>(~_mm_movemask_epi8(special))) << (16 * i);
+            }
+            return result;
+        }
+    };
+
+    struct Avx2Classify
+    {
+        [[gnu::target("avx2")]] static BlockMasks masks(const char* p)
+        {
+            const __m256i low{ _mm256_broadcastsi128_si256(_mm_load_si128(reinterpret_cast<const __m128i*>(lowNibble))) };
+            const __m256i high{ _mm256_broadcastsi128_si256(_mm_load_si128(reinterpret_cast<const __m128i*>(highNibble))) };
+            const __m256i nibbleMask{ _mm256_set1_epi8(0x0F) };
+            const __m256i zero{ _mm256_setzero_si256() };
+
+            BlockMasks result{ };
+            for (int i{ 0 }; i < 2; ++i)
+            {
+                const __m256i bytes{ _mm256_loadu_si256(reinterpret_cast<const __m256i*>(p + 32 * i)) };
+                const __m256i classes{ _mm256_and_si256(
+                    _mm256_shuffle_epi8(low, _mm256_and_si256(bytes, nibbleMask)),
+                    _mm256_shuffle_epi8(high, _mm256_and_si256(_mm256_srli_epi16(bytes, 4), nibbleMask))) };
+
+                const __m256i word{ _mm256_cmpeq_epi8(_mm256_and_si256(classes, _mm256_set1_epi8(wordClasses)), zero) };
+                const __m256i special{ _mm256_cmpeq_epi8(_mm256_and_si256(classes, _mm256_set1_epi8(specialClass)), zero) };
+                result.word |= static_cast<std::uint64_t>(~static_cast<std::uint32_t>(_mm256_movemask_epi8(word))) << (32 * i);
+                result.special |= static_cast<std::uint64_t>(~static_cast<std::uint32_t>(_mm256_movemask_epi8(special))) << (32 * i);
+            }
+            return result;
+        }
+    };
+#endif
+
+    template <typename Callback>
+    void lexScalar(std::string_view source, Callback& onToken)
+    {
+        for (std::size_t position{ 0 }; position < source.size();)
+            position = lexAt(source, position, onToken);
+    }
+
+#ifdef IDENTIFIER_LEXER_X86
+    template <typename Callback>
+    [[gnu::target("ssse3")]] void lexSsse3(std::string_view source, Callback& onToken)
+    {
+        lexBlocks<Ssse3Classify>(source, onToken);
+    }
+
+    template <typename Callback>
+    [[gnu::target("avx2")]] void lexAvx2(std::string_view source, Callback& onToken)
+    {
+        lexBlocks<Avx2Classify>(source, onToken);
+    }
+#endif
+}
+
+enum class LexerKernel
+{
+    best,
+    scalar,
+    ssse3,
+    avx2,
+};
+
+// The fastest kernel the running CPU supports.
+inline LexerKernel bestLexerKernel()
+{
+    static const LexerKernel best{ [] {
+#ifdef IDENTIFIER_LEXER_X86
+        __builtin_cpu_init();
+        if (__builtin_cpu_supports("avx2"))
+            return LexerKernel::avx2;
+        if (__builtin_cpu_supports("ssse3"))
+            return LexerKernel::ssse3;
+#endif
+        return LexerKernel::scalar;
+    }() };
+    return best;
+}
+
+// Call onToken(const Token&) for every identifier, keyword and number in source, in order.
+template <typename Callback>
+void lexWords(std::string_view source, Callback&& onToken, LexerKernel kernel = LexerKernel::best)
+{
+    using namespace identifierLexerDetail;
+
+    switch (kernel == LexerKernel::best ? bestLexerKernel() : kernel)
+    {
+#ifdef IDENTIFIER_LEXER_X86
+    case LexerKernel::avx2:
+        lexAvx2(source, onToken);
+        return;
+    case LexerKernel::ssse3:
+        lexSsse3(source, onToken);
+        return;
+#endif
+    default:
+        lexScalar(source, onToken);
+        return;
+    }
+}
+
+#endif
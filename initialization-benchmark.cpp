@@ -0,0 +1,447 @@
+//** Benchmark: what each form of initialization costs **//
+
+// Build and run (try -O0 as well, to see which differences the optimizer removes):
+//     g++ -std=c++20 -O2 initialization-benchmark.cpp -o initialization-benchmark
+//     ./initialization-benchmark [largest working set in MB, default 64] [repetitions, default 5]
+
+// assignment-initilization.cpp lists the ways to give a variable its first value. This times each of them in a
+// loop that makes a local variable from an input element and moves it into an output element, two elements per
+// iteration for every form so that only the declarations differ:
+    // assigned later      T value;  value = in[i];        (defined with no initializer, assigned afterwards)
+    // copy                T value = in[i];
+    // direct              T value( in[i] );
+    // direct list         T value{ in[i] };
+    // copy list           T value = { in[i] };
+    // value, assigned     T value{ };  value = in[i];     (value initialized, then overwritten)
+    // two per definition  T a = in[i], b = in[i + 1];     (multiple variables in one statement)
+// for int, double, a 256-byte aggregate, std::array<int, 64>, and std::string (short enough to be stored inline,
+// and long enough to need the heap). Each type is run with working sets (input plus output) of 32 KB, which fits in
+// L1, 2 MB, which fits in L2 or L3, and the given largest size, which doesn't.
+
+// For each form the table shows time per element, and, where the kernel allows it (perf_event_open, see
+// /proc/sys/kernel/perf_event_paranoid), cycles, instructions and L1 data cache misses per element from the run
+// that was fastest. The last column is the size of the form's machine code, read from this program's own symbol
+// table. Every form is its own function, kept apart from the others (gnu::noipa), so the compiler can't merge
+// identical ones.
+
+#include <algorithm>
+#include <array>
+#include <chrono>
+#include <cstdint>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <elf.h>
+#include <fcntl.h>
+#include <linux/perf_event.h>
+#include <string>
+#include <string_view>
+#include <sys/auxv.h>
+#include <sys/ioctl.h>
+#include <sys/syscall.h>
+#include <type_traits>
+#include <unistd.h>
+#include <utility>
+#include <vector>
+
+#include "mapped-input.h"
+
+enum class InitForm
+{
+    assignedLater,
+    copy,
+    direct,
+    directList,
+    copyList,
+    valueThenAssigned,
+    twoPerDefinition,
+};
+
+constexpr InitForm allForms[]{ InitForm::assignedLater, InitForm::copy,
+                               InitForm::direct,        InitForm::directList,
+                               InitForm::copyList,      InitForm::valueThenAssigned,
+                               InitForm::twoPerDefinition };
+
+const char* formName(InitForm form)
+{
+    switch (form)
+    {
+    case InitForm::assignedLater: return "assigned later";
+    case InitForm::copy: return "copy";
+    case InitForm::direct: return "direct";
+    case InitForm::directList: return "direct list";
+    case InitForm::copyList: return "copy list";
+    case InitForm::valueThenAssigned: return "value, assigned";
+    case InitForm::twoPerDefinition: return "two per definition";
+    }
+    return "?";
+}
+
+// A large aggregate: no constructors, mixed members, 256 bytes.
+struct Aggregate
+{
+    int counts[32];
+    double weights[14];
+    std::int64_t id;
+    std::int64_t flags;
+};
+static_assert(sizeof(Aggregate) == 256);
+
+bool operator==(const Aggregate& a, const Aggregate& b) { return std::memcmp(&a, &b, sizeof(a)) == 0; }
+
+// One element in one form, from in to out.
+template <typename T, InitForm form>
+[[gnu::always_inline]] inline void initializeOne(const T& in, T& out)
+{
+    if constexpr (form == InitForm::assignedLater)
+    {
+        T value;
+        value = in;
+        out = std::move(value);
+    }
+    else if constexpr (form == InitForm::copy || form == InitForm::twoPerDefinition)
+    {
+        T value = in;
+        out = std::move(value);
+    }
+    else if constexpr (form == InitForm::direct)
+    {
+        T value( in );
+        out = std::move(value);
+    }
+    else if constexpr (form == InitForm::directList)
+    {
+        T value{ in };
+        out = std::move(value);
+    }
+    else if constexpr (form == InitForm::copyList)
+    {
+        T value = { in };
+        out = std::move(value);
+    }
+    else if constexpr (form == InitForm::valueThenAssigned)
+    {
+        T value{ };
+        value = in;
+        out = std::move(value);
+    }
+}
+
+// Every form goes through the same loop, two elements per iteration, so only the declarations differ: with a loop
+// of its own, two per definition was the only form GCC didn't turn into a memcpy call for int and double.
+template <typename T, InitForm form>
+[[gnu::noipa]] void initializeAll(const T* __restrict in, T* __restrict out, std::size_t count)
+{
+    std::size_t i{ 0 };
+    for (; i + 1 < count; i += 2)
+    {
+        if constexpr (form == InitForm::twoPerDefinition)
+        {
+            T a = in[i], b = in[i + 1];
+            out[i] = std::move(a);
+            out[i + 1] = std::move(b);
+        }
+        else
+        {
+            initializeOne<T, form>(in[i], out[i]);
+            initializeOne<T, form>(in[i + 1], out[i + 1]);
+        }
+    }
+    if (i < count)
+        initializeOne<T, form>(in[i], out[i]);
+}
+
+using Kernel = void (*)(const void*, void*, std::size_t);
+
+template <typename T, InitForm form>
+void runKernel(const void* in, void* out, std::size_t count)
+{
+    initializeAll<T, form>(static_cast<const T*>(in), static_cast<T*>(out), count);
+}
+
+//** Code size, from the ELF symbol table of /proc/self/exe **//
+
+class SymbolSizes
+{
+public:
+    SymbolSizes()
+        : m_file{ "/proc/self/exe" }
+    {
+        const std::string_view image{ m_file.text() };
+        if (!m_file || image.size() < sizeof(Elf64_Ehdr) || std::memcmp(image.data(), ELFMAG, SELFMAG) != 0
+            || image[EI_CLASS] != ELFCLASS64)
+        {
+            return;
+        }
+        Elf64_Ehdr header{ };
+        std::memcpy(&header, image.data(), sizeof(header));
+
+        // Symbol values are link-time addresses, and a position-independent executable is loaded somewhere else.
+        // The program headers' link-time address against where they are now gives the difference.
+        bool foundProgramHeaders{ false };
+        for (unsigned i{ 0 }; i < header.e_phnum; ++i)
+        {
+            Elf64_Phdr segment{ };
+            std::memcpy(&segment, image.data() + header.e_phoff + i * sizeof(segment), sizeof(segment));
+            if (segment.p_type == PT_PHDR)
+            {
+                m_loadOffset = ::getauxval(AT_PHDR) - segment.p_vaddr;
+                foundProgramHeaders = true;
+            }
+        }
+        if (!foundProgramHeaders)
+            return;
+
+        for (unsigned i{ 0 }; i < header.e_shnum; ++i)
+        {
+            Elf64_Shdr section{ };
+            std::memcpy(&section, image.data() + header.e_shoff + i * sizeof(section), sizeof(section));
+            if (section.sh_type != SHT_SYMTAB)
+                continue;
+            for (std::size_t offset{ 0 }; offset + sizeof(Elf64_Sym) <= section.sh_size; offset += sizeof(Elf64_Sym))
+            {
+                Elf64_Sym symbol{ };
+                std::memcpy(&symbol, image.data() + section.sh_offset + offset, sizeof(symbol));
+                if (ELF64_ST_TYPE(symbol.st_info) != STT_FUNC || symbol.st_value == 0)
+                    continue;
+                m_functions.push_back({ symbol.st_value, symbol.st_size });
+            }
+        }
+    }
+
+    // The size in bytes of the function at address, or 0 if it can't be found (a stripped executable, say).
+    std::size_t sizeOf(const void* function) const
+    {
+        const std::uintptr_t address{ reinterpret_cast<std::uintptr_t>(function) - m_loadOffset };
+        for (const auto& [start, size] : m_functions)
+        {
+            if (start == address)
+                return size;
+        }
+        return 0;
+    }
+
+private:
+    MappedInput m_file;
+    std::vector<std::pair<std::uintptr_t, std::size_t>> m_functions{ };
+    std::uintptr_t m_loadOffset{ 0 };
+};
+
+//** Hardware counters, where perf_event_open is allowed **//
+
+struct CounterReadings
+{
+    std::uint64_t cycles{ 0 };
+    std::uint64_t instructions{ 0 };
+    std::uint64_t l1Misses{ 0 };
+};
+
+class PerfCounters
+{
+public:
+    PerfCounters()
+    {
+        m_leader = open(PERF_TYPE_HARDWARE, PERF_COUNT_HW_CPU_CYCLES, -1);
+        if (m_leader < 0)
+            return;
+        m_instructions = open(PERF_TYPE_HARDWARE, PERF_COUNT_HW_INSTRUCTIONS, m_leader);
+        m_l1Misses = open(PERF_TYPE_HW_CACHE,
+                          PERF_COUNT_HW_CACHE_L1D | (PERF_COUNT_HW_CACHE_OP_READ << 8)
+                              | (PERF_COUNT_HW_CACHE_RESULT_MISS << 16),
+                          m_leader);
+    }
+
+    PerfCounters(const PerfCounters&) = delete;
+    PerfCounters& operator=(const PerfCounters&) = delete;
+
+    ~PerfCounters()
+    {
+        for (const int fd : { m_l1Misses, m_instructions, m_leader })
+        {
+            if (fd >= 0)
+                ::close(fd);
+        }
+    }
+
+    bool available() const { return m_leader >= 0; }
+
+    void start()
+    {
+        if (!available())
+            return;
+        ::ioctl(m_leader, PERF_EVENT_IOC_RESET, PERF_IOC_FLAG_GROUP);
+        ::ioctl(m_leader, PERF_EVENT_IOC_ENABLE, PERF_IOC_FLAG_GROUP);
+    }
+
+    CounterReadings stop()
+    {
+        CounterReadings readings{ };
+        if (!available())
+            return readings;
+        ::ioctl(m_leader, PERF_EVENT_IOC_DISABLE, PERF_IOC_FLAG_GROUP);
+
+        // PERF_FORMAT_GROUP: the number of counters, then their values in the order they were opened.
+        std::uint64_t values[4]{ };
+        if (::read(m_leader, values, sizeof(values)) < static_cast<ssize_t>(2 * sizeof(std::uint64_t)))
+            return readings;
+        std::uint64_t* next{ values + 1 };
+        readings.cycles = *next++;
+        if (m_instructions >= 0)
+            readings.instructions = *next++;
+        if (m_l1Misses >= 0)
+            readings.l1Misses = *next++;
+        return readings;
+    }
+
+    bool countsInstructions() const { return m_instructions >= 0; }
+    bool countsL1Misses() const { return m_l1Misses >= 0; }
+
+private:
+    static int open(std::uint32_t type, std::uint64_t config, int groupLeader)
+    {
+        perf_event_attr attributes{ };
+        attributes.size = sizeof(attributes);
+        attributes.type = type;
+        attributes.config = config;
+        attributes.disabled = groupLeader < 0;
+        attributes.exclude_kernel = 1; // allowed at perf_event_paranoid 2, and page faults aren't what's measured
+        attributes.exclude_hv = 1;
+        attributes.read_format = PERF_FORMAT_GROUP;
+        return static_cast<int>(::syscall(SYS_perf_event_open, &attributes, 0, -1, groupLeader, PERF_FLAG_FD_CLOEXEC));
+    }
+
+    int m_leader{ -1 };
+    int m_instructions{ -1 };
+    int m_l1Misses{ -1 };
+};
+
+//** The benchmark **//
+
+std::size_t benchmarkSink{ };
+
+// A value of type T that depends on index, so the input isn't one repeated value.
+template <typename T>
+T sampleValue(std::size_t index, std::size_t stringLength)
+{
+    if constexpr (std::is_same_v<T, std::string>)
+    {
+        std::string text(stringLength, 'a');
+        text[index % stringLength] = static_cast<char>('a' + index % 26);
+        return text;
+    }
+    else if constexpr (std::is_same_v<T, Aggregate>)
+    {
+        Aggregate value{ };
+        value.counts[index % 32] = static_cast<int>(index);
+        value.id = static_cast<std::int64_t>(index);
+        return value;
+    }
+    else if constexpr (std::is_same_v<T, std::array<int, 64>>)
+    {
+        std::array<int, 64> value{ };
+        value[index % 64] = static_cast<int>(index);
+        return value;
+    }
+    else
+    {
+        return static_cast<T>(index * 2654435761u % 1000003);
+    }
+}
+
+template <typename T>
+std::size_t bytesPerElement(std::size_t stringLength)
+{
+    if constexpr (std::is_same_v<T, std::string>)
+        return sizeof(T) + (stringLength > 15 ? stringLength + 1 : 0);
+    else
+        return sizeof(T);
+}
+
+template <typename T, std::size_t... index>
+std::array<Kernel, sizeof...(index)> kernelsFor(std::index_sequence<index...>)
+{
+    return { &runKernel<T, allForms[index]>... };
+}
+
+template <typename T, std::size_t... index>
+std::array<const void*, sizeof...(index)> functionsFor(std::index_sequence<index...>)
+{
+    return { reinterpret_cast<const void*>(&initializeAll<T, allForms[index]>)... };
+}
+
+template <typename T>
+void benchmarkType(const char* typeName, std::size_t stringLength, double largestMegabytes, int repetitions,
+                   const SymbolSizes& symbols, PerfCounters& counters)
+{
+    constexpr auto forms{ std::make_index_sequence<std::size(allForms)>{ } };
+    const auto kernels{ kernelsFor<T>(forms) };
+    const auto functions{ functionsFor<T>(forms) };
+
+    const double workingSets[]{ 32.0 / 1024, 2, largestMegabytes };
+    for (const double megabytes : workingSets)
+    {
+        const std::size_t count{ std::max<std::size_t>(
+            static_cast<std::size_t>(megabytes * 1024 * 1024 / (2 * bytesPerElement<T>(stringLength))), 2) };
+        std::vector<T> in(count);
+        for (std::size_t i{ 0 }; i < count; ++i)
+            in[i] = sampleValue<T>(i, stringLength);
+        std::vector<T> out(in); // already the right shape, so strings in it keep their heap buffers between runs
+        kernels[0](in.data(), out.data(), count); // warm up, so the first form isn't charged for it
+
+        std::printf("\n%s, %zu elements (%.3g MB working set)\n", typeName, count, megabytes);
+        std::printf("  %-20s %10s %10s %10s %10s %10s\n", "form", "ns/elem", "cycles", "instrs", "L1 misses",
+                    "code bytes");
+        for (std::size_t form{ 0 }; form < kernels.size(); ++form)
+        {
+            double best{ 1e30 };
+            CounterReadings bestReadings{ };
+            for (int repetition{ 0 }; repetition < repetitions; ++repetition)
+            {
+                counters.start();
+                const auto start{ std::chrono::steady_clock::now() };
+                kernels[form](in.data(), out.data(), count);
+                const std::chrono::duration<double> elapsed{ std::chrono::steady_clock::now() - start };
+                const CounterReadings readings{ counters.stop() };
+                if (elapsed.count() < best)
+                {
+                    best = elapsed.count();
+                    bestReadings = readings;
+                }
+            }
+            benchmarkSink += sizeof(out[count / 2]) + (out[count / 2] == in[count / 2]);
+
+            char cycles[16]{ "-" };
+            char instructions[16]{ "-" };
+            char l1Misses[16]{ "-" };
+            const double elements{ static_cast<double>(count) };
+            if (counters.available())
+                std::snprintf(cycles, sizeof(cycles), "%.2f", bestReadings.cycles / elements);
+            if (counters.countsInstructions())
+                std::snprintf(instructions, sizeof(instructions), "%.2f", bestReadings.instructions / elements);
+            if (counters.countsL1Misses())
+                std::snprintf(l1Misses, sizeof(l1Misses), "%.3f", bestReadings.l1Misses / elements);
+            std::printf("  %-20s %10.3f %10s %10s %10s %10zu\n", formName(allForms[form]), best * 1e9 / elements,
+                        cycles, instructions, l1Misses, symbols.sizeOf(functions[form]));
+        }
+    }
+}
+
+int main(int argc, char* argv[])
+{
+    const double largestMegabytes{ argc > 1 ? std::atof(argv[1]) : 64 };
+    const int repetitions{ argc > 2 ? std::max(1, std::atoi(argv[2])) : 5 };
+
+    const SymbolSizes symbols{ };
+    PerfCounters counters{ };
+    if (!counters.available())
+        std::printf("note: perf_event_open isn't allowed here, so there are no hardware counts (times only)\n");
+
+    benchmarkType<int>("int", 0, largestMegabytes, repetitions, symbols, counters);
+    benchmarkType<double>("double", 0, largestMegabytes, repetitions, symbols, counters);
+    benchmarkType<Aggregate>("256-byte aggregate", 0, largestMegabytes, repetitions, symbols, counters);
+    benchmarkType<std::array<int, 64>>("std::array<int, 64>", 0, largestMegabytes, repetitions, symbols, counters);
+    benchmarkType<std::string>("std::string, 7 chars", 7, largestMegabytes, repetitions, symbols, counters);
+    benchmarkType<std::string>("std::string, 40 chars", 40, largestMegabytes, repetitions, symbols, counters);
+
+    return benchmarkSink == 0 ? 1 : 0;
+}
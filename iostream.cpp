@@ -203,6 +203,99 @@ int main()
 // via another source (e.g. std::cin), since the user-provided value will just overwrite the initialization value. 
 // In line with our previous recommendation that variables should always be initialized, best practice is to initialize the variable first.
 
+//** Reading lots of numbers quickly **//
+
+// std::cin is convenient, but each extraction does a fair amount of work behind the scenes (locale-aware parsing,
+// a sentry object, syncing with C stdio). When a program reads millions of numbers, that overhead adds up.
+// fast-input.h provides FastReader, which reads input in large blocks and parses integers by hand. It produces the
+// same values as std::cin (including 5-6 being read as 5 and -6), so the program above can switch to it by changing
+// only the line that does the reading:
+
+#include <iostream>
+#include "fast-input.h" // for FastReader
+
+int main()
+{
+    std::cout << "Enter two numbers separated by a space: " << std::flush;
+
+    FastReader input{ }; // reads from standard input
+    int x{ };
+    int y{ };
+    input >> x >> y; // same as std::cin >> x >> y, just cheaper per number
+
+    std::cout << "You entered " << x << " and " << y << '\n';
+
+    return 0;
+}
+
+// The same is true of output. fast-output.h provides FastWriter, which formats numbers into a large buffer and
+// only hands the buffer to the operating system when it fills up (or after every line, when writing to a console):
+
+#include "fast-input.h"  // for FastReader
+#include "fast-output.h" // for FastWriter
+
+int main()
+{
+    FastReader input{ };
+    FastWriter output{ }; // flushes after each '\n' at a console, only when full when redirected to a file
+
+    int x{ };
+    while (input >> x)
+        output << "x is equal to: " << x << '\n';
+
+    return 0; // output's destructor writes out whatever is still buffered
+}
+
+// pipelined-pairs.cpp takes this one step further for the two-number program: it reads, parses and prints a
+// continuous stream of pairs on three threads, so waiting for input overlaps with the work on earlier numbers.
+
+// A loop that reads every number until the input runs out doesn't need to spell out the reading at all.
+// number-stream.h provides numbers(), a range of the ints in a stream, read and parsed only as the loop gets to them
+// (so an endless input is fine too):
+
+#include <iostream>
+#include "number-stream.h" // for numbers()
+
+int main()
+{
+    std::ios::sync_with_stdio(false); // lets numbers() take std::cin's input a buffer at a time
+
+    long long sum{ 0 };
+    for (int x : numbers(std::cin)) // stops where while (std::cin >> x) would
+        sum += x;
+
+    std::cout << "The numbers add up to " << sum << '\n';
+
+    return 0;
+}
+
+// A sum is usually only the start. stream-aggregate.h provides StreamAggregator, which works out the sum, smallest
+// and largest, mean, variance and a histogram in the same single pass, keeping only a few thousand numbers at a time:
+
+#include <iostream>
+#include "number-stream.h"    // for numbers()
+#include "stream-aggregate.h" // for StreamAggregator
+
+int main()
+{
+    std::ios::sync_with_stdio(false);
+
+    StreamAggregator<int> summary{ { 0, 100, 10 } }; // also count the numbers in 10 buckets: 0-9, 10-19, ... 90-99
+    for (int x : numbers(std::cin))
+        summary.add(x);
+
+    const Aggregate<int> result{ summary.result() };
+    std::cout << result.count << " numbers, from " << result.min << " to " << result.max << ", mean " << result.mean
+              << ", variance " << result.variance << '\n';
+    for (std::size_t bucket{ 0 }; bucket < result.histogram.size(); ++bucket)
+        std::cout << bucket * 10 << "-" << bucket * 10 + 9 << ": " << result.histogram[bucket] << '\n';
+
+    return 0;
+}
+
+// (min and max mean nothing if there were no numbers at all: check result.count first.) For numbers already in
+// memory, aggregate() in the same header splits the work across the threads of a ThreadPool and gives the same result.
+
 //** Advanced **//
 
 // The C++ io library does not provide a way to accept keyboard input without the use having to press enter. If this is something you desire,
@@ -0,0 +1,114 @@
+//** Benchmark: keyword lookup **//
+
+// Build and run:
+//     g++ -std=c++20 -O2 keywords-benchmark.cpp -o keywords-benchmark
+//     ./keywords-benchmark [words, default 10000000]
+
+// Compares isKeyword() from keywords.h (compile-time perfect hash) with the two usual alternatives: a
+// std::unordered_set<std::string> (with heterogeneous lookup, so a std::string_view doesn't have to be copied into
+// a std::string for each query) and a binary search through a sorted array. The words are a mix of keywords and
+// ordinary identifiers, roughly like the words in real source code. All three must agree on every word.
+
+#include <algorithm>
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <functional>
+#include <random>
+#include <string>
+#include <string_view>
+#include <unordered_set>
+#include <vector>
+
+#include "keywords.h"
+
+struct StringHash
+{
+    using is_transparent = void;
+    std::size_t operator()(std::string_view text) const { return std::hash<std::string_view>{ }(text); }
+};
+
+std::vector<std::string> makeWords(std::size_t count)
+{
+    const std::string_view identifiers[]{
+        "x", "y", "width", "numberOfChars", "value", "i", "count", "std", "cout", "cin", "main", "result",
+        "doNothing", "buffer", "size", "index", "first", "last", "input", "output", "depth", "a", "b", "total",
+        "openFileOnDisk", "number_of_chars", "_reserved", "Width", "INT", "While", "data", "begin", "end",
+    };
+
+    std::mt19937 random{ 7 };
+    std::uniform_int_distribution<int> percent{ 0, 99 };
+    std::uniform_int_distribution<std::size_t> keyword{ 0, keywords.size() - 1 };
+    std::uniform_int_distribution<std::size_t> contextual{ 0, contextualKeywords.size() - 1 };
+    std::uniform_int_distribution<std::size_t> identifier{ 0, std::size(identifiers) - 1 };
+
+    std::vector<std::string> words{ };
+    words.reserve(count);
+    for (std::size_t i{ 0 }; i < count; ++i)
+    {
+        const int roll{ percent(random) };
+        if (roll < 30)
+            words.emplace_back(keywords[keyword(random)]);
+        else if (roll < 32)
+            words.emplace_back(contextualKeywords[contextual(random)]);
+        else
+            words.emplace_back(identifiers[identifier(random)]);
+    }
+    return words;
+}
+
+int main(int argc, char* argv[])
+{
+    const std::size_t count{ argc > 1 ? std::strtoull(argv[1], nullptr, 10) : 10'000'000 };
+    const std::vector<std::string> words{ makeWords(count) };
+
+    std::unordered_set<std::string, StringHash, std::equal_to<>> hashSet{ };
+    for (const std::string_view keyword : keywords)
+        hashSet.emplace(keyword);
+    std::vector<std::string_view> sorted{ keywords.begin(), keywords.end() };
+    std::sort(sorted.begin(), sorted.end());
+
+    struct Method
+    {
+        const char* name{ };
+        std::function<bool(std::string_view)> isKeyword{ };
+    };
+    const Method methods[]{
+        { "perfect hash", [](std::string_view word) { return isKeyword(word); } },
+        { "unordered_set", [&](std::string_view word) { return hashSet.find(word) != hashSet.end(); } },
+        { "binary search", [&](std::string_view word) { return std::binary_search(sorted.begin(), sorted.end(), word); } },
+    };
+
+    for (const std::string& word : words)
+    {
+        for (const Method& method : methods)
+        {
+            if (method.isKeyword(word) != isKeyword(word))
+            {
+                std::printf("MISMATCH: %s on \"%s\"\n", method.name, word.c_str());
+                return 1;
+            }
+        }
+    }
+
+    // Each method is timed through a direct call (not the std::function above) so the compiler can inline it.
+    auto timeIt{ [&](const char* name, auto&& lookup) {
+        double best{ 1e30 };
+        std::size_t found{ 0 };
+        for (int repetition{ 0 }; repetition < 5; ++repetition)
+        {
+            found = 0;
+            const auto start{ std::chrono::steady_clock::now() };
+            for (const std::string& word : words)
+                found += lookup(word) ? 1 : 0;
+            const std::chrono::duration<double> elapsed{ std::chrono::steady_clock::now() - start };
+            best = std::min(best, elapsed.count());
+        }
+        std::printf("%-14s %7.2f ns/word  (%zu keywords)\n", name, best * 1e9 / static_cast<double>(count), found);
+    } };
+
+    timeIt("perfect hash", [](std::string_view word) { return isKeyword(word); });
+    timeIt("unordered_set", [&](std::string_view word) { return hashSet.find(word) != hashSet.end(); });
+    timeIt("binary search", [&](std::string_view word) { return std::binary_search(sorted.begin(), sorted.end(), word); });
+    return 0;
+}
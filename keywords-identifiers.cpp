@@ -24,6 +24,7 @@ char8_t
 char16_t
 char32_t
 class
+compl
 concept
 const
 consteval
@@ -92,6 +93,7 @@ union
 unsigned
 using
 virtual
+void
 volatile
 wchar_t
 while
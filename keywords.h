@@ -0,0 +1,139 @@
+#ifndef KEYWORDS_H
+#define KEYWORDS_H
+
+//** Is this word a keyword? **//
+
+// keywords-identifiers.cpp lists the 92 C++20 keywords, plus the special identifiers override, final, import and
+// module, which only mean something in certain places. classifyWord() tells which of these (if any) a word is:
+
+//     classifyWord("while")         // WordKind::keyword
+//     classifyWord("override")      // WordKind::contextualKeyword
+//     classifyWord("numberOfChars") // WordKind::identifier
+//     isKeyword("while")            // true (only for the 92 reserved words)
+//     keywordIndex("while")         // 89, the position of "while" in keywords
+
+// The lookup uses a perfect hash: a hash function chosen so that no two of the 96 words land in the same slot of
+// a small table. The compiler searches for that hash function (a seed for it, really) while compiling, and builds
+// the table at the same time, so at runtime a lookup is one hash, one table read and at most one string compare,
+// with no heap allocation. Everything is constexpr, so words known at compile time are classified at compile time.
+
+#include <array>
+#include <cstddef>
+#include <cstdint>
+#include <string_view>
+
+enum class WordKind
+{
+    identifier,
+    keyword,
+    contextualKeyword,
+};
+
+inline constexpr std::array<std::string_view, 92> keywords{
+    "alignas", "alignof", "and", "and_eq", "asm", "auto", "bitand", "bitor", "bool", "break", "case", "catch",
+    "char", "char8_t", "char16_t", "char32_t", "class", "compl", "concept", "const", "consteval", "constexpr",
+    "constinit", "const_cast", "continue", "co_await", "co_return", "co_yield", "decltype", "default", "delete", "do",
+    "double", "dynamic_cast", "else", "enum", "explicit", "export", "extern", "false", "float", "for", "friend",
+    "goto", "if", "inline", "int", "long", "mutable", "namespace", "new", "noexcept", "not", "not_eq", "nullptr",
+    "operator", "or", "or_eq", "private", "protected", "public", "register", "reinterpret_cast", "requires",
+    "return", "short", "signed", "sizeof", "static", "static_assert", "static_cast", "struct", "switch", "template",
+    "this", "thread_local", "throw", "true", "try", "typedef", "typeid", "typename", "union", "unsigned", "using",
+    "virtual", "void", "volatile", "wchar_t", "while", "xor", "xor_eq",
+};
+
+inline constexpr std::array<std::string_view, 4> contextualKeywords{ "final", "import", "module", "override" };
+
+namespace keywordsDetail
+{
+    constexpr std::size_t wordCount{ keywords.size() + contextualKeywords.size() };
+    constexpr std::size_t tableSize{ 512 }; // a power of two, a bit over 5 slots per word
+    constexpr std::size_t longestWord{ 16 }; // reinterpret_cast
+    constexpr std::uint8_t emptySlot{ 0xFF };
+
+    constexpr std::string_view wordAt(std::size_t index)
+    {
+        return index < keywords.size() ? keywords[index] : contextualKeywords[index - keywords.size()];
+    }
+
+    // FNV-1a, starting from seed instead of the usual offset basis, with a final mix of the high bits into the low.
+    constexpr std::uint32_t hashWord(std::string_view word, std::uint32_t seed)
+    {
+        std::uint32_t hash{ seed };
+        for (const char c : word)
+            hash = (hash ^ static_cast<unsigned char>(c)) * 0x01000193u;
+        return hash ^ (hash >> 15);
+    }
+
+    constexpr bool isPerfect(std::uint32_t seed)
+    {
+        std::array<bool, tableSize> used{ };
+        for (std::size_t i{ 0 }; i < wordCount; ++i)
+        {
+            const std::size_t slot{ hashWord(wordAt(i), seed) & (tableSize - 1) };
+            if (used[slot])
+                return false;
+            used[slot] = true;
+        }
+        return true;
+    }
+
+    constexpr std::uint32_t findSeed()
+    {
+        std::uint32_t seed{ 1 };
+        while (!isPerfect(seed))
+            ++seed;
+        return seed;
+    }
+
+    constexpr std::uint32_t seed{ findSeed() };
+
+    constexpr std::array<std::uint8_t, tableSize> buildTable()
+    {
+        std::array<std::uint8_t, tableSize> table{ };
+        for (std::uint8_t& slot : table)
+            slot = emptySlot;
+        for (std::size_t i{ 0 }; i < wordCount; ++i)
+            table[hashWord(wordAt(i), seed) & (tableSize - 1)] = static_cast<std::uint8_t>(i);
+        return table;
+    }
+
+    inline constexpr std::array<std::uint8_t, tableSize> table{ buildTable() };
+
+    // The index of word in wordAt(), or emptySlot.
+    constexpr std::uint8_t lookup(std::string_view word)
+    {
+        if (word.size() < 2 || word.size() > longestWord)
+            return emptySlot;
+
+        const std::uint8_t index{ table[hashWord(word, seed) & (tableSize - 1)] };
+        if (index == emptySlot || wordAt(index) != word)
+            return emptySlot;
+        return index;
+    }
+}
+
+constexpr WordKind classifyWord(std::string_view word)
+{
+    const std::uint8_t index{ keywordsDetail::lookup(word) };
+    if (index == keywordsDetail::emptySlot)
+        return WordKind::identifier;
+    return index < keywords.size() ? WordKind::keyword : WordKind::contextualKeyword;
+}
+
+// The position of word in keywords, or keywords.size() if it isn't one of them.
+constexpr std::size_t keywordIndex(std::string_view word)
+{
+    const std::uint8_t index{ keywordsDetail::lookup(word) };
+    return index < keywords.size() ? index : keywords.size();
+}
+
+constexpr bool isKeyword(std::string_view word)
+{
+    return classifyWord(word) == WordKind::keyword;
+}
+
+static_assert(isKeyword("thread_local") && isKeyword("co_yield") && !isKeyword("override") && !isKeyword("x"));
+static_assert(classifyWord("final") == WordKind::contextualKeyword);
+static_assert(keywords[keywordIndex("while")] == "while" && keywordIndex("override") == keywords.size());
+
+#endif
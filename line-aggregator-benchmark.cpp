@@ -0,0 +1,226 @@
+//** Benchmark: many threads printing lines through std::cout vs LineAggregator **//
+
+// Build and run:
+//     g++ -std=c++20 -O2 -pthread line-aggregator-benchmark.cpp -o line-aggregator-benchmark
+//     ./line-aggregator-benchmark [threads, default 64] [lines per thread, default 100000] [output file]
+
+// Every thread prints "thread <t> line <i> of <lines>" for i = 0, 1, ... into the output file (by default
+// line-aggregator-benchmark.out, removed afterwards), three ways:
+    // cout          std::cout << ... << '\n' with nothing else, which is what every program here does
+    // cout + mutex  the same inside a std::lock_guard, one line at a time
+    // aggregator    LineAggregator::line() << ...
+// For std::cout the file is made the standard output for the duration of the run. Afterwards the file is read back,
+// and every line must be whole and each thread's lines in order; the lines that aren't are counted. LineAggregator
+// must not have any.
+
+// Each variant reports the time until every line was written (including the flush at the end), and the writer-side
+// latency of one line: every 16th line is timed on its own, and the median and the 99th percentile are reported,
+// along with what the timing itself adds. With more threads than cores, a thread that is preempted in the middle of
+// a line makes that line slow, whatever the variant; the median shows the cost when it isn't.
+
+#include <algorithm>
+#include <atomic>
+#include <charconv>
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <fcntl.h>
+#include <iostream>
+#include <mutex>
+#include <string>
+#include <string_view>
+#include <thread>
+#include <unistd.h>
+#include <vector>
+
+#include "line-aggregator.h"
+#include "mapped-input.h"
+
+struct Outcome
+{
+    double seconds{ };
+    std::vector<double> nanoseconds{ }; // the timed lines, sorted
+};
+
+struct Check
+{
+    std::size_t lines{ 0 };
+    std::size_t broken{ 0 };    // not a whole line as printed
+    std::size_t outOfOrder{ 0 }; // not the next line of its thread
+};
+
+// Run writeLine(thread, line) for every line on every thread, after they have all started.
+template <typename WriteLine, typename Finish>
+Outcome runThreads(int threadCount, int lineCount, WriteLine&& writeLine, Finish&& finish)
+{
+    std::atomic<int> ready{ 0 };
+    std::vector<std::vector<double>> samples(static_cast<std::size_t>(threadCount));
+    const auto start{ std::chrono::steady_clock::now() };
+    std::vector<std::thread> threads{ };
+    for (int t{ 0 }; t < threadCount; ++t)
+    {
+        threads.emplace_back([&, t] {
+            ready.fetch_add(1);
+            while (ready.load() < threadCount)
+                std::this_thread::yield();
+            std::vector<double>& mine{ samples[static_cast<std::size_t>(t)] };
+            mine.reserve(static_cast<std::size_t>(lineCount / 16 + 1));
+            for (int i{ 0 }; i < lineCount; ++i)
+            {
+                if (i % 16 != 0)
+                {
+                    writeLine(t, i);
+                    continue;
+                }
+                const auto lineStart{ std::chrono::steady_clock::now() };
+                writeLine(t, i);
+                const std::chrono::duration<double, std::nano> elapsed{ std::chrono::steady_clock::now() - lineStart };
+                mine.push_back(elapsed.count());
+            }
+        });
+    }
+    for (std::thread& thread : threads)
+        thread.join();
+    finish();
+    const std::chrono::duration<double> elapsed{ std::chrono::steady_clock::now() - start };
+
+    Outcome outcome{ elapsed.count(), { } };
+    for (const std::vector<double>& mine : samples)
+        outcome.nanoseconds.insert(outcome.nanoseconds.end(), mine.begin(), mine.end());
+    std::sort(outcome.nanoseconds.begin(), outcome.nanoseconds.end());
+    return outcome;
+}
+
+Check checkOutput(const char* path, int threadCount, int lineCount)
+{
+    Check check{ };
+    std::vector<int> expected(static_cast<std::size_t>(threadCount), 0);
+    const MappedInput input{ path };
+    std::string_view text{ input.text() };
+    const std::string tail{ " of " + std::to_string(lineCount) };
+    while (!text.empty())
+    {
+        const std::size_t end{ std::min(text.find('\n'), text.size()) };
+        std::string_view line{ text.substr(0, end) };
+        text.remove_prefix(std::min(end + 1, text.size()));
+        ++check.lines;
+
+        int thread{ -1 };
+        int index{ -1 };
+        bool whole{ line.starts_with("thread ") && line.ends_with(tail) };
+        if (whole)
+        {
+            line = line.substr(7, line.size() - 7 - tail.size());
+            const std::size_t middle{ line.find(" line ") };
+            whole = middle != std::string_view::npos
+                    && std::from_chars(line.data(), line.data() + middle, thread).ptr == line.data() + middle
+                    && std::from_chars(line.data() + middle + 6, line.data() + line.size(), index).ptr
+                           == line.data() + line.size()
+                    && thread >= 0 && thread < threadCount;
+        }
+        if (!whole)
+        {
+            ++check.broken;
+            continue;
+        }
+        if (index != expected[static_cast<std::size_t>(thread)])
+            ++check.outOfOrder;
+        expected[static_cast<std::size_t>(thread)] = index + 1;
+    }
+    return check;
+}
+
+void report(const char* name, const Outcome& outcome, const Check& check, std::size_t totalLines)
+{
+    const std::vector<double>& samples{ outcome.nanoseconds };
+    std::printf("%-14s %9.1f ms %8.1f ns/line   p50 %8.0f ns   p99 %9.0f ns   %zu lines, %zu broken, %zu out of order\n",
+                name, outcome.seconds * 1e3, outcome.seconds * 1e9 / static_cast<double>(totalLines),
+                samples[samples.size() / 2], samples[samples.size() * 99 / 100], check.lines, check.broken,
+                check.outOfOrder);
+}
+
+int main(int argc, char* argv[])
+{
+    const int threadCount{ argc > 1 ? std::max(1, std::atoi(argv[1])) : 64 };
+    const int lineCount{ argc > 2 ? std::max(16, std::atoi(argv[2])) : 100000 };
+    const char* const path{ argc > 3 ? argv[3] : "line-aggregator-benchmark.out" };
+    const std::size_t totalLines{ static_cast<std::size_t>(threadCount) * static_cast<std::size_t>(lineCount) };
+
+    // What timing an empty line costs, which is included in every p50 and p99.
+    std::vector<double> empty{ };
+    for (int i{ 0 }; i < 100000; ++i)
+    {
+        const auto lineStart{ std::chrono::steady_clock::now() };
+        const std::chrono::duration<double, std::nano> elapsed{ std::chrono::steady_clock::now() - lineStart };
+        empty.push_back(elapsed.count());
+    }
+    std::sort(empty.begin(), empty.end());
+    std::printf("%d threads, %d lines each, %u cores; timing a line adds %.0f ns\n", threadCount, lineCount,
+                std::thread::hardware_concurrency(), empty[empty.size() / 2]);
+    std::fflush(stdout);
+    const int savedOutput{ ::dup(STDOUT_FILENO) };
+
+    // std::cout, with and without a mutex, writing to the file as the standard output.
+    for (const bool locked : { false, true })
+    {
+        const int fd{ ::open(path, O_WRONLY | O_CREAT | O_TRUNC, 0644) };
+        if (fd < 0)
+        {
+            std::perror(path);
+            return 1;
+        }
+        ::dup2(fd, STDOUT_FILENO);
+        ::close(fd);
+        std::mutex mutex{ };
+        const Outcome outcome{ runThreads(
+            threadCount, lineCount,
+            [&](int thread, int index) {
+                if (locked)
+                {
+                    std::lock_guard lock{ mutex };
+                    std::cout << "thread " << thread << " line " << index << " of " << lineCount << '\n';
+                }
+                else
+                {
+                    std::cout << "thread " << thread << " line " << index << " of " << lineCount << '\n';
+                }
+            },
+            [] { std::cout.flush(); }) };
+        ::dup2(savedOutput, STDOUT_FILENO);
+        report(locked ? "cout + mutex" : "cout", outcome, checkOutput(path, threadCount, lineCount), totalLines);
+        std::fflush(stdout);
+    }
+
+    // LineAggregator, writing to the file directly.
+    const int fd{ ::open(path, O_WRONLY | O_CREAT | O_TRUNC, 0644) };
+    if (fd < 0)
+    {
+        std::perror(path);
+        return 1;
+    }
+    Outcome outcome{ };
+    {
+        LineAggregator output{ fd };
+        outcome = runThreads(
+            threadCount, lineCount,
+            [&](int thread, int index) {
+                output.line() << "thread " << thread << " line " << index << " of " << lineCount;
+            },
+            [&] { output.flush(); });
+        if (output.fail())
+        {
+            std::printf("aggregator: writing %s failed\n", path);
+            return 1;
+        }
+    }
+    ::close(fd);
+    const Check check{ checkOutput(path, threadCount, lineCount) };
+    report("aggregator", outcome, check, totalLines);
+    std::remove(path);
+    if (check.lines != totalLines || check.broken != 0 || check.outOfOrder != 0)
+    {
+        std::printf("MISMATCH: the aggregator lost, broke or reordered lines\n");
+        return 1;
+    }
+    return 0;
+}
@@ -0,0 +1,430 @@
+#ifndef LINE_AGGREGATOR_H
+#define LINE_AGGREGATOR_H
+
+//** Output from many threads, whole lines at a time **//
+
+// Every program in this repository prints with std::cout, and from one thread. When many threads print to the same
+// std::cout, their lines can come out mixed together, and putting a mutex around each line makes the threads queue
+// up behind it instead. LineAggregator gives each thread its own buffer, and a background thread writes the
+// finished lines out:
+
+//     LineAggregator output{ };                                  // writes to standard output
+//     ...                                                        // then, on any thread:
+//     output.line() << "worker " << id << " done in " << ms << " ms";   // the line ends when the statement does
+//     output.writeLine("a whole line");
+
+// A line is formatted straight into the calling thread's current block, and becomes visible to the flusher thread
+// all at once, with a single release store, when the Line object goes away at the end of the statement. Writers
+// never wait for each other and never write to memory another writer uses, so the cost of a line is the cost of
+// copying its bytes, however many threads are writing. Each thread's buffers are found through a thread_local
+// pointer, the first time a thread writes.
+
+// The blocks of one thread form a chain that only that thread adds to. Together the chains are a lock-free queue
+// with many producers and one consumer, the flusher, which walks every chain, gathers all the whole lines written
+// since its last pass into one writev(2) call, and hands each block back to its thread once it's written. Rather
+// than one shared queue, a chain per thread is used so that a writer doesn't even touch a shared atomic when its
+// block fills up, and so that the flusher can pick up the lines in a block that isn't full yet.
+    // Lines are never split or mixed with other lines: only whole lines are ever handed to writev.
+    // The lines of one thread come out in the order they were written. Lines of different threads come out in
+    // roughly the order they were written, as they would through a mutex.
+    // A writer that gets maxBlocksPerThread blocks ahead of the flusher waits for it rather than using more memory.
+    // flush() returns once every line finished before it was called has been written; the destructor does the same.
+
+// Like FastWriter (fast-output.h), a LineAggregator should be the only thing writing to its descriptor: anything
+// else written there (std::cout included) lands between batches. A thread should finish one Line before starting
+// the next, and every writer must be done before the aggregator is destroyed.
+
+#include <algorithm>
+#include <atomic>
+#include <cerrno>
+#include <charconv>
+#include <chrono>
+#include <climits>
+#include <condition_variable>
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <memory>
+#include <mutex>
+#include <string_view>
+#include <sys/uio.h>
+#include <thread>
+#include <type_traits>
+#include <unistd.h>
+#include <utility>
+#include <vector>
+
+struct LineAggregatorOptions
+{
+    std::size_t blockSize{ std::size_t{ 16 } << 10 };   // bytes per buffer; a longer line gets a block of its own
+    std::size_t maxBlocksPerThread{ 64 };               // how far ahead of the flusher one thread may get
+    std::chrono::microseconds flushInterval{ 1000 };    // how long the flusher sleeps when there was nothing to write
+};
+
+namespace lineAggregatorDetail
+{
+    constexpr std::size_t cacheLine{ 64 };
+
+    struct Block
+    {
+        explicit Block(std::size_t size)
+            : capacity{ size }
+            , data{ new char[size] }
+        {
+        }
+
+        const std::size_t capacity{ };
+        const std::unique_ptr<char[]> data{ };
+
+        std::atomic<std::size_t> committed{ 0 };  // the bytes of whole lines, published by the writer
+        std::atomic<Block*> next{ nullptr };       // set once the writer has moved on: committed is then final
+        std::atomic<bool> free{ false };           // set by the flusher once every committed byte is written
+    };
+
+    // One thread's buffers. The writer's fields and the flusher's are kept on separate cache lines.
+    struct Producer
+    {
+        explicit Producer(const LineAggregatorOptions& options)
+            : blockSize{ std::max<std::size_t>(options.blockSize, 64) }
+            , maxBlocks{ std::max<std::size_t>(options.maxBlocksPerThread, 2) }
+        {
+            blocks.push_back(std::make_unique<Block>(blockSize));
+            current = blocks.front().get();
+            reading = current;
+        }
+
+        void append(const char* text, std::size_t size)
+        {
+            if (current->capacity - position < size)
+                moveOn(size);
+            std::memcpy(current->data.get() + position, text, size);
+            position += size;
+        }
+
+        // Room for at least size more bytes at the end of the line.
+        char* reserve(std::size_t size)
+        {
+            if (current->capacity - position < size)
+                moveOn(size);
+            return current->data.get() + position;
+        }
+
+        void endLine()
+        {
+            if (position == current->capacity)
+                moveOn(1);
+            current->data[position++] = '\n';
+            current->committed.store(position, std::memory_order_release);
+            lineStart = position;
+        }
+
+        // Continue in another block with room for the line so far and size more bytes, and seal this one.
+        void moveOn(std::size_t size)
+        {
+            const std::size_t partial{ position - lineStart };
+            Block* const next{ takeBlock(partial + size) };
+            std::memcpy(next->data.get(), current->data.get() + lineStart, partial);
+            current->next.store(next, std::memory_order_release);
+            current = next;
+            position = partial;
+            lineStart = 0;
+        }
+
+        Block* takeBlock(std::size_t size)
+        {
+            for (int attempt{ 0 };; ++attempt)
+            {
+                for (std::unique_ptr<Block>& block : blocks)
+                {
+                    if (block.get() == current || !block->free.load(std::memory_order_acquire))
+                        continue;
+                    if (block->capacity < size)
+                        block = std::make_unique<Block>(std::max(size, blockSize));
+                    block->committed.store(0, std::memory_order_relaxed);
+                    block->next.store(nullptr, std::memory_order_relaxed);
+                    block->free.store(false, std::memory_order_relaxed);
+                    return block.get();
+                }
+                if (blocks.size() < maxBlocks)
+                {
+                    blocks.push_back(std::make_unique<Block>(std::max(size, blockSize)));
+                    return blocks.back().get();
+                }
+                if (attempt > 64)
+                    std::this_thread::yield();
+            }
+        }
+
+        const std::size_t blockSize{ };
+        const std::size_t maxBlocks{ };
+
+        // Writer only.
+        alignas(cacheLine) Block* current{ };
+        std::size_t position{ 0 };  // where the next byte goes
+        std::size_t lineStart{ 0 }; // where the unfinished line starts (equal to current->committed between lines)
+        std::vector<std::unique_ptr<Block>> blocks{ };
+
+        // Flusher only, apart from finished.
+        alignas(cacheLine) Block* reading{ };
+        std::size_t flushed{ 0 }; // bytes of reading already gathered
+        std::atomic<bool> finished{ false }; // the thread has exited: drop this once everything is written
+    };
+
+    inline std::atomic<std::uint64_t> nextAggregatorId{ 1 };
+
+    // The calling thread's Producer for each aggregator it has written to. The last one used is checked first.
+    struct ThreadProducers
+    {
+        ~ThreadProducers()
+        {
+            for (const auto& entry : entries)
+                entry.second->finished.store(true, std::memory_order_release);
+        }
+
+        std::uint64_t lastId{ 0 };
+        Producer* last{ nullptr };
+        std::vector<std::pair<std::uint64_t, std::shared_ptr<Producer>>> entries{ };
+    };
+
+    inline thread_local ThreadProducers threadProducers{ };
+}
+
+class LineAggregator
+{
+public:
+    // One line under construction. It goes to the flusher, followed by '\n', when this is destroyed.
+    class Line
+    {
+    public:
+        explicit Line(lineAggregatorDetail::Producer& producer)
+            : m_producer{ producer }
+        {
+        }
+
+        Line(const Line&) = delete;
+        Line& operator=(const Line&) = delete;
+
+        ~Line() { m_producer.endLine(); }
+
+        Line& operator<<(std::string_view text)
+        {
+            m_producer.append(text.data(), text.size());
+            return *this;
+        }
+
+        Line& operator<<(const char* text) { return *this << std::string_view{ text }; }
+
+        Line& operator<<(char c) { return *this << std::string_view{ &c, 1 }; }
+
+        // Numbers are formatted with std::to_chars, as FastWriter does.
+        template <typename T>
+            requires(std::is_arithmetic_v<T> && !std::is_same_v<T, char> && !std::is_same_v<T, bool>)
+        Line& operator<<(T value)
+        {
+            constexpr std::size_t longestNumber{ 32 };
+            char* const first{ m_producer.reserve(longestNumber) };
+            const std::to_chars_result result{ std::to_chars(first, first + longestNumber, value) };
+            m_producer.position += static_cast<std::size_t>(result.ptr - first);
+            return *this;
+        }
+
+        Line& operator<<(bool value) { return *this << (value ? '1' : '0'); }
+
+    private:
+        lineAggregatorDetail::Producer& m_producer;
+    };
+
+    explicit LineAggregator(int fd = STDOUT_FILENO, const LineAggregatorOptions& options = { })
+        : m_fd{ fd }
+        , m_options{ options }
+    {
+        m_flusher = std::thread{ [this] { flusherLoop(); } };
+    }
+
+    LineAggregator(const LineAggregator&) = delete;
+    LineAggregator& operator=(const LineAggregator&) = delete;
+
+    ~LineAggregator()
+    {
+        {
+            std::lock_guard lock{ m_mutex };
+            m_stopping = true;
+        }
+        m_wake.notify_all();
+        m_flusher.join();
+    }
+
+    Line line() { return Line{ producer() }; }
+
+    void writeLine(std::string_view text)
+    {
+        lineAggregatorDetail::Producer& writer{ producer() };
+        writer.append(text.data(), text.size());
+        writer.endLine();
+    }
+
+    // Wait until every line finished (on any thread) before this call has been written.
+    void flush()
+    {
+        std::unique_lock lock{ m_mutex };
+        const std::uint64_t request{ ++m_flushRequested };
+        m_wake.notify_all();
+        m_flushed.wait(lock, [&] { return m_flushCompleted >= request; });
+    }
+
+    // Whether a write to the descriptor has failed. The lines it had are dropped, as FastWriter drops them.
+    bool fail() const { return m_failed.load(std::memory_order_relaxed); }
+
+private:
+    using Block = lineAggregatorDetail::Block;
+    using Producer = lineAggregatorDetail::Producer;
+
+    lineAggregatorDetail::Producer& producer()
+    {
+        lineAggregatorDetail::ThreadProducers& mine{ lineAggregatorDetail::threadProducers };
+        if (mine.lastId == m_id)
+            return *mine.last;
+        return registerThread(mine);
+    }
+
+    [[gnu::noinline]] Producer& registerThread(lineAggregatorDetail::ThreadProducers& mine)
+    {
+        auto found{ std::find_if(mine.entries.begin(), mine.entries.end(),
+                                 [&](const auto& entry) { return entry.first == m_id; }) };
+        if (found == mine.entries.end())
+        {
+            // Entries of aggregators that are gone only hold on to their Producer; forget them now.
+            std::erase_if(mine.entries, [](const auto& entry) { return entry.second.use_count() == 1; });
+            auto created{ std::make_shared<Producer>(m_options) };
+            {
+                std::lock_guard lock{ m_mutex };
+                m_producers.push_back(created);
+            }
+            mine.entries.emplace_back(m_id, std::move(created));
+            found = mine.entries.end() - 1;
+        }
+        mine.lastId = m_id;
+        mine.last = found->second.get();
+        return *mine.last;
+    }
+
+    // Gather every committed line not yet written, write them, and hand finished blocks back. Returns whether there
+    // was anything to write.
+    bool drainOnce()
+    {
+        m_pieces.clear();
+        m_written.clear();
+        {
+            std::lock_guard lock{ m_mutex };
+            for (const std::shared_ptr<Producer>& producer : m_producers)
+            {
+                // Read finished first: if it was set, nothing written before it can be missed below.
+                const bool finished{ producer->finished.load(std::memory_order_acquire) };
+                for (;;)
+                {
+                    Block* const block{ producer->reading };
+                    Block* const next{ block->next.load(std::memory_order_acquire) };
+                    const std::size_t committed{ block->committed.load(std::memory_order_acquire) };
+                    if (committed > producer->flushed)
+                    {
+                        m_pieces.push_back({ block->data.get() + producer->flushed, committed - producer->flushed });
+                        producer->flushed = committed;
+                    }
+                    if (!next)
+                        break;
+                    m_written.push_back(block);
+                    producer->reading = next;
+                    producer->flushed = 0;
+                }
+                if (finished)
+                    m_finished.push_back(producer);
+            }
+            std::erase_if(m_producers, [&](const std::shared_ptr<Producer>& producer) {
+                return std::find(m_finished.begin(), m_finished.end(), producer) != m_finished.end();
+            });
+        }
+
+        writePieces();
+        for (Block* const block : m_written)
+            block->free.store(true, std::memory_order_release);
+        m_finished.clear();
+        return !m_pieces.empty();
+    }
+
+    void writePieces()
+    {
+        for (std::size_t first{ 0 }; first < m_pieces.size();)
+        {
+            const int count{ static_cast<int>(std::min<std::size_t>(m_pieces.size() - first, IOV_MAX)) };
+            const ssize_t written{ ::writev(m_fd, m_pieces.data() + first, count) };
+            if (written < 0)
+            {
+                if (errno == EINTR)
+                    continue;
+                m_failed.store(true, std::memory_order_relaxed);
+                return;
+            }
+
+            // Skip what was written; a partial write leaves the rest of a piece for the next call.
+            std::size_t left{ static_cast<std::size_t>(written) };
+            while (first < m_pieces.size() && left >= m_pieces[first].iov_len)
+                left -= m_pieces[first++].iov_len;
+            if (left != 0)
+            {
+                m_pieces[first].iov_base = static_cast<char*>(m_pieces[first].iov_base) + left;
+                m_pieces[first].iov_len -= left;
+            }
+        }
+    }
+
+    void flusherLoop()
+    {
+        for (;;)
+        {
+            std::uint64_t requested{ };
+            bool stopping{ };
+            {
+                std::lock_guard lock{ m_mutex };
+                requested = m_flushRequested;
+                stopping = m_stopping;
+            }
+            const bool wrote{ drainOnce() };
+            {
+                std::lock_guard lock{ m_mutex };
+                m_flushCompleted = requested;
+            }
+            m_flushed.notify_all();
+
+            // Once stopping, keep going until a pass finds nothing more.
+            if (wrote)
+                continue;
+            if (stopping)
+                return;
+            std::unique_lock lock{ m_mutex };
+            m_wake.wait_for(lock, m_options.flushInterval,
+                            [&] { return m_stopping || m_flushRequested != requested; });
+        }
+    }
+
+    const std::uint64_t m_id{ lineAggregatorDetail::nextAggregatorId.fetch_add(1, std::memory_order_relaxed) };
+    const int m_fd{ };
+    const LineAggregatorOptions m_options{ };
+    std::atomic<bool> m_failed{ false };
+
+    std::mutex m_mutex{ }; // guards the members below; writers only take it the first time they write
+    std::condition_variable m_wake{ };
+    std::condition_variable m_flushed{ };
+    std::vector<std::shared_ptr<Producer>> m_producers{ };
+    std::uint64_t m_flushRequested{ 0 };
+    std::uint64_t m_flushCompleted{ 0 };
+    bool m_stopping{ false };
+
+    // The flusher's own scratch space.
+    std::vector<iovec> m_pieces{ };
+    std::vector<Block*> m_written{ };
+    std::vector<std::shared_ptr<Producer>> m_finished{ }; // kept alive until their last lines are written
+
+    std::thread m_flusher{ };
+};
+
+#endif
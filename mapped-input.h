@@ -0,0 +1,200 @@
+#ifndef MAPPED_INPUT_H
+#define MAPPED_INPUT_H
+
+//** Reading a file without copying it **//
+
+// Reading a file with read(2) (or std::cin, or FastReader) copies every byte twice: from the disk into the
+// operating system's page cache, and from there into the program's buffer. For multi-gigabyte inputs the second
+// copy, and the system calls that do it, are a real cost.
+
+// MappedInput asks the operating system to map the file's pages straight into the program's address space with
+// mmap(2), so the parser reads the page cache directly. It also tells the kernel the file will be read from start
+// to end (madvise(MADV_SEQUENTIAL)) so it reads ahead aggressively, and can optionally ask for huge pages, which
+// cut down on page-table work for very large files.
+
+// Pipes and terminals can't be mapped. For those, MappedInput falls back to read(2) into a buffer, and only reads
+// when asked to. text() reads to the end of the input the first time it's called, so callers always get the whole
+// input as one std::string_view either way. A program that has to answer input as it arrives, such as the "Enter a
+// number:" programs, takes it piece by piece instead: available() is what has arrived and not been consumed yet,
+// refill() waits for more, and consume() drops what has been used. For a mapped file everything is available at
+// once and refill() has nothing to add.
+
+// Usage:
+
+//     MappedInput input{ "values.txt" };
+//     std::string_view text{ input.text() };
+//     if (!input)
+//         ... // couldn't open or read the file
+//
+//     MappedInput typed{ STDIN_FILENO };
+//     while (typed.refill())                                // or is at the end of the input
+//         typed.consume(answerCompleteLines(typed.available()));
+
+#include <algorithm>
+#include <cerrno>
+#include <cstddef>
+#include <cstring>
+#include <fcntl.h>
+#include <string_view>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#include <utility>
+#include <vector>
+
+struct MapOptions
+{
+    bool hugePages{ false }; // madvise(MADV_HUGEPAGE): fewer TLB misses on huge files, if the kernel supports it
+    bool populate{ false };  // MAP_POPULATE: fault in every page up front instead of on first touch
+};
+
+class MappedInput
+{
+public:
+    explicit MappedInput(const char* path, MapOptions options = { })
+    {
+        const int fd{ ::open(path, O_RDONLY) };
+        if (fd < 0)
+            return;
+        load(fd, options);
+        ::close(fd);
+    }
+
+    // Use an already-open descriptor (for example STDIN_FILENO). The descriptor is not closed.
+    explicit MappedInput(int fd, MapOptions options = { })
+    {
+        load(fd, options);
+    }
+
+    MappedInput(const MappedInput&) = delete;
+    MappedInput& operator=(const MappedInput&) = delete;
+
+    MappedInput(MappedInput&& other) noexcept
+        : m_mapping{ std::exchange(other.m_mapping, nullptr) }
+        , m_mappedSize{ std::exchange(other.m_mappedSize, 0) }
+        , m_text{ std::exchange(other.m_text, { }) }
+        , m_fd{ std::exchange(other.m_fd, -1) }
+        , m_buffer{ std::move(other.m_buffer) }
+        , m_size{ std::exchange(other.m_size, 0) }
+        , m_consumed{ std::exchange(other.m_consumed, 0) }
+        , m_ok{ std::exchange(other.m_ok, false) }
+    {
+    }
+
+    ~MappedInput()
+    {
+        if (m_mapping)
+            ::munmap(m_mapping, m_mappedSize);
+        if (m_fd >= 0)
+            ::close(m_fd);
+    }
+
+    // False if the input couldn't be opened, or (as far as it has been read) couldn't be read.
+    explicit operator bool() const { return m_ok; }
+
+    // All of the input that hasn't been consumed. For a pipe or terminal, the first call waits for the end of it.
+    std::string_view text() const
+    {
+        while (readMore())
+        {
+        }
+        return available();
+    }
+
+    // The input that has arrived and hasn't been consumed yet. Never waits.
+    std::string_view available() const
+    {
+        return isMapped() ? m_text.substr(m_consumed) : std::string_view{ m_buffer.data(), m_size }.substr(m_consumed);
+    }
+
+    // Wait for more input after what's available (at least one byte). False at the end of the input or on a read
+    // error, and always for a mapped (or empty) file, which is all available from the start.
+    bool refill() { return readMore(); }
+
+    // Drop the first count bytes of available(), once the caller is done with them.
+    void consume(std::size_t count) { m_consumed += std::min(count, available().size()); }
+
+    // True if the text comes straight from the page cache, false if it was copied into a buffer.
+    bool isMapped() const { return m_mapping != nullptr; }
+
+private:
+    void load(int fd, MapOptions options)
+    {
+        struct stat info{ };
+        if (::fstat(fd, &info) != 0)
+            return;
+        m_ok = true;
+
+        if (S_ISREG(info.st_mode))
+        {
+            if (info.st_size == 0)
+                return; // nothing to map, or to read
+
+            const std::size_t size{ static_cast<std::size_t>(info.st_size) };
+            void* mapping{ ::mmap(nullptr, size, PROT_READ, MAP_PRIVATE | (options.populate ? MAP_POPULATE : 0), fd, 0) };
+            if (mapping != MAP_FAILED)
+            {
+                ::madvise(mapping, size, MADV_SEQUENTIAL);
+#ifdef MADV_HUGEPAGE
+                if (options.hugePages)
+                    ::madvise(mapping, size, MADV_HUGEPAGE);
+#endif
+                m_mapping = mapping;
+                m_mappedSize = size;
+                m_text = { static_cast<const char*>(mapping), size };
+                return;
+            }
+            m_buffer.resize(size + 1); // mmap refused a regular file: read it, in one go if it doesn't grow
+        }
+        m_fd = ::dup(fd); // read later, on demand; a duplicate, so the caller may close theirs
+        if (m_fd < 0)
+            m_ok = false;
+    }
+
+    // The fallback for pipes, terminals, and anything else mmap refuses: one read(2) onto the end of the buffer,
+    // making room first. False at the end of the input, or on an error.
+    bool readMore() const
+    {
+        if (m_fd < 0)
+            return false;
+        if (m_consumed != 0 && m_consumed >= m_size / 2)
+        {
+            // Keep the buffer from growing with input that has already been used.
+            std::memmove(m_buffer.data(), m_buffer.data() + m_consumed, m_size - m_consumed);
+            m_size -= m_consumed;
+            m_consumed = 0;
+        }
+        if (m_size == m_buffer.size())
+            m_buffer.resize(std::max<std::size_t>(m_buffer.size() * 2, 1 << 16));
+
+        ssize_t count{ };
+        do
+        {
+            count = ::read(m_fd, m_buffer.data() + m_size, m_buffer.size() - m_size);
+        } while (count < 0 && errno == EINTR);
+        if (count <= 0)
+        {
+            const int error{ errno }; // for the caller to report, after close() may have changed it
+            m_ok = m_ok && count == 0;
+            ::close(m_fd);
+            m_fd = -1;
+            errno = error;
+            return false;
+        }
+        m_size += static_cast<std::size_t>(count);
+        return true;
+    }
+
+    void* m_mapping{ nullptr };
+    std::size_t m_mappedSize{ 0 };
+    std::string_view m_text{ }; // the mapping
+
+    // The fallback's state. text() is const but may have to read the rest of the input first, hence mutable.
+    mutable int m_fd{ -1 };
+    mutable std::vector<char> m_buffer{ };
+    mutable std::size_t m_size{ 0 };     // bytes of m_buffer read so far
+    mutable std::size_t m_consumed{ 0 }; // bytes of available() dropped by consume()
+    mutable bool m_ok{ false };
+};
+
+#endif
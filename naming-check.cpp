@@ -0,0 +1,401 @@
+//** naming-check: report naming convention violations across a source tree **//
+
+// Build and run:
+//     g++ -std=c++20 -O2 -pthread naming-check.cpp -o naming-check
+//     ./naming-check [--threads N] [--cache FILE] [--stats] [directory or file ...]   (default: the current directory)
+//     ./naming-check --self-test
+
+// Every C++ source file under the given directories (.cpp, .cc, .cxx, .c++, .h, .hh, .hpp, .hxx, .ipp, .inl) is
+// checked with analyzeNaming() from naming-rules.h, and each violation is printed as
+//     path:line:column: name: description
+// Hidden directories (like .git) and symbolic links to directories are not entered.
+
+// Walking the tree and checking files both run on a WorkStealingPool (work-stealing-pool.h): each directory is a
+// task that submits a task for each subdirectory and each source file in it, so all threads stay busy even when
+// the tree is lopsided. Files are read with read(2) into a buffer each thread reuses, which is cheaper than mapping
+// hundreds of thousands of small files.
+
+// With --cache FILE, each file's results are saved in FILE (see analysis-cache.h), and the next run reuses them for
+// files that haven't changed: those whose modification time and size are the same aren't even opened, and those
+// whose content hash is the same aren't analyzed again. --stats prints, on standard error, how many files were
+// analyzed and how many came from the cache, and how often identifiers, numbers and each keyword were used.
+
+// The output doesn't depend on the number of threads or on the order the file system lists directories in: the
+// results are sorted by path (then by position in the file) before anything is printed.
+
+// --self-test checks the rules themselves on a few short snippets (some taken from keywords-identifiers.cpp), printing
+// MISMATCH and exiting with 1 if one of them isn't reported as expected.
+
+// The exit status is 0 if nothing was found, 1 if there were violations, and 2 if a file or directory couldn't be
+// read (those are reported on standard error).
+
+#include <algorithm>
+#include <array>
+#include <cerrno>
+#include <cstdint>
+#include <cstdlib>
+#include <fcntl.h>
+#include <filesystem>
+#include <iterator>
+#include <optional>
+#include <string>
+#include <string_view>
+#include <system_error>
+#include <unistd.h>
+#include <vector>
+
+#include "analysis-cache.h"
+#include "fast-output.h"
+#include "naming-rules.h"
+#include "work-stealing-pool.h"
+#include "xxhash.h"
+
+namespace
+{
+    // Everything one thread produces, kept apart from the other threads' until the end.
+    struct WorkerResults
+    {
+        std::vector<CacheRecord> records{ };
+        std::vector<std::string> errors{ };
+        std::size_t fromCache{ 0 };
+        bool cacheChanged{ false }; // some file wasn't a hit on its stamp, so the cache needs writing again
+        std::string buffer{ };
+    };
+
+    bool isSourceFile(const std::filesystem::path& path)
+    {
+        constexpr std::string_view extensions[]{ ".cpp", ".cc", ".cxx", ".c++", ".h", ".hh", ".hpp", ".hxx", ".ipp", ".inl" };
+        const std::string extension{ path.extension().string() };
+        return std::find(std::begin(extensions), std::end(extensions), extension) != std::end(extensions);
+    }
+
+    bool readFile(const std::string& path, std::string& buffer)
+    {
+        const int fd{ ::open(path.c_str(), O_RDONLY | O_CLOEXEC) };
+        if (fd < 0)
+            return false;
+
+        buffer.clear();
+        std::size_t size{ 0 };
+        for (;;)
+        {
+            if (buffer.size() - size < 4096)
+                buffer.resize(std::max<std::size_t>(buffer.size() * 2, 1 << 16));
+            const ssize_t got{ ::read(fd, buffer.data() + size, buffer.size() - size) };
+            if (got < 0 && errno == EINTR)
+                continue;
+            if (got <= 0)
+            {
+                const int readError{ errno };
+                ::close(fd);
+                errno = readError;
+                buffer.resize(size);
+                return got == 0;
+            }
+            size += static_cast<std::size_t>(got);
+        }
+    }
+
+    struct SelfTest
+    {
+        const char* source{ };
+        const char* expected{ }; // the reported names, each followed by a space
+    };
+
+    // Snippets the rules once got wrong, and the names each should be reported for.
+    constexpr SelfTest selfTests[]{
+        // The list of keywords in keywords-identifiers.cpp, then its example declaration.
+        { "true\ntry\ntypedef\ntypeid\ntypename\n\n"
+          "// holds number of chars in a piece of text -- including whitespace and punctuation\n\n"
+          "int numberOfChars;\n",
+          "" },
+        { "typedef int counter;\nint numberOfChars;\n", "counter " },
+        { "class Widget\n{\npublic:\n    typedef int count;\n    int size;\n};\n", "count " },
+        { "struct Task\n{\n    struct promise_type;\n    using value_type = int;\n    using iterator = int*;\n};\n",
+          "" },
+        { "template <typename U>\nstruct rebind\n{\n    using other = Allocator<U>;\n};\n", "" },
+        { "int NumberOfChars;\nstruct widget { };\n", "NumberOfChars widget " },
+    };
+
+    int runSelfTests()
+    {
+        int failures{ 0 };
+        for (const SelfTest& test : selfTests)
+        {
+            std::string reported{ };
+            for (const NamingViolation& violation : checkNaming(test.source))
+                reported += violation.name + ' ';
+            if (reported != test.expected)
+            {
+                FastWriter{ STDOUT_FILENO } << "MISMATCH: reported \"" << reported << "\" instead of \""
+                                            << test.expected << "\" for\n" << test.source;
+                ++failures;
+            }
+        }
+        return failures == 0 ? 0 : 1;
+    }
+
+    class Checker
+    {
+    public:
+        Checker(WorkStealingPool& pool, const AnalysisCache* cache)
+            : m_pool{ pool }
+            , m_cache{ cache }
+            , m_results(pool.threadCount())
+        {
+        }
+
+        // The cheap part: if the cache has this file with the same stamp, take its results without opening it.
+        bool takeFromCache(std::string& path, std::size_t worker)
+        {
+            if (!m_cache)
+                return false;
+            const CacheEntry* entry{ m_cache->find(path) };
+            if (!entry || entry->stamp.modified == 0)
+                return false;
+
+            CacheRecord record{ };
+            if (!stampOf(path.c_str(), record.stamp) || entry->stamp != record.stamp
+                || !m_cache->analysis(*entry, record.analysis))
+            {
+                return false;
+            }
+            WorkerResults& results{ m_results[worker] };
+            record.path = std::move(path);
+            record.contentHash = entry->contentHash;
+            ++results.fromCache;
+            results.records.push_back(std::move(record));
+            return true;
+        }
+
+        // The expensive part: read the file, and analyze it unless its content is in the cache after all.
+        void checkFile(std::string& path, std::size_t worker)
+        {
+            WorkerResults& results{ m_results[worker] };
+            results.cacheChanged = true;
+            CacheRecord record{ };
+            const bool stamped{ m_cache && stampOf(path.c_str(), record.stamp) }; // before reading, not after
+            if (!readFile(path, results.buffer))
+            {
+                results.errors.push_back(path + ": " + std::generic_category().message(errno));
+                return;
+            }
+
+            if (m_cache)
+            {
+                // If the file changed while it was read, the content may be half old and half new: report what was
+                // read, but don't save it under either stamp.
+                FileStamp afterReading{ };
+                record.cacheable = stamped && stampOf(path.c_str(), afterReading) && afterReading == record.stamp;
+                record.contentHash = xxHash64(results.buffer.data(), results.buffer.size());
+                const CacheEntry* entry{ m_cache->find(path) };
+                if (entry && entry->contentHash == record.contentHash && m_cache->analysis(*entry, record.analysis))
+                    ++results.fromCache;
+                else
+                    record.analysis = analyzeNaming(results.buffer);
+            }
+            else
+            {
+                record.analysis = analyzeNaming(results.buffer);
+            }
+            record.path = std::move(path);
+            results.records.push_back(std::move(record));
+        }
+
+        void walkDirectory(const std::filesystem::path& directory, std::size_t worker)
+        {
+            std::error_code error{ };
+            std::filesystem::directory_iterator entries{ directory, error };
+            for (; !error && entries != std::filesystem::directory_iterator{ }; entries.increment(error))
+            {
+                const std::filesystem::directory_entry& entry{ *entries };
+                std::error_code statusError{ };
+                if (entry.is_symlink(statusError) && entry.is_directory(statusError))
+                    continue;
+
+                if (entry.is_directory(statusError))
+                {
+                    if (entry.path().filename().string().starts_with('.'))
+                        continue;
+                    submitDirectory(entry.path());
+                }
+                else if (entry.is_regular_file(statusError) && isSourceFile(entry.path()))
+                {
+                    // Cache hits are handled right here: a task per file would cost more than the check itself.
+                    std::string path{ entry.path().string() };
+                    if (!takeFromCache(path, worker))
+                        submitFile(std::move(path));
+                }
+            }
+            if (error)
+                m_results[worker].errors.push_back(directory.string() + ": " + error.message());
+        }
+
+        void submitDirectory(std::filesystem::path directory)
+        {
+            m_pool.submit([this, directory{ std::move(directory) }](std::size_t worker) { walkDirectory(directory, worker); });
+        }
+
+        void submitFile(std::string path)
+        {
+            m_pool.submit([this, path{ std::move(path) }](std::size_t worker) mutable { checkFile(path, worker); });
+        }
+
+        // Every thread's results, sorted by path. The records themselves stay where they are.
+        std::vector<const CacheRecord*> records() const
+        {
+            std::vector<const CacheRecord*> all{ };
+            for (const WorkerResults& results : m_results)
+            {
+                for (const CacheRecord& record : results.records)
+                    all.push_back(&record);
+            }
+            std::sort(all.begin(), all.end(), [](const CacheRecord* a, const CacheRecord* b) { return a->path < b->path; });
+            return all;
+        }
+
+        std::vector<std::string> errors() const
+        {
+            std::vector<std::string> all{ };
+            for (const WorkerResults& results : m_results)
+                all.insert(all.end(), results.errors.begin(), results.errors.end());
+            std::sort(all.begin(), all.end());
+            return all;
+        }
+
+        std::size_t fromCache() const
+        {
+            std::size_t total{ 0 };
+            for (const WorkerResults& results : m_results)
+                total += results.fromCache;
+            return total;
+        }
+
+        // Whether the cache must be written again: something changed, or files were removed.
+        bool cacheOutdated(std::size_t fileCount) const
+        {
+            const bool changed{ std::any_of(m_results.begin(), m_results.end(),
+                                            [](const WorkerResults& results) { return results.cacheChanged; }) };
+            return !m_cache || changed || m_cache->size() != fileCount;
+        }
+
+    private:
+        WorkStealingPool& m_pool;
+        const AnalysisCache* m_cache{ };
+        std::vector<WorkerResults> m_results{ };
+    };
+}
+
+int main(int argc, char* argv[])
+{
+    std::size_t threads{ 0 };
+    const char* cachePath{ nullptr };
+    bool showStats{ false };
+    std::vector<std::string> roots{ };
+    for (int i{ 1 }; i < argc; ++i)
+    {
+        const std::string_view argument{ argv[i] };
+        if (argument == "--threads" && i + 1 < argc)
+            threads = std::strtoull(argv[++i], nullptr, 10);
+        else if (argument == "--cache" && i + 1 < argc)
+            cachePath = argv[++i];
+        else if (argument == "--stats")
+            showStats = true;
+        else if (argument == "--self-test")
+            return runSelfTests();
+        else if (argument.starts_with("--"))
+        {
+            FastWriter{ STDERR_FILENO } << "usage: naming-check [--threads N] [--cache FILE] [--stats] [--self-test] [directory or file ...]\n";
+            return 2;
+        }
+        else
+            roots.emplace_back(argument);
+    }
+    if (roots.empty())
+        roots.emplace_back(".");
+
+    std::optional<AnalysisCache> cache{ };
+    if (cachePath)
+        cache.emplace(cachePath);
+
+    WorkStealingPool pool{ threads };
+    Checker checker{ pool, cache ? &*cache : nullptr };
+    for (std::string& root : roots)
+    {
+        std::error_code error{ };
+        if (std::filesystem::is_directory(root, error))
+            checker.submitDirectory(root);
+        else
+            checker.submitFile(std::move(root));
+    }
+    pool.wait();
+
+    const std::vector<const CacheRecord*> records{ checker.records() };
+    const std::vector<std::string> errors{ checker.errors() };
+
+    FastWriter out{ STDOUT_FILENO, FlushPolicy::whenFull };
+    bool anyViolations{ false };
+    for (const CacheRecord* record : records)
+    {
+        for (const NamingViolation& violation : record->analysis.violations)
+        {
+            out << record->path << ':' << violation.line << ':' << violation.column << ": " << violation.name << ": "
+                << describe(violation.rule) << '\n';
+            anyViolations = true;
+        }
+    }
+    out.flush();
+
+    FastWriter errorOut{ STDERR_FILENO, FlushPolicy::whenFull };
+    for (const std::string& error : errors)
+        errorOut << "naming-check: " << error << '\n';
+
+    if (cachePath && checker.cacheOutdated(records.size()))
+    {
+        cache.reset(); // unmap the old cache before replacing it
+        if (!saveAnalysisCache(cachePath, records))
+            errorOut << "naming-check: couldn't write " << cachePath << ": " << std::generic_category().message(errno) << '\n';
+    }
+
+    if (showStats)
+    {
+        // Totals over the whole tree can pass 2^32, unlike one file's counts.
+        std::uint64_t identifiers{ 0 };
+        std::uint64_t keywordUses{ 0 };
+        std::uint64_t contextualKeywords{ 0 };
+        std::uint64_t numbers{ 0 };
+        std::array<std::uint64_t, keywords.size()> byKeyword{ };
+        for (const CacheRecord* record : records)
+        {
+            const WordCounts& counts{ record->analysis.counts };
+            identifiers += counts.identifiers;
+            keywordUses += counts.keywords;
+            contextualKeywords += counts.contextualKeywords;
+            numbers += counts.numbers;
+            for (std::size_t i{ 0 }; i < counts.byKeyword.size(); ++i)
+                byKeyword[i] += counts.byKeyword[i];
+        }
+
+        const std::size_t cached{ checker.fromCache() };
+        errorOut << records.size() << " files: " << records.size() - cached << " analyzed, " << cached
+                 << " from the cache\n";
+        errorOut << identifiers << " identifiers, " << keywordUses << " keywords, " << contextualKeywords
+                 << " contextual keywords, " << numbers << " numbers\n";
+
+        std::vector<std::size_t> order(keywords.size());
+        for (std::size_t i{ 0 }; i < order.size(); ++i)
+            order[i] = i;
+        std::stable_sort(order.begin(), order.end(),
+                         [&](std::size_t a, std::size_t b) { return byKeyword[a] > byKeyword[b]; });
+        for (const std::size_t index : order)
+        {
+            if (byKeyword[index] != 0)
+                errorOut << "    " << keywords[index] << ' ' << byKeyword[index] << '\n';
+        }
+    }
+    errorOut.flush();
+
+    if (!errors.empty())
+        return 2;
+    return anyViolations ? 1 : 0;
+}
@@ -0,0 +1,422 @@
+#ifndef NAMING_RULES_H
+#define NAMING_RULES_H
+
+//** Checking a source file against the naming best practices **//
+
+// keywords-identifiers.cpp recommends some conventions on top of the rules the compiler enforces:
+    // variable and function names start with a lowercase letter
+    // type names (structs, classes, enumerations) start with an uppercase letter
+    // multi-word names use camelCase or snake_case, consistently within a program
+    // names don't start with an underscore
+// checkNaming() finds the names a file declares and reports those that break a convention (analyzeNaming() also
+// counts the file's identifiers, keywords and numbers):
+
+//     for (const NamingViolation& violation : checkNaming(source))
+//         std::cout << violation.line << ':' << violation.column << ": " << describe(violation.rule) << '\n';
+
+// This is not a C++ parser. It looks at each word from lexWords() (identifier-lexer.h) and its neighbours:
+    // a type is the word after class, struct, union, enum, concept or typename, or after using when followed by =
+    // a variable or function is a word after a type (a keyword like int, or another identifier, possibly with *, &
+    // or a closing >), followed by one of { ( = ; , [ )
+// That catches the usual declarations (int numberOfChars;  std::vector<int> values(count);  void print(int x))
+// while staying fast enough to run over a whole source tree. Preprocessor lines are skipped, and so are names
+// followed by :: (qualifiers, not declarations), constructors after a template <...> header, and functions marked
+// override (their name comes from the base class). A name declared by a typedef at the start of a statement is a
+// type, and so are member types the standard library asks for by name (value_type, iterator, promise_type, rebind
+// and the like), which aren't reported for starting with a lowercase letter.
+
+// Consistency is judged per file: if a file declares both camelCase and snake_case names, the less common style is
+// reported (on a tie, snake_case, since camelCase is what keywords-identifiers.cpp uses). A one-letter scope prefix
+// like the m_ in m_count isn't counted as part of the style.
+
+#include <array>
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <string>
+#include <string_view>
+#include <vector>
+
+#include "identifier-lexer.h"
+
+enum class NamingRule
+{
+    typeStartsLowercase,
+    nameStartsUppercase,
+    leadingUnderscore,
+    mixedCaseStyle,
+};
+
+struct NamingViolation
+{
+    std::size_t line{ };   // 1-based
+    std::size_t column{ }; // 1-based, in bytes
+    std::string name{ };
+    NamingRule rule{ };
+};
+
+// What the words of a file (outside preprocessor lines) are.
+struct WordCounts
+{
+    std::uint32_t identifiers{ 0 };
+    std::uint32_t keywords{ 0 };
+    std::uint32_t contextualKeywords{ 0 };
+    std::uint32_t numbers{ 0 };
+    std::array<std::uint32_t, ::keywords.size()> byKeyword{ }; // indexed like keywords (keywords.h)
+};
+
+struct NamingAnalysis
+{
+    WordCounts counts{ };
+    std::vector<NamingViolation> violations{ };
+};
+
+// Increased whenever the rules change, so results saved by an older version (see analysis-cache.h) aren't reused.
+constexpr std::uint32_t namingRulesVersion{ 2 };
+
+constexpr std::string_view describe(NamingRule rule)
+{
+    switch (rule)
+    {
+    case NamingRule::typeStartsLowercase:
+        return "type names should start with an uppercase letter";
+    case NamingRule::nameStartsUppercase:
+        return "variable and function names should start with a lowercase letter";
+    case NamingRule::leadingUnderscore:
+        return "names starting with an underscore are reserved";
+    case NamingRule::mixedCaseStyle:
+        return "this file mostly uses the other of camelCase and snake_case";
+    }
+    return "";
+}
+
+namespace namingRulesDetail
+{
+    inline bool isUpper(char c) { return c >= 'A' && c <= 'Z'; }
+    inline bool isLower(char c) { return c >= 'a' && c <= 'z'; }
+    inline bool isSpace(char c) { return c == ' ' || c == '\t' || c == '\n' || c == '\r' || c == '\f' || c == '\v'; }
+
+    enum class CaseStyle
+    {
+        none, // one word, or ALL_CAPS
+        camel,
+        snake,
+    };
+
+    inline CaseStyle caseStyle(std::string_view name)
+    {
+        if (name.size() > 2 && isLower(name[0]) && name[1] == '_')
+            name.remove_prefix(2); // m_count, s_instance, g_total
+
+        bool lower{ false };
+        bool upperAfterLower{ false };
+        bool innerUnderscore{ false };
+        for (std::size_t i{ 0 }; i < name.size(); ++i)
+        {
+            lower = lower || isLower(name[i]);
+            upperAfterLower = upperAfterLower || (isUpper(name[i]) && i > 0 && isLower(name[i - 1]));
+            innerUnderscore = innerUnderscore || (name[i] == '_' && i > 0 && i + 1 < name.size());
+        }
+        if (!lower)
+            return CaseStyle::none;
+        if (innerUnderscore)
+            return CaseStyle::snake;
+        return upperAfterLower ? CaseStyle::camel : CaseStyle::none;
+    }
+
+    inline bool isTypeKeyword(std::string_view word)
+    {
+        constexpr std::string_view typeKeywords[]{
+            "auto", "bool", "char", "char8_t", "char16_t", "char32_t", "double", "float",
+            "int", "long", "short", "signed", "unsigned", "void", "wchar_t",
+        };
+        for (const std::string_view keyword : typeKeywords)
+        {
+            if (word == keyword)
+                return true;
+        }
+        return false;
+    }
+
+    inline bool introducesType(std::string_view word)
+    {
+        return word == "class" || word == "struct" || word == "union" || word == "enum" || word == "concept"
+               || word == "typename";
+    }
+
+    // Whether text (usually the few characters between two words) ends a statement or opens or closes a block.
+    inline bool endsStatement(std::string_view text)
+    {
+        for (const char c : text)
+        {
+            if (c == ';' || c == '{' || c == '}')
+                return true;
+        }
+        return false;
+    }
+
+    // Whether a word preceded by text starts a statement: text ends one, or ends a label like public:.
+    inline bool startsStatement(std::string_view text)
+    {
+        for (std::size_t i{ text.size() }; i-- > 0;)
+        {
+            if (text[i] == ':')
+                return i == 0 || text[i - 1] != ':';
+            if (!isSpace(text[i]))
+                return endsStatement(text);
+        }
+        return false;
+    }
+
+    // Member type names the standard library looks for by name, so they can't follow the type naming convention.
+    inline bool isStandardMemberType(std::string_view name)
+    {
+        constexpr std::string_view names[]{
+            "promise_type", "iterator", "const_iterator", "value_type", "difference_type", "size_type", "reference",
+            "const_reference", "pointer", "const_pointer", "iterator_category", "iterator_concept", "element_type",
+            "allocator_type", "rebind", "other", "is_transparent", "type",
+        };
+        for (const std::string_view standard : names)
+        {
+            if (name == standard)
+                return true;
+        }
+        return false;
+    }
+
+    inline bool isAllSpace(std::string_view text)
+    {
+        for (const char c : text)
+        {
+            if (!isSpace(c))
+                return false;
+        }
+        return true;
+    }
+
+    // What lies between a type and a declared name: optional closing >s right after the type, then spaces and
+    // pointer or reference marks. A * or & with spaces on both sides is more likely multiplication or bitwise and.
+    inline bool looksLikeDeclarator(std::string_view between)
+    {
+        std::size_t i{ 0 };
+        while (i < between.size() && between[i] == '>')
+            ++i;
+        bool sawSpace{ i > 0 };
+        for (; i < between.size(); ++i)
+        {
+            const char c{ between[i] };
+            if (c == '*' || c == '&')
+            {
+                const bool spaceBefore{ i > 0 && isSpace(between[i - 1]) };
+                const bool spaceAfter{ i + 1 < between.size() && isSpace(between[i + 1]) };
+                if (spaceBefore && spaceAfter)
+                    return false;
+                sawSpace = true;
+            }
+            else if (isSpace(c))
+                sawSpace = true;
+            else
+                return false;
+        }
+        return sawSpace;
+    }
+
+    inline bool endsDeclarator(char c)
+    {
+        return c == '{' || c == '(' || c == '=' || c == ';' || c == ',' || c == '[' || c == ')';
+    }
+
+    // What may follow a name being declared as a type (including template parameters like typename T = int).
+    inline bool endsTypeName(char c)
+    {
+        return c == '{' || c == ':' || c == ';' || c == '<' || c == '>' || c == ',' || c == '=';
+    }
+
+    // The offset of the > closing the < at position, or npos.
+    inline std::size_t findClosingAngle(std::string_view source, std::size_t position)
+    {
+        int depth{ 0 };
+        for (; position < source.size(); ++position)
+        {
+            const char c{ source[position] };
+            if (c == '<')
+                ++depth;
+            else if (c == '>' && --depth == 0)
+                return position;
+            else if (c == ';' || c == '{')
+                break;
+        }
+        return std::string_view::npos;
+    }
+
+    // Whether the function declared by tokens[i] is marked override: its name is then chosen by the base class.
+    inline bool overrides(std::string_view source, const std::vector<Token>& tokens, std::size_t i)
+    {
+        constexpr std::size_t lookahead{ 32 };
+        for (std::size_t j{ i + 1 }; j < tokens.size() && j <= i + lookahead; ++j)
+        {
+            const std::size_t previousEnd{ tokens[j - 1].offset + tokens[j - 1].text.size() };
+            if (endsStatement(source.substr(previousEnd, tokens[j].offset - previousEnd)))
+                return false;
+            if (tokens[j].text == "override")
+                return true;
+        }
+        return false;
+    }
+
+    struct Declaration
+    {
+        std::size_t offset{ };
+        std::string_view name{ };
+        bool isType{ };
+    };
+}
+
+// The words of one source file and its naming violations, in the order they appear.
+inline NamingAnalysis analyzeNaming(std::string_view source)
+{
+    using namespace namingRulesDetail;
+
+    NamingAnalysis analysis{ };
+    WordCounts& counts{ analysis.counts };
+
+    // The words outside preprocessor lines (a directive continues onto the next line after a backslash).
+    std::vector<Token> tokens{ };
+    std::size_t scanned{ 0 };
+    bool inDirective{ false };
+    auto startsDirective{ [&](std::size_t lineStart) {
+        while (lineStart < source.size() && (source[lineStart] == ' ' || source[lineStart] == '\t'))
+            ++lineStart;
+        return lineStart < source.size() && source[lineStart] == '#';
+    } };
+    inDirective = startsDirective(0);
+    lexWords(source, [&](const Token& token) {
+        while (const void* found{ std::memchr(source.data() + scanned, '\n', token.offset - scanned) })
+        {
+            const std::size_t newline{ static_cast<std::size_t>(static_cast<const char*>(found) - source.data()) };
+            if (!(inDirective && newline > 0 && source[newline - 1] == '\\'))
+                inDirective = startsDirective(newline + 1);
+            scanned = newline + 1;
+        }
+        scanned = token.offset;
+        if (inDirective)
+            return;
+
+        tokens.push_back(token);
+        switch (token.kind)
+        {
+        case TokenKind::identifier:
+            ++counts.identifiers;
+            break;
+        case TokenKind::keyword:
+            ++counts.keywords;
+            ++counts.byKeyword[keywordIndex(token.text)];
+            break;
+        case TokenKind::contextualKeyword:
+            ++counts.contextualKeywords;
+            break;
+        case TokenKind::number:
+            ++counts.numbers;
+            break;
+        }
+    });
+
+    std::vector<Declaration> declarations{ };
+    bool inTypedef{ false };
+    std::size_t templateHeaderEnd{ std::string_view::npos }; // where the last template <...> closes
+    for (std::size_t i{ 0 }; i < tokens.size(); ++i)
+    {
+        const Token& token{ tokens[i] };
+        const std::size_t end{ token.offset + token.text.size() };
+        const std::size_t previousEnd{ i > 0 ? tokens[i - 1].offset + tokens[i - 1].text.size() : 0 };
+        const std::string_view between{ source.substr(previousEnd, token.offset - previousEnd) };
+
+        std::size_t after{ end };
+        while (after < source.size() && isSpace(source[after]))
+            ++after;
+        const char next{ after < source.size() ? source[after] : ';' };
+
+        if (endsStatement(between))
+            inTypedef = false;
+        if (token.text == "typedef" && (i == 0 || startsStatement(between)))
+            inTypedef = true; // not when it's just a word, as in the list of keywords in keywords-identifiers.cpp
+        if (token.text == "template" && next == '<')
+            templateHeaderEnd = findClosingAngle(source, after);
+        if (token.kind != TokenKind::identifier || i == 0)
+            continue;
+        if (next == ':' && after + 1 < source.size() && source[after + 1] == ':')
+            continue;
+
+        const Token& previous{ tokens[i - 1] };
+        const bool onlySpace{ isAllSpace(between) };
+        const bool afterTemplateHeader{ templateHeaderEnd >= previousEnd && templateHeaderEnd < token.offset };
+        if (previous.kind == TokenKind::keyword && introducesType(previous.text) && onlySpace)
+        {
+            // struct Name { ... }, class Name : Base, template <typename T>; but not struct stat& info.
+            if (endsTypeName(next) || (i + 1 < tokens.size() && tokens[i + 1].text == "final"))
+                declarations.push_back({ token.offset, token.text, true });
+        }
+        else if (previous.text == "using" && next == '=')
+        {
+            declarations.push_back({ token.offset, token.text, true });
+        }
+        else if (endsDeclarator(next) && looksLikeDeclarator(between) && !afterTemplateHeader
+                 && (previous.kind == TokenKind::identifier || isTypeKeyword(previous.text))
+                 && !(next == '(' && overrides(source, tokens, i)))
+        {
+            declarations.push_back({ token.offset, token.text, inTypedef });
+            inTypedef = false;
+        }
+    }
+
+    std::size_t camelCount{ 0 };
+    std::size_t snakeCount{ 0 };
+    for (const Declaration& declaration : declarations)
+    {
+        if (declaration.isType)
+            continue;
+        const CaseStyle style{ caseStyle(declaration.name) };
+        camelCount += style == CaseStyle::camel;
+        snakeCount += style == CaseStyle::snake;
+    }
+    const CaseStyle minority{ (camelCount == 0 || snakeCount == 0) ? CaseStyle::none
+                              : snakeCount <= camelCount           ? CaseStyle::snake
+                                                                   : CaseStyle::camel };
+
+    std::vector<NamingViolation>& violations{ analysis.violations };
+    std::size_t line{ 1 };
+    std::size_t lineStart{ 0 };
+    std::size_t counted{ 0 }; // newlines are counted up to here
+    for (const Declaration& declaration : declarations)
+    {
+        const std::string_view name{ declaration.name };
+        NamingRule rule{ };
+        if (name[0] == '_')
+            rule = NamingRule::leadingUnderscore;
+        else if (declaration.isType && isLower(name[0]) && !isStandardMemberType(name))
+            rule = NamingRule::typeStartsLowercase;
+        else if (!declaration.isType && isUpper(name[0]))
+            rule = NamingRule::nameStartsUppercase;
+        else if (!declaration.isType && minority != CaseStyle::none && caseStyle(name) == minority)
+            rule = NamingRule::mixedCaseStyle;
+        else
+            continue;
+
+        while (const void* found{ std::memchr(source.data() + counted, '\n', declaration.offset - counted) })
+        {
+            ++line;
+            lineStart = static_cast<std::size_t>(static_cast<const char*>(found) - source.data()) + 1;
+            counted = lineStart;
+        }
+        violations.push_back({ line, declaration.offset - lineStart + 1, std::string{ name }, rule });
+    }
+    return analysis;
+}
+
+// Just the naming violations in one source file.
+inline std::vector<NamingViolation> checkNaming(std::string_view source)
+{
+    return analyzeNaming(source).violations;
+}
+
+#endif
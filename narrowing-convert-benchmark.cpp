@@ -0,0 +1,154 @@
+//** Benchmark: checked double-to-int conversion vs an unchecked cast **//
+
+// Build and run:
+//     g++ -std=c++20 -O2 narrowing-convert-benchmark.cpp -o narrowing-convert-benchmark
+//     ./narrowing-convert-benchmark [millions of values, default 16] [offending per million, default 1000]
+
+// The column is whole numbers in the range of int, with the given share of offending values (fractions, values out
+// of range, NaN) spread through it. Every kernel and policy must give the same ints and the same bitmap as the
+// scalar reference before anything is timed. The rows are:
+    // memcpy             copying the column's bytes: the memory bandwidth the others are measured against
+    // static_cast        an unchecked loop, out[i] = static_cast<int>(in[i]) (undefined for offending values)
+    // <kernel> <policy>  narrowToInts(), with the offending values recorded in a bitmap
+// The reject policy is timed on a column without offending values, since it stops at the first one.
+
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <limits>
+#include <random>
+#include <vector>
+
+#include "narrowing-convert.h"
+#include "uninitialized-storage.h"
+
+volatile int benchmarkSink{ };
+
+template <typename Run>
+double bestOf(int repetitions, Run&& run)
+{
+    double best{ 1e30 };
+    for (int i{ 0 }; i < repetitions; ++i)
+    {
+        const auto start{ std::chrono::steady_clock::now() };
+        run();
+        const std::chrono::duration<double> elapsed{ std::chrono::steady_clock::now() - start };
+        best = std::min(best, elapsed.count());
+    }
+    return best;
+}
+
+const char* policyName(NarrowingPolicy policy)
+{
+    switch (policy)
+    {
+    case NarrowingPolicy::reject: return "reject";
+    case NarrowingPolicy::saturate: return "saturate";
+    case NarrowingPolicy::truncateAndFlag: return "truncateAndFlag";
+    }
+    return "?";
+}
+
+const char* kernelName(NarrowingKernel kernel)
+{
+    switch (kernel)
+    {
+    case NarrowingKernel::scalar: return "scalar";
+    case NarrowingKernel::avx2: return "avx2";
+    case NarrowingKernel::avx512: return "avx512";
+    default: return "best";
+    }
+}
+
+void report(const char* name, double seconds, std::size_t count)
+{
+    std::printf("%-28s %8.2f ms %8.2f GB/s read %7.3f ns/value\n", name, seconds * 1e3,
+                count * sizeof(double) / seconds / 1e9, seconds * 1e9 / count);
+}
+
+int main(int argc, char* argv[])
+{
+    const std::size_t count{ static_cast<std::size_t>((argc > 1 ? std::atof(argv[1]) : 16) * 1e6) };
+    const double offendingShare{ (argc > 2 ? std::atof(argv[2]) : 1000) / 1e6 };
+    constexpr int repetitions{ 5 };
+
+    std::mt19937_64 random{ 12345 };
+    std::uniform_int_distribution<int> wholeNumbers{ std::numeric_limits<int>::min(), std::numeric_limits<int>::max() };
+    std::uniform_real_distribution<double> unit{ 0, 1 };
+    const double offendingValues[]{ 4.5, -0.25, 3e9, -1e12, std::numeric_limits<double>::infinity(), std::nan("") };
+
+    std::vector<double> clean(count);
+    for (double& value : clean)
+        value = wholeNumbers(random);
+    std::vector<double> mixed{ clean };
+    for (double& value : mixed)
+    {
+        if (unit(random) < offendingShare)
+            value = offendingValues[random() % std::size(offendingValues)];
+    }
+
+    UninitializedVector<int> out(count);
+    UninitializedVector<int> reference(count);
+    std::vector<std::uint64_t> bitmap(narrowingBitmapWords(count));
+    std::vector<std::uint64_t> referenceBitmap(narrowingBitmapWords(count));
+
+    std::vector<NarrowingKernel> kernels{ NarrowingKernel::scalar };
+    __builtin_cpu_init();
+    if (__builtin_cpu_supports("avx2"))
+        kernels.push_back(NarrowingKernel::avx2);
+    if (__builtin_cpu_supports("avx512f"))
+        kernels.push_back(NarrowingKernel::avx512);
+    const NarrowingPolicy policies[]{ NarrowingPolicy::reject, NarrowingPolicy::saturate,
+                                      NarrowingPolicy::truncateAndFlag };
+
+    // Every kernel must agree with the scalar one before anything is timed.
+    for (const NarrowingPolicy policy : policies)
+    {
+        const std::vector<double>& column{ policy == NarrowingPolicy::reject ? clean : mixed };
+        const NarrowingResult expected{ narrowToInts(column.data(), count, reference.data(), policy,
+                                                     referenceBitmap.data(), NarrowingKernel::scalar) };
+        for (const NarrowingKernel kernel : kernels)
+        {
+            const NarrowingResult result{ narrowToInts(column.data(), count, out.data(), policy, bitmap.data(),
+                                                       kernel) };
+            if (result.count != expected.count || result.offending != expected.offending
+                || !std::equal(out.begin(), out.begin() + result.count, reference.begin())
+                || bitmap != referenceBitmap)
+            {
+                std::printf("MISMATCH: %s %s\n", kernelName(kernel), policyName(policy));
+                return 1;
+            }
+        }
+        std::printf("%s: %zu of %zu values offending\n", policyName(policy), expected.offending, count);
+    }
+    std::printf("\n");
+
+    std::vector<double> copy(count);
+    report("memcpy", bestOf(repetitions, [&] {
+               std::memcpy(copy.data(), mixed.data(), count * sizeof(double));
+               benchmarkSink = static_cast<int>(copy[count / 2]);
+           }), count);
+    report("static_cast", bestOf(repetitions, [&] {
+               for (std::size_t i{ 0 }; i < count; ++i)
+                   out[i] = static_cast<int>(clean[i]);
+               benchmarkSink = out[count / 2];
+           }), count);
+
+    for (const NarrowingKernel kernel : kernels)
+    {
+        for (const NarrowingPolicy policy : policies)
+        {
+            const std::vector<double>& column{ policy == NarrowingPolicy::reject ? clean : mixed };
+            char name[64]{ };
+            std::snprintf(name, sizeof(name), "%s %s", kernelName(kernel), policyName(policy));
+            report(name, bestOf(repetitions, [&] {
+                       benchmarkSink = static_cast<int>(
+                           narrowToInts(column.data(), count, out.data(), policy, bitmap.data(), kernel).offending);
+                   }), count);
+        }
+    }
+    return 0;
+}
@@ -0,0 +1,282 @@
+#ifndef NARROWING_CONVERT_H
+#define NARROWING_CONVERT_H
+
+//** Converting doubles to ints without silently losing anything **//
+
+// assignment-initilization.cpp shows that int width{ 4.5 }; doesn't compile: brace initialization refuses a
+// conversion that could lose data. A value that only arrives at run time gets no such check, and
+// static_cast<int>(4.5) quietly gives 4 (and static_cast<int>(1e10) is undefined behaviour).
+
+// narrowToInts() converts a whole column of doubles to ints and checks every value on the way. A value converts
+// exactly if it is a whole number within the range of int; anything else (a fraction, something too big or too
+// small, infinity, NaN) is "offending", and the policy says what happens to it:
+    // reject             stop at the first offending value, like a brace initialization that doesn't compile
+    // saturate           clamp to INT_MIN or INT_MAX, drop any fraction, and turn NaN into 0
+    // truncateAndFlag    drop any fraction, as static_cast does; values outside int's range and NaN become INT_MIN
+// Whatever the policy, the indices of offending values can be recorded in a bitmap, one bit per value:
+
+//     std::vector<std::uint64_t> offending(narrowingBitmapWords(count));
+//     const NarrowingResult result{ narrowToInts(values, count, ints, NarrowingPolicy::saturate, offending.data()) };
+//     if (result.offending != 0)
+//         ... // bit i % 64 of offending[i / 64] is set for each value i that didn't convert exactly
+
+// The check costs about as much as the conversion itself: the SIMD kernels convert 4 or 8 values at once, convert
+// them back, and compare with the originals (a value is exact if and only if the round trip gives it back), so a
+// whole column is checked at close to the speed of reading it from memory. AVX2 and AVX-512 versions are
+// picked at run time on CPUs that have them; the scalar version is the reference.
+
+#include <bit>
+#include <climits>
+#include <cstddef>
+#include <cstdint>
+
+#if defined(__x86_64__) || defined(_M_X64)
+#define NARROWING_CONVERT_X86 1
+#include <immintrin.h>
+#endif
+
+enum class NarrowingPolicy
+{
+    reject,
+    saturate,
+    truncateAndFlag,
+};
+
+enum class NarrowingKernel
+{
+    best,
+    scalar,
+    avx2,
+    avx512,
+};
+
+struct NarrowingResult
+{
+    std::size_t count{ };     // values converted: all of them, unless the reject policy stopped at an offending one
+    std::size_t offending{ }; // values among those (or the one stopped at) that didn't convert exactly
+    bool stopped{ false };    // reject only: out[count] was not written, because in[count] doesn't fit in an int
+};
+
+// The number of 64-bit words a bitmap for count values needs.
+constexpr std::size_t narrowingBitmapWords(std::size_t count) { return (count + 63) / 64; }
+
+namespace narrowingDetail
+{
+    // INT_MAX + 1 is exactly representable, unlike INT_MAX + 0.5.
+    constexpr double intLimit{ 2147483648.0 };
+
+    inline bool isExact(double value)
+    {
+        return value >= -intLimit && value < intLimit && static_cast<double>(static_cast<int>(value)) == value;
+    }
+
+    template <NarrowingPolicy policy>
+    inline int convertOne(double value)
+    {
+        if constexpr (policy == NarrowingPolicy::saturate)
+        {
+            if (value != value)
+                return 0;
+            if (value <= -intLimit)
+                return INT_MIN;
+            if (value >= intLimit - 1)
+                return INT_MAX;
+            return static_cast<int>(value);
+        }
+        else
+        {
+            // What cvttsd2si does: anything whose truncation doesn't fit gives INT_MIN.
+            if (value > -intLimit - 1 && value < intLimit)
+                return static_cast<int>(value);
+            return INT_MIN;
+        }
+    }
+
+    // Convert count values (at most 64) one at a time; bit i of the result is set if in[i] is offending.
+    template <NarrowingPolicy policy>
+    inline std::uint64_t convertScalar(const double* in, int* out, std::size_t count)
+    {
+        std::uint64_t offending{ 0 };
+        for (std::size_t i{ 0 }; i < count; ++i)
+        {
+            const bool exact{ isExact(in[i]) };
+            offending |= static_cast<std::uint64_t>(!exact) << i;
+            if (policy == NarrowingPolicy::reject && !exact)
+                break;
+            out[i] = convertOne<policy>(in[i]);
+        }
+        return offending;
+    }
+
+    struct ScalarConvert
+    {
+        template <NarrowingPolicy policy>
+        static std::uint64_t chunk(const double* in, int* out)
+        {
+            return convertScalar<policy>(in, out, 64);
+        }
+    };
+
+#ifdef NARROWING_CONVERT_X86
+    struct Avx2Convert
+    {
+        template <NarrowingPolicy policy>
+        [[gnu::target("avx2")]] static std::uint64_t chunk(const double* in, int* out)
+        {
+            std::uint64_t offending{ 0 };
+            for (int i{ 0 }; i < 64; i += 4)
+            {
+                const __m256d values{ _mm256_loadu_pd(in + i) };
+                const __m128i truncated{ _mm256_cvttpd_epi32(values) };
+                const __m256d exact{ _mm256_cmp_pd(_mm256_cvtepi32_pd(truncated), values, _CMP_EQ_OQ) };
+                offending |= static_cast<std::uint64_t>(~_mm256_movemask_pd(exact) & 0xF) << i;
+
+                __m128i converted{ truncated };
+                if constexpr (policy == NarrowingPolicy::saturate)
+                {
+                    // NaN to 0 (an ordered compare is false only for NaN), then clamp before converting.
+                    const __m256d ordered{ _mm256_and_pd(values, _mm256_cmp_pd(values, values, _CMP_ORD_Q)) };
+                    const __m256d clamped{ _mm256_min_pd(_mm256_max_pd(ordered, _mm256_set1_pd(-intLimit)),
+                                                         _mm256_set1_pd(intLimit - 1)) };
+                    converted = _mm256_cvttpd_epi32(clamped);
+                }
+                _mm_storeu_si128(reinterpret_cast<__m128i*>(out + i), converted);
+            }
+            return offending;
+        }
+    };
+
+    // GCC 12 warns about the intrinsics' own deliberately undefined vectors under -Wall; the warning is spurious.
+#pragma GCC diagnostic push
+#pragma GCC diagnostic ignored "-Wmaybe-uninitialized"
+    struct Avx512Convert
+    {
+        template <NarrowingPolicy policy>
+        [[gnu::target("avx512f")]] static std::uint64_t chunk(const double* in, int* out)
+        {
+            std::uint64_t offending{ 0 };
+            for (int i{ 0 }; i < 64; i += 8)
+            {
+                const __m512d values{ _mm512_loadu_pd(in + i) };
+                const __m256i truncated{ _mm512_cvttpd_epi32(values) };
+                const __mmask8 exact{ _mm512_cmp_pd_mask(_mm512_cvtepi32_pd(truncated), values, _CMP_EQ_OQ) };
+                offending |= static_cast<std::uint64_t>(static_cast<std::uint8_t>(~exact)) << i;
+
+                __m256i converted{ truncated };
+                if constexpr (policy == NarrowingPolicy::saturate)
+                {
+                    const __mmask8 ordered{ _mm512_cmp_pd_mask(values, values, _CMP_ORD_Q) };
+                    const __m512d clamped{ _mm512_min_pd(
+                        _mm512_max_pd(_mm512_maskz_mov_pd(ordered, values), _mm512_set1_pd(-intLimit)),
+                        _mm512_set1_pd(intLimit - 1)) };
+                    converted = _mm512_cvttpd_epi32(clamped);
+                }
+                _mm256_storeu_si256(reinterpret_cast<__m256i*>(out + i), converted);
+            }
+            return offending;
+        }
+    };
+#pragma GCC diagnostic pop
+#endif
+
+    // The shared walker: whole chunks of 64 values with the kernel, then the rest one at a time.
+    template <typename Convert, NarrowingPolicy policy>
+    [[gnu::always_inline]] inline NarrowingResult convertChunks(const double* in, std::size_t count, int* out,
+                                                                std::uint64_t* offendingBits)
+    {
+        NarrowingResult result{ };
+        for (std::size_t first{ 0 }; first < count; first += 64)
+        {
+            const std::size_t size{ count - first < 64 ? count - first : 64 };
+            std::uint64_t offending{ size == 64 ? Convert::template chunk<policy>(in + first, out + first)
+                                                : convertScalar<policy>(in + first, out + first, size) };
+            if (policy == NarrowingPolicy::reject && offending != 0)
+            {
+                // The kernel wrote the whole chunk, but only the values before the first offending one count.
+                offending &= -offending;
+                result.count = first + static_cast<std::size_t>(std::countr_zero(offending));
+                result.offending = 1;
+                result.stopped = true;
+                if (offendingBits)
+                    offendingBits[first / 64] = offending;
+                return result;
+            }
+            result.offending += static_cast<std::size_t>(std::popcount(offending));
+            if (offendingBits)
+                offendingBits[first / 64] = offending;
+        }
+        result.count = count;
+        return result;
+    }
+
+    template <typename Convert>
+    [[gnu::always_inline]] inline NarrowingResult convertWith(const double* in, std::size_t count, int* out, NarrowingPolicy policy,
+                                       std::uint64_t* offendingBits)
+    {
+        switch (policy)
+        {
+        case NarrowingPolicy::reject:
+            return convertChunks<Convert, NarrowingPolicy::reject>(in, count, out, offendingBits);
+        case NarrowingPolicy::saturate:
+            return convertChunks<Convert, NarrowingPolicy::saturate>(in, count, out, offendingBits);
+        default:
+            return convertChunks<Convert, NarrowingPolicy::truncateAndFlag>(in, count, out, offendingBits);
+        }
+    }
+
+#ifdef NARROWING_CONVERT_X86
+    [[gnu::target("avx2")]] inline NarrowingResult convertAvx2(const double* in, std::size_t count, int* out,
+                                                               NarrowingPolicy policy, std::uint64_t* offendingBits)
+    {
+        return convertWith<Avx2Convert>(in, count, out, policy, offendingBits);
+    }
+
+    [[gnu::target("avx512f")]] inline NarrowingResult convertAvx512(const double* in, std::size_t count, int* out,
+                                                                    NarrowingPolicy policy,
+                                                                    std::uint64_t* offendingBits)
+    {
+        return convertWith<Avx512Convert>(in, count, out, policy, offendingBits);
+    }
+#endif
+}
+
+// The fastest kernel the running CPU supports.
+inline NarrowingKernel bestNarrowingKernel()
+{
+    static const NarrowingKernel best{ [] {
+#ifdef NARROWING_CONVERT_X86
+        __builtin_cpu_init();
+        if (__builtin_cpu_supports("avx512f"))
+            return NarrowingKernel::avx512;
+        if (__builtin_cpu_supports("avx2"))
+            return NarrowingKernel::avx2;
+#endif
+        return NarrowingKernel::scalar;
+    }() };
+    return best;
+}
+
+// Convert in[0] ... in[count - 1] into out, handling values that don't fit in an int according to policy. If
+// offendingBits isn't null it must have room for narrowingBitmapWords(count) words; each word that covers a
+// converted value is overwritten, with bit i % 64 of word i / 64 set if in[i] was offending. When reject stops,
+// values after out[result.count] may have been written as well.
+inline NarrowingResult narrowToInts(const double* in, std::size_t count, int* out, NarrowingPolicy policy,
+                                    std::uint64_t* offendingBits = nullptr,
+                                    NarrowingKernel kernel = NarrowingKernel::best)
+{
+    using namespace narrowingDetail;
+
+    switch (kernel == NarrowingKernel::best ? bestNarrowingKernel() : kernel)
+    {
+#ifdef NARROWING_CONVERT_X86
+    case NarrowingKernel::avx512:
+        return convertAvx512(in, count, out, policy, offendingBits);
+    case NarrowingKernel::avx2:
+        return convertAvx2(in, count, out, policy, offendingBits);
+#endif
+    default:
+        return convertWith<ScalarConvert>(in, count, out, policy, offendingBits);
+    }
+}
+
+#endif
@@ -0,0 +1,188 @@
+//** number-convert: convert numbers between decimal text and binary number files **//
+
+// Build and run:
+//     g++ -std=c++20 -O2 -pthread number-convert.cpp -o number-convert
+//     ./number-convert [--fixed] [--doubles] input output
+
+// If input is a number file (number-file.h), its values are written to output as text, one per line (doubles in
+// the shortest form that reads back as the same double). Otherwise input is read as whitespace-separated text and
+// output becomes a number file: of ints (read like std::cin >> x, with loadInts from parallel-load.h), stored
+// as delta varints, or with --fixed as plain 4-byte values; or with --doubles, of doubles (read like
+// std::cin >> width, with parseDouble from fast-double.h), always stored as plain 8-byte values.
+
+// Either way, converting the output back gives the input's numbers exactly. Text that stops being numbers part way
+// through is an error (with the offset of the bad input), not a shorter file. Output of "-" means standard output.
+// The exit status is 0 on success, 1 if the input isn't valid, and 2 if a file couldn't be read or written.
+
+#include <cerrno>
+#include <cstddef>
+#include <cstdio>
+#include <cstring>
+#include <fcntl.h>
+#include <string>
+#include <string_view>
+#include <system_error>
+#include <unistd.h>
+
+#include "fast-double.h"
+#include "fast-output.h"
+#include "mapped-input.h"
+#include "number-file.h"
+#include "parallel-load.h"
+#include "thread-pool.h"
+#include "uninitialized-storage.h"
+
+bool isSpace(char c) { return c == ' ' || static_cast<unsigned char>(c - '\t') < 5; }
+
+void reportBadInput(const char* path, std::size_t offset)
+{
+    FastWriter{ STDERR_FILENO } << "number-convert: " << path << ": not a number at offset " << offset << '\n';
+}
+
+void reportSystemError(const char* path)
+{
+    const char* const reason{ std::strerror(errno) }; // before FastWriter's isatty() can change errno
+    FastWriter{ STDERR_FILENO } << "number-convert: " << path << ": " << reason << '\n';
+}
+
+// Write values as text, one per line.
+template <typename T>
+bool writeText(const char* path, const T* values, std::size_t count)
+{
+    const bool toStandardOutput{ std::strcmp(path, "-") == 0 };
+    const int fd{ toStandardOutput ? STDOUT_FILENO : ::open(path, O_WRONLY | O_CREAT | O_TRUNC | O_CLOEXEC, 0644) };
+    if (fd < 0)
+        return false;
+    bool ok{ };
+    {
+        FastWriter output{ fd, FlushPolicy::whenFull };
+        for (std::size_t i{ 0 }; i < count; ++i)
+            output << values[i] << '\n';
+        ok = output.flush();
+    }
+    return (toStandardOutput || ::close(fd) == 0) && ok;
+}
+
+bool writeBinary(const char* path, const std::string& bytes)
+{
+    if (std::strcmp(path, "-") != 0)
+        return saveNumberFile(path, bytes);
+    FastWriter output{ STDOUT_FILENO, FlushPolicy::whenFull };
+    output << std::string_view{ bytes };
+    return output.flush();
+}
+
+// Every double in text, or false (with the offset of the bad input) at the first thing that isn't one.
+bool parseDoubles(std::string_view text, UninitializedVector<double>& values, std::size_t& errorOffset)
+{
+    const char* p{ text.data() };
+    const char* const last{ text.data() + text.size() };
+    for (;;)
+    {
+        while (p != last && isSpace(*p))
+            ++p;
+        if (p == last)
+            return true;
+        double value{ };
+        const std::from_chars_result result{ parseDouble(p, last, value) };
+        if (result.ec != std::errc{ } || (result.ptr != last && !isSpace(*result.ptr)))
+        {
+            errorOffset = static_cast<std::size_t>(p - text.data());
+            return false;
+        }
+        values.push_back(value);
+        p = result.ptr;
+    }
+}
+
+int main(int argc, char* argv[])
+{
+    bool fixed{ false };
+    bool doubles{ false };
+    const char* paths[2]{ };
+    int pathCount{ 0 };
+    for (int i{ 1 }; i < argc; ++i)
+    {
+        const std::string_view argument{ argv[i] };
+        if (argument == "--fixed")
+            fixed = true;
+        else if (argument == "--doubles")
+            doubles = true;
+        else if (argument.starts_with("--") || pathCount == 2)
+            pathCount = 3; // too many, or unknown: fall through to the usage message
+        else
+            paths[pathCount++] = argv[i];
+    }
+    if (pathCount != 2)
+    {
+        FastWriter{ STDERR_FILENO } << "usage: number-convert [--fixed] [--doubles] input output\n";
+        return 2;
+    }
+    const char* const inputPath{ paths[0] };
+    const char* const outputPath{ paths[1] };
+
+    const MappedInput input{ inputPath };
+    const std::string_view text{ input.text() }; // the whole input, even from a pipe
+    if (!input)
+    {
+        reportSystemError(inputPath);
+        return 2;
+    }
+
+    bool written{ };
+    if (isNumberFile(text))
+    {
+        const NumberFile file{ text };
+        if (!file)
+        {
+            FastWriter{ STDERR_FILENO } << "number-convert: " << inputPath << ": damaged number file\n";
+            return 1;
+        }
+        if (file.column() == NumberColumn::int32)
+        {
+            UninitializedVector<int> values(file.size());
+            if (!file.readInts(values.data()))
+            {
+                FastWriter{ STDERR_FILENO } << "number-convert: " << inputPath << ": damaged number file\n";
+                return 1;
+            }
+            written = writeText(outputPath, values.data(), values.size());
+        }
+        else
+        {
+            UninitializedVector<double> values(file.size());
+            file.readDoubles(values.data());
+            written = writeText(outputPath, values.data(), values.size());
+        }
+    }
+    else if (doubles)
+    {
+        UninitializedVector<double> values{ };
+        std::size_t errorOffset{ 0 };
+        if (!parseDoubles(text, values, errorOffset))
+        {
+            reportBadInput(inputPath, errorOffset);
+            return 1;
+        }
+        written = writeBinary(outputPath, encodeDoubles(values.data(), values.size()));
+    }
+    else
+    {
+        ThreadPool pool{ };
+        const LoadResult load{ loadInts(text, pool) };
+        if (!load.ok)
+        {
+            reportBadInput(inputPath, load.errorOffset);
+            return 1;
+        }
+        const NumberEncoding encoding{ fixed ? NumberEncoding::fixed : NumberEncoding::deltaVarint };
+        written = writeBinary(outputPath, encodeInts(load.values.data(), load.values.size(), encoding));
+    }
+
+    if (!written)
+    {
+        reportSystemError(outputPath);
+        return 2;
+    }
+    return 0;
+}
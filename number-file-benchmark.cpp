@@ -0,0 +1,146 @@
+//** Benchmark: loading ints from text vs from binary number files **//
+
+// Build and run:
+//     g++ -std=c++20 -O2 -pthread number-file-benchmark.cpp -o number-file-benchmark
+//     ./number-file-benchmark [millions of numbers, default 20] [repetitions, default 5]
+
+// Two datasets are written in all three forms: decimal text (one number per line), a number file with the fixed
+// encoding, and one with delta varints (number-file.h):
+    // random   uniformly random ints from -1,000,000 to 1,000,000, the input of number-stream-benchmark.cpp
+    // steps    a sorted column, each value 0 to 200 more than the one before (timestamps, ids, offsets)
+// Each file is then loaded with loadIntFile (parallel-load.h), which parses the text and decodes the number
+// files, and every load must give back the original values. The files are in the page cache after the first
+// repetition, so the times are the cost of turning the bytes into ints, next to memcpy of the same ints as a floor.
+
+#include <algorithm>
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <fcntl.h>
+#include <random>
+#include <string>
+#include <sys/stat.h>
+#include <unistd.h>
+#include <vector>
+
+#include "fast-output.h"
+#include "number-file.h"
+#include "parallel-load.h"
+#include "thread-pool.h"
+#include "uninitialized-storage.h"
+
+volatile int benchmarkSink{ };
+
+template <typename Run>
+double bestOf(int repetitions, Run&& run)
+{
+    double best{ 1e30 };
+    for (int i{ 0 }; i < repetitions; ++i)
+    {
+        const auto start{ std::chrono::steady_clock::now() };
+        run();
+        const std::chrono::duration<double> elapsed{ std::chrono::steady_clock::now() - start };
+        best = std::min(best, elapsed.count());
+    }
+    return best;
+}
+
+std::size_t fileSize(const char* path)
+{
+    struct stat info{ };
+    return ::stat(path, &info) == 0 ? static_cast<std::size_t>(info.st_size) : 0;
+}
+
+bool writeText(const char* path, const std::vector<int>& values)
+{
+    const int fd{ ::open(path, O_WRONLY | O_CREAT | O_TRUNC, 0644) };
+    if (fd < 0)
+        return false;
+    bool ok{ };
+    {
+        FastWriter output{ fd, FlushPolicy::whenFull };
+        for (const int value : values)
+            output << value << '\n';
+        ok = output.flush();
+    }
+    return ::close(fd) == 0 && ok;
+}
+
+// Write values in all three forms, load each, and report sizes and times. False on any mismatch.
+bool run(const char* name, const std::vector<int>& values, ThreadPool& pool, int repetitions)
+{
+    const char* const paths[]{ "number-file-benchmark.txt", "number-file-benchmark-fixed.num",
+                               "number-file-benchmark-delta.num" };
+    const char* const forms[]{ "text", "fixed", "delta varint" };
+    if (!writeText(paths[0], values)
+        || !saveNumberFile(paths[1], encodeInts(values.data(), values.size(), NumberEncoding::fixed))
+        || !saveNumberFile(paths[2], encodeInts(values.data(), values.size(), NumberEncoding::deltaVarint)))
+    {
+        std::perror("number-file-benchmark");
+        return false;
+    }
+
+    std::printf("\n%s\n", name);
+    const std::size_t textSize{ fileSize(paths[0]) };
+    for (int form{ 0 }; form < 3; ++form)
+    {
+        LoadResult load{ };
+        const double seconds{ bestOf(repetitions, [&] {
+            loadIntFile(paths[form], pool, load);
+            benchmarkSink = load.values.empty() ? 0 : load.values[load.values.size() / 2];
+        }) };
+        if (!load.ok || load.values.size() != values.size()
+            || !std::equal(values.begin(), values.end(), load.values.begin()))
+        {
+            std::printf("MISMATCH: loading the %s file didn't give back the values written\n", forms[form]);
+            return false;
+        }
+        const std::size_t size{ fileSize(paths[form]) };
+        std::printf("%-14s %9.1f ms %6.2f ns/number %9.1f MB  %5.2f bytes/number  %4.1fx smaller than text\n",
+                    forms[form], seconds * 1e3, seconds * 1e9 / static_cast<double>(values.size()),
+                    static_cast<double>(size) / 1e6, static_cast<double>(size) / static_cast<double>(values.size()),
+                    static_cast<double>(textSize) / static_cast<double>(size));
+        std::remove(paths[form]);
+    }
+
+    UninitializedVector<int> copy{ };
+    const double seconds{ bestOf(repetitions, [&] {
+        copy.resize(0);
+        copy.shrink_to_fit();
+        copy.resize(values.size());
+        std::memcpy(copy.data(), values.data(), values.size() * sizeof(int));
+        benchmarkSink = copy[copy.size() / 2];
+    }) };
+    std::printf("%-14s %9.1f ms %6.2f ns/number\n", "memcpy", seconds * 1e3,
+                seconds * 1e9 / static_cast<double>(values.size()));
+    return true;
+}
+
+int main(int argc, char* argv[])
+{
+    const std::size_t count{ static_cast<std::size_t>((argc > 1 ? std::atof(argv[1]) : 20) * 1e6) };
+    const int repetitions{ argc > 2 ? std::atoi(argv[2]) : 5 };
+
+    std::mt19937 random{ 12345 };
+    std::vector<int> uniform(count);
+    std::uniform_int_distribution<int> anywhere{ -1'000'000, 1'000'000 };
+    for (int& value : uniform)
+        value = anywhere(random);
+
+    std::vector<int> steps(count);
+    std::uniform_int_distribution<int> step{ 0, 200 };
+    int current{ 0 };
+    for (int& value : steps)
+    {
+        current += step(random);
+        value = current;
+    }
+
+    ThreadPool pool{ };
+    std::printf("%zu numbers, %zu threads, best of %d\n", count, pool.threadCount(), repetitions);
+    std::printf("%-14s %12s %17s %12s\n", "", "load", "", "file");
+    if (!run("random", uniform, pool, repetitions) || !run("steps", steps, pool, repetitions))
+        return 1;
+    return 0;
+}
@@ -0,0 +1,305 @@
+#ifndef NUMBER_FILE_H
+#define NUMBER_FILE_H
+
+//** Storing numbers in binary, so they don't have to be parsed again **//
+
+// The programs in iostream.cpp read numbers as decimal text. That's the right format for input typed or produced
+// by people, but a dataset that is loaded over and over pays for parsing it every time, even with FastReader or
+// loadInts (parallel-load.h), and the text takes 7 or 8 bytes for a number like -123456.
+
+// A number file holds one column of ints or doubles in binary, after a small header:
+    // header:  magic, format version, byte order check, column type, encoding, count, payload size, checksum
+    // payload: the values, in one of two encodings
+// The encodings are:
+    // fixed        each value as it is in memory (4 bytes per int, 8 per double). Loading it is one memcpy.
+    // deltaVarint  ints only: each value minus the one before it, zigzag encoded (0, -1, 1, -2, 2 ... become 0, 1,
+    //              2, 3, 4 ...) so small negative differences stay small, then written 7 bits per byte with the top
+    //              bit meaning "more bytes follow". Sorted values, timestamps, counters and ids that move in small
+    //              steps take one or two bytes each instead of four.
+// The checksum is the xxHash64 (xxhash.h) of the payload, checked when the file is opened. Like analysis-cache.h,
+// the file is in the machine's byte order, and a file from a machine with the other byte order is rejected.
+
+//     const std::string bytes{ encodeInts(values.data(), values.size(), NumberEncoding::deltaVarint) };
+//     saveNumberFile("values.num", bytes);
+//     ...
+//     const MappedInput input{ "values.num" };
+//     const NumberFile file{ input.text() };
+//     if (file && file.column() == NumberColumn::int32)
+//         ... // file.readInts(out) fills out[0] ... out[file.size() - 1]
+
+// loadIntFile() (parallel-load.h) tells a number file from text by its first bytes and loads either, so programs
+// that load through it accept both. number-convert.cpp converts between text and number files.
+
+#include <bit>
+#include <cerrno>
+#include <cstddef>
+#include <cstdint>
+#include <cstdio>
+#include <cstring>
+#include <fcntl.h>
+#include <string>
+#include <string_view>
+#include <unistd.h>
+
+#include "xxhash.h"
+
+enum class NumberColumn : std::uint32_t
+{
+    int32 = 1,
+    float64 = 2,
+};
+
+enum class NumberEncoding : std::uint32_t
+{
+    fixed = 1,
+    deltaVarint = 2,
+};
+
+namespace numberFileDetail
+{
+    constexpr char magic[8]{ 'N', 'U', 'M', 'B', 'E', 'R', 'S', '\0' };
+    constexpr std::uint32_t formatVersion{ 1 };
+    constexpr std::uint32_t byteOrderCheck{ 0x01020304 };
+    constexpr std::size_t longestVarint{ 5 }; // 32 bits, 7 per byte
+
+    // 48 bytes, so the payload after it stays 8-byte aligned in a mapped file.
+    struct Header
+    {
+        char magic[8]{ };
+        std::uint32_t formatVersion{ };
+        std::uint32_t byteOrder{ };
+        NumberColumn column{ };
+        NumberEncoding encoding{ };
+        std::uint64_t count{ };
+        std::uint64_t payloadSize{ };
+        std::uint64_t checksum{ }; // xxHash64 of the payload
+    };
+
+    inline std::uint32_t zigzag(std::uint32_t delta) { return (delta << 1) ^ (0u - (delta >> 31)); }
+    inline std::uint32_t unzigzag(std::uint32_t encoded) { return (encoded >> 1) ^ (0u - (encoded & 1)); }
+
+    inline std::string withHeader(NumberColumn column, NumberEncoding encoding, std::size_t count, std::string payload)
+    {
+        Header header{ };
+        std::memcpy(header.magic, magic, sizeof(magic));
+        header.formatVersion = formatVersion;
+        header.byteOrder = byteOrderCheck;
+        header.column = column;
+        header.encoding = encoding;
+        header.count = count;
+        header.payloadSize = payload.size();
+        header.checksum = xxHash64(payload.data(), payload.size());
+
+        std::string file(sizeof(header), '\0');
+        std::memcpy(file.data(), &header, sizeof(header));
+        file += payload;
+        return file;
+    }
+
+    // One varint from the 8 bytes at p (the varint may be shorter), without a branch on its length: the first byte
+    // without the top bit ends it, and its 7-bit groups are shifted together. Sets length to 1 ... 8; more than
+    // longestVarint means the data is damaged.
+    inline std::uint32_t decodeVarint(const unsigned char* p, std::size_t& length)
+    {
+        std::uint64_t word{ };
+        std::memcpy(&word, p, sizeof(word));
+        if constexpr (std::endian::native == std::endian::big)
+            word = __builtin_bswap64(word);
+        const std::uint64_t ends{ ~word & 0x8080808080808080ULL };
+        length = ends ? static_cast<std::size_t>(std::countr_zero(ends)) / 8 + 1 : 8;
+        const std::uint64_t bytes{ length >= 8 ? word : word & ((std::uint64_t{ 1 } << (8 * length)) - 1) };
+        return static_cast<std::uint32_t>((bytes & 0x7F) | ((bytes >> 1) & 0x3F80) | ((bytes >> 2) & 0x1FC000)
+                                          | ((bytes >> 3) & 0xFE00000) | ((bytes >> 4) & 0xFF0000000));
+    }
+
+    // Decode count delta varints from [p, last) into out. False if they don't exactly fill the payload.
+    inline bool decodeDeltaVarints(const unsigned char* p, const unsigned char* last, int* out, std::size_t count)
+    {
+        std::uint32_t previous{ 0 };
+        std::size_t i{ 0 };
+        for (; i < count && last - p >= 8; ++i)
+        {
+            std::size_t length{ };
+            const std::uint32_t encoded{ decodeVarint(p, length) };
+            if (length > longestVarint)
+                return false;
+            p += length;
+            previous += unzigzag(encoded);
+            out[i] = static_cast<int>(previous);
+        }
+
+        // The last few, one byte at a time so nothing past the end is read.
+        for (; i < count; ++i)
+        {
+            std::uint32_t encoded{ 0 };
+            for (int shift{ 0 };; shift += 7)
+            {
+                if (p == last || shift == 7 * longestVarint)
+                    return false;
+                const std::uint32_t byte{ *p++ };
+                encoded |= (byte & 0x7F) << shift;
+                if (byte < 0x80)
+                    break;
+            }
+            previous += unzigzag(encoded);
+            out[i] = static_cast<int>(previous);
+        }
+        return p == last;
+    }
+}
+
+// The bytes of a number file holding count ints.
+inline std::string encodeInts(const int* values, std::size_t count, NumberEncoding encoding)
+{
+    using namespace numberFileDetail;
+
+    std::string payload{ };
+    if (encoding == NumberEncoding::fixed)
+        payload.assign(reinterpret_cast<const char*>(values), count * sizeof(int));
+    else
+    {
+        payload.resize(count * longestVarint);
+        unsigned char* const start{ reinterpret_cast<unsigned char*>(payload.data()) };
+        unsigned char* p{ start };
+        std::uint32_t previous{ 0 };
+        for (std::size_t i{ 0 }; i < count; ++i)
+        {
+            const std::uint32_t value{ static_cast<std::uint32_t>(values[i]) };
+            std::uint32_t encoded{ zigzag(value - previous) };
+            previous = value;
+            while (encoded >= 0x80)
+            {
+                *p++ = static_cast<unsigned char>(encoded | 0x80);
+                encoded >>= 7;
+            }
+            *p++ = static_cast<unsigned char>(encoded);
+        }
+        payload.resize(static_cast<std::size_t>(p - start));
+    }
+    return withHeader(NumberColumn::int32, encoding, count, std::move(payload));
+}
+
+// The bytes of a number file holding count doubles (always the fixed encoding).
+inline std::string encodeDoubles(const double* values, std::size_t count)
+{
+    return numberFileDetail::withHeader(NumberColumn::float64, NumberEncoding::fixed, count,
+                                        std::string(reinterpret_cast<const char*>(values), count * sizeof(double)));
+}
+
+// True if data starts like a number file (whether or not the rest of it is any good).
+inline bool isNumberFile(std::string_view data)
+{
+    return data.size() >= sizeof(numberFileDetail::magic)
+           && std::memcmp(data.data(), numberFileDetail::magic, sizeof(numberFileDetail::magic)) == 0;
+}
+
+// A number file held in memory (usually a MappedInput's text). The data isn't copied and must outlive this.
+class NumberFile
+{
+public:
+    // Checks the header and the checksum; a file that fails either is empty and false.
+    explicit NumberFile(std::string_view data)
+    {
+        using namespace numberFileDetail;
+
+        Header header{ };
+        if (!isNumberFile(data) || data.size() < sizeof(header))
+            return;
+        std::memcpy(&header, data.data(), sizeof(header));
+        const std::string_view payload{ data.substr(sizeof(header)) };
+        const bool fixed{ header.encoding == NumberEncoding::fixed };
+        const bool known{ header.column == NumberColumn::int32
+                          || (header.column == NumberColumn::float64 && fixed) };
+        if (header.formatVersion != formatVersion || header.byteOrder != byteOrderCheck || !known
+            || (!fixed && header.encoding != NumberEncoding::deltaVarint) || header.payloadSize != payload.size()
+            || (fixed && header.count != payload.size() / valueSize(header.column))
+            || (fixed && payload.size() % valueSize(header.column) != 0)
+            || (!fixed && header.count > payload.size()) // every varint takes at least a byte
+            || xxHash64(payload.data(), payload.size()) != header.checksum)
+        {
+            return;
+        }
+
+        m_column = header.column;
+        m_encoding = header.encoding;
+        m_count = header.count;
+        m_payload = payload;
+        m_ok = true;
+    }
+
+    explicit operator bool() const { return m_ok; }
+
+    NumberColumn column() const { return m_column; }
+    NumberEncoding encoding() const { return m_encoding; }
+    std::size_t size() const { return m_count; }
+
+    // Decode all size() values into out. False if the column holds doubles, or the values are damaged.
+    bool readInts(int* out) const
+    {
+        if (!m_ok || m_column != NumberColumn::int32)
+            return false;
+        if (m_encoding == NumberEncoding::fixed)
+        {
+            std::memcpy(out, m_payload.data(), m_payload.size());
+            return true;
+        }
+        const unsigned char* const first{ reinterpret_cast<const unsigned char*>(m_payload.data()) };
+        return numberFileDetail::decodeDeltaVarints(first, first + m_payload.size(), out, m_count);
+    }
+
+    // Copy all size() values into out. False if the column holds ints.
+    bool readDoubles(double* out) const
+    {
+        if (!m_ok || m_column != NumberColumn::float64)
+            return false;
+        std::memcpy(out, m_payload.data(), m_payload.size());
+        return true;
+    }
+
+private:
+    static std::size_t valueSize(NumberColumn column)
+    {
+        return column == NumberColumn::int32 ? sizeof(int) : sizeof(double);
+    }
+
+    std::string_view m_payload{ };
+    NumberColumn m_column{ };
+    NumberEncoding m_encoding{ };
+    std::size_t m_count{ 0 };
+    bool m_ok{ false };
+};
+
+// Write bytes (from encodeInts or encodeDoubles) to path, through a temporary file renamed over it, so a reader
+// never sees half a file. False (with errno set) if it couldn't be written.
+inline bool saveNumberFile(const char* path, std::string_view bytes)
+{
+    const std::string temporary{ std::string{ path } + ".tmp" };
+    const int fd{ ::open(temporary.c_str(), O_WRONLY | O_CREAT | O_TRUNC | O_CLOEXEC, 0644) };
+    if (fd < 0)
+        return false;
+    for (std::size_t written{ 0 }; written < bytes.size();)
+    {
+        const ssize_t result{ ::write(fd, bytes.data() + written, bytes.size() - written) };
+        if (result < 0 && errno == EINTR)
+            continue;
+        if (result < 0)
+        {
+            const int writeError{ errno };
+            ::close(fd);
+            ::unlink(temporary.c_str());
+            errno = writeError;
+            return false;
+        }
+        written += static_cast<std::size_t>(result);
+    }
+    if (::close(fd) != 0 || std::rename(temporary.c_str(), path) != 0)
+    {
+        const int saveError{ errno };
+        ::unlink(temporary.c_str());
+        errno = saveError;
+        return false;
+    }
+    return true;
+}
+
+#endif
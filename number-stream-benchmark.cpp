@@ -0,0 +1,165 @@
+//** Benchmark: reading numbers lazily with numbers() vs reading them all into a vector first **//
+
+// Build and run:
+//     g++ -std=c++20 -O2 number-stream-benchmark.cpp -o number-stream-benchmark
+//     ./number-stream-benchmark [millions of numbers, default 20] [file, default number-stream-benchmark.txt]
+
+// The file is filled with random ints (one per line, from -1,000,000 to 1,000,000) and removed afterwards. Each
+// variant adds up every number in it:
+    // cin loop         while (file >> x) on a std::ifstream, the loop iostream.cpp uses
+    // eager vector     FastReader::readInts() into a std::vector holding the whole file, then a loop over that
+    // numbers(stream)  for (int x : numbers(file)) on a std::ifstream
+    // numbers(fd)      for (int x : numbers(fd)) on the file's descriptor
+// Every sum and count must agree. Memory is the growth of the heap (mallinfo2) at its largest: for the eager vector
+// once it holds everything, for the others half way through the loop.
+
+#include <algorithm>
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <fcntl.h>
+#include <fstream>
+#include <malloc.h>
+#include <random>
+#include <unistd.h>
+#include <vector>
+
+#include "fast-input.h"
+#include "fast-output.h"
+#include "number-stream.h"
+
+struct Outcome
+{
+    long long sum{ 0 };
+    std::size_t count{ 0 };
+    std::size_t heapBytes{ 0 };
+    double seconds{ };
+};
+
+std::size_t heapInUse()
+{
+    const struct mallinfo2 info{ mallinfo2() };
+    return info.uordblks + info.hblkhd;
+}
+
+template <typename Run>
+Outcome measure(Run&& run)
+{
+    Outcome outcome{ };
+    const std::size_t heapBefore{ heapInUse() };
+    const auto start{ std::chrono::steady_clock::now() };
+    run(outcome, heapBefore);
+    const std::chrono::duration<double> elapsed{ std::chrono::steady_clock::now() - start };
+    outcome.seconds = elapsed.count();
+    return outcome;
+}
+
+void report(const char* name, const Outcome& outcome)
+{
+    std::printf("%-16s %9.1f ms %7.2f ns/number %12.3f MB\n", name, outcome.seconds * 1e3,
+                outcome.seconds * 1e9 / static_cast<double>(outcome.count),
+                static_cast<double>(outcome.heapBytes) / 1e6);
+}
+
+int main(int argc, char* argv[])
+{
+    const std::size_t count{ static_cast<std::size_t>((argc > 1 ? std::atof(argv[1]) : 20) * 1e6) };
+    const char* const path{ argc > 2 ? argv[2] : "number-stream-benchmark.txt" };
+
+    long long expectedSum{ 0 };
+    {
+        const int fd{ ::open(path, O_WRONLY | O_CREAT | O_TRUNC, 0644) };
+        if (fd < 0)
+        {
+            std::perror(path);
+            return 1;
+        }
+        FastWriter output{ fd, FlushPolicy::whenFull };
+        std::mt19937 random{ 12345 };
+        std::uniform_int_distribution<int> values{ -1'000'000, 1'000'000 };
+        for (std::size_t i{ 0 }; i < count; ++i)
+        {
+            const int value{ values(random) };
+            expectedSum += value;
+            output << value << '\n';
+        }
+        output.flush();
+        ::close(fd);
+    }
+
+    std::vector<Outcome> outcomes{ };
+    const char* const names[]{ "cin loop", "eager vector", "numbers(stream)", "numbers(fd)" };
+
+    outcomes.push_back(measure([&](Outcome& outcome, std::size_t heapBefore) {
+        std::ifstream file{ path };
+        int x{ };
+        while (file >> x)
+        {
+            outcome.sum += x;
+            if (++outcome.count == count / 2)
+                outcome.heapBytes = heapInUse() - heapBefore;
+        }
+    }));
+
+    outcomes.push_back(measure([&](Outcome& outcome, std::size_t heapBefore) {
+        const int fd{ ::open(path, O_RDONLY) };
+        std::vector<int> values{ };
+        {
+            FastReader input{ fd };
+            constexpr std::size_t chunk{ 1 << 16 };
+            std::size_t size{ 0 };
+            for (;;)
+            {
+                values.resize(size + chunk);
+                const std::size_t got{ input.readInts(values.data() + size, chunk) };
+                size += got;
+                if (got < chunk)
+                    break;
+            }
+            values.resize(size);
+        }
+        ::close(fd);
+        outcome.heapBytes = heapInUse() - heapBefore;
+        for (const int value : values)
+            outcome.sum += value;
+        outcome.count = values.size();
+    }));
+
+    outcomes.push_back(measure([&](Outcome& outcome, std::size_t heapBefore) {
+        std::ifstream file{ path };
+        for (const int x : numbers(file))
+        {
+            outcome.sum += x;
+            if (++outcome.count == count / 2)
+                outcome.heapBytes = heapInUse() - heapBefore;
+        }
+    }));
+
+    outcomes.push_back(measure([&](Outcome& outcome, std::size_t heapBefore) {
+        const int fd{ ::open(path, O_RDONLY) };
+        for (const int x : numbers(fd))
+        {
+            outcome.sum += x;
+            if (++outcome.count == count / 2)
+                outcome.heapBytes = heapInUse() - heapBefore;
+        }
+        ::close(fd);
+    }));
+
+    std::remove(path);
+    for (std::size_t i{ 0 }; i < outcomes.size(); ++i)
+    {
+        if (outcomes[i].sum != expectedSum || outcomes[i].count != count)
+        {
+            std::printf("MISMATCH: %s read %zu numbers adding up to %lld, expected %zu and %lld\n", names[i],
+                        outcomes[i].count, outcomes[i].sum, count, expectedSum);
+            return 1;
+        }
+    }
+
+    std::printf("%zu numbers, sum %lld\n", count, expectedSum);
+    std::printf("%-16s %12s %17s %15s\n", "", "time", "", "peak heap");
+    for (std::size_t i{ 0 }; i < outcomes.size(); ++i)
+        report(names[i], outcomes[i]);
+    return 0;
+}
@@ -0,0 +1,157 @@
+#ifndef NUMBER_STREAM_H
+#define NUMBER_STREAM_H
+
+//** Reading numbers with a range-for loop **//
+
+// iostream.cpp reads numbers with a hand-written loop around std::cin >> x. numbers() turns an input into a range
+// of the ints in it, so the loop only says what to do with each one:
+
+//     for (int x : numbers(std::cin))         // or numbers(file), or numbers(STDIN_FILENO)
+//         sum += x;
+
+// The range is a Generator (generator.h): the input is read into a fixed-size buffer and parsed only as the loop
+// asks for more, so memory use doesn't grow with the input. A pipe that never ends is fine, and so is a person
+// typing: each number is handed to the loop as soon as the whitespace after it arrives. Reading everything into a
+// std::vector first would use four bytes per number and wait for the end of the input before the loop could start.
+
+// Numbers follow the same rules as std::cin >> x (and FastReader, fast-input.h), and are parsed a buffer at a time
+// with parseInts() (simd-parse.h). The range ends where while (std::cin >> x) would stop: at the end of the input,
+// or at the first thing that isn't a valid int, which isn't part of the range. For a std::istream, the stream's
+// state then says which, as it would after that loop: eofbit and failbit at the end, failbit alone at bad input.
+
+// The stream is read through its streambuf, as much as it has buffered at a time. Until
+// std::ios::sync_with_stdio(false) is called, std::cin has no buffer of its own (it shares C stdio's), so it is read
+// one byte at a time; call that first (or use the file descriptor version) when reading a lot of input. Bytes after
+// the point where the range ended may already have been taken from the input.
+
+#include <algorithm>
+#include <cerrno>
+#include <cstddef>
+#include <cstring>
+#include <ios>
+#include <istream>
+#include <memory>
+#include <streambuf>
+#include <unistd.h>
+
+#include "generator.h"
+#include "simd-parse.h"
+
+namespace numberStreamDetail
+{
+    constexpr std::size_t defaultBufferSize{ 1 << 16 };
+    constexpr std::size_t batchSize{ 256 }; // values parsed at a time, then handed out one by one
+
+    inline bool isSpace(char c) { return c == ' ' || static_cast<unsigned char>(c - '\t') < 5; }
+
+    // The input, through a streambuf. Takes whatever is buffered, or waits for one more byte if nothing is.
+    struct StreamSource
+    {
+        std::size_t read(char* into, std::size_t space)
+        {
+            std::streambuf* const buffer{ stream->rdbuf() };
+            if (!buffer)
+                return 0;
+            const std::streamsize available{ buffer->in_avail() };
+            const std::streamsize wanted{ available > 0 ? std::min(available, static_cast<std::streamsize>(space))
+                                                        : 1 };
+            const std::streamsize got{ buffer->sgetn(into, wanted) };
+            return got > 0 ? static_cast<std::size_t>(got) : 0;
+        }
+
+        void finish(bool badInput)
+        {
+            stream->setstate(badInput ? std::ios::failbit : std::ios::eofbit | std::ios::failbit);
+        }
+
+        std::istream* stream{ };
+    };
+
+    // The input, through read(2), which returns whatever has arrived (up to space bytes).
+    struct DescriptorSource
+    {
+        std::size_t read(char* into, std::size_t space)
+        {
+            ssize_t got{ };
+            do
+            {
+                got = ::read(fd, into, space);
+            } while (got < 0 && errno == EINTR);
+            return got > 0 ? static_cast<std::size_t>(got) : 0;
+        }
+
+        void finish(bool) { }
+
+        int fd{ };
+    };
+
+    template <typename Source>
+    Generator<int> parseNumbers(Source source, std::size_t bufferSize)
+    {
+        const std::unique_ptr<char[]> buffer{ new char[bufferSize] };
+        int values[batchSize]{ };
+        std::size_t position{ 0 };
+        std::size_t size{ 0 };
+        bool endOfInput{ false };
+        for (;;)
+        {
+            // Move what's left to the front and read more behind it. A number may continue past the end of what has
+            // arrived, so unless the input has ended, only the text up to the last whitespace is parsed.
+            const std::size_t tail{ size - position };
+            if (tail == bufferSize)
+            {
+                source.finish(true); // one "number" longer than the whole buffer
+                co_return;
+            }
+            std::memmove(buffer.get(), buffer.get() + position, tail);
+            position = 0;
+            size = tail;
+            const std::size_t got{ source.read(buffer.get() + size, bufferSize - size) };
+            size += got;
+            endOfInput = got == 0;
+
+            const char* first{ buffer.get() };
+            const char* end{ buffer.get() + size };
+            if (!endOfInput)
+            {
+                while (end != first && !isSpace(end[-1]))
+                    --end;
+            }
+            while (first != end)
+            {
+                const ParseResult result{ parseInts(first, end, values, batchSize) };
+                for (std::size_t i{ 0 }; i < result.count; ++i)
+                    co_yield values[i];
+                if (result.stopped)
+                {
+                    source.finish(true);
+                    co_return;
+                }
+                if (result.count == 0)
+                    break; // only whitespace left
+                first = result.next;
+            }
+            position = static_cast<std::size_t>(end - buffer.get());
+
+            if (endOfInput)
+            {
+                source.finish(false);
+                co_return;
+            }
+        }
+    }
+}
+
+// The ints in a stream, read as they're needed.
+inline Generator<int> numbers(std::istream& input, std::size_t bufferSize = numberStreamDetail::defaultBufferSize)
+{
+    return numberStreamDetail::parseNumbers(numberStreamDetail::StreamSource{ &input }, bufferSize);
+}
+
+// The ints read from a file descriptor (such as STDIN_FILENO), read as they're needed. The descriptor isn't closed.
+inline Generator<int> numbers(int fd, std::size_t bufferSize = numberStreamDetail::defaultBufferSize)
+{
+    return numberStreamDetail::parseNumbers(numberStreamDetail::DescriptorSource{ fd }, bufferSize);
+}
+
+#endif
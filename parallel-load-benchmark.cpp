@@ -0,0 +1,103 @@
+//** Benchmark: loading a large numeric file on 1 to N threads **//
+
+// Build and run:
+//     g++ -std=c++20 -O2 -pthread parallel-load-benchmark.cpp -o parallel-load-benchmark
+//     ./parallel-load-benchmark [file]            # parse an existing file of whitespace-separated ints
+//     ./parallel-load-benchmark --generate 100000000
+
+// Without a file, the benchmark generates one in memory. A file is memory-mapped (mapped-input.h) and parsed
+// straight from the page cache; after the first repetition it is cached, so the numbers show parsing throughput
+// and how it scales with threads. The speedup stops growing once memory bandwidth (or the number of cores) runs out.
+
+#include <algorithm>
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <random>
+#include <string>
+#include <string_view>
+#include <thread>
+#include <vector>
+
+#include "parallel-load.h"
+
+std::vector<char> makeInput(std::size_t count)
+{
+    std::mt19937 random{ 42 };
+    std::uniform_int_distribution<int> values{ -100000, 100000 };
+
+    std::vector<char> text{ };
+    text.reserve(count * 8);
+    char number[16]{ };
+    for (std::size_t i{ 0 }; i < count; ++i)
+    {
+        const int length{ std::snprintf(number, sizeof(number), "%d", values(random)) };
+        text.insert(text.end(), number, number + length);
+        text.push_back(i % 16 == 15 ? '\n' : ' ');
+    }
+    return text;
+}
+
+int main(int argc, char* argv[])
+{
+    std::vector<char> generated{ };
+    std::string_view view{ };
+    const bool fromFile{ argc > 1 && std::strcmp(argv[1], "--generate") != 0 };
+    const MappedInput input{ fromFile ? argv[1] : "/dev/null" };
+    if (fromFile)
+    {
+        view = input.text();
+        if (!input)
+        {
+            std::perror(argv[1]);
+            return 1;
+        }
+    }
+    else
+    {
+        generated = makeInput(argc > 2 ? std::strtoull(argv[2], nullptr, 10) : 20'000'000);
+        view = { generated.data(), generated.size() };
+    }
+
+    const unsigned maximumThreads{ std::max(1u, std::thread::hardware_concurrency()) };
+    std::printf("%zu bytes%s, up to %u threads\n", view.size(), input.isMapped() ? " (mapped)" : "", maximumThreads);
+
+    // The single-threaded kernel is the reference for both the values and the speedup.
+    std::vector<int> expected(view.size() / 2 + 1);
+    const ParseResult reference{ parseInts(view.data(), view.data() + view.size(), expected.data(), expected.size()) };
+    expected.resize(reference.count);
+
+    std::vector<unsigned> threadCounts{ };
+    for (unsigned threads{ 1 }; threads < maximumThreads; threads *= 2)
+        threadCounts.push_back(threads);
+    threadCounts.push_back(maximumThreads);
+
+    double baseline{ 0 };
+    for (const unsigned threads : threadCounts)
+    {
+        ThreadPool pool{ threads };
+        double best{ 1e30 };
+        LoadResult load{ };
+        for (int repetition{ 0 }; repetition < 5; ++repetition)
+        {
+            const auto start{ std::chrono::steady_clock::now() };
+            load = loadInts(view, pool);
+            const std::chrono::duration<double> elapsed{ std::chrono::steady_clock::now() - start };
+            best = std::min(best, elapsed.count());
+        }
+
+        if (!std::ranges::equal(load.values, expected) || load.ok == reference.stopped)
+        {
+            std::printf("MISMATCH with %u threads\n", threads);
+            return 1;
+        }
+
+        if (threads == 1)
+            baseline = best;
+        std::printf("%3u threads  %8.3f GB/s  %7.1f M values/s  speedup %5.2fx\n", threads,
+                    static_cast<double>(view.size()) / best / 1e9, static_cast<double>(expected.size()) / best / 1e6,
+                    baseline / best);
+    }
+    return 0;
+}
@@ -0,0 +1,127 @@
+#ifndef PARALLEL_LOAD_H
+#define PARALLEL_LOAD_H
+
+//** Loading a large file of numbers on every core **//
+
+// uninitialized-undefined.cpp imagines reading 100,000 values from a file. A loop of std::cin >> x (or even
+// FastReader) does that on one core, which is fine for 100,000 values and far too slow for hundreds of millions.
+
+// loadInts splits the text into one byte range per chunk, moves each boundary forward to the next whitespace so
+// that no number is cut in half, and parses the chunks in parallel on a ThreadPool. Each chunk produces its own
+// list of values; a prefix sum over the chunk sizes says where each list goes in the final result, and the lists are
+// copied into place (also in parallel). The values come out in the same order as in the file.
+
+// As with std::cin, parsing stops at the first thing that isn't a number: the values before it are returned, and
+// errorOffset says where in the text the bad input starts.
+
+// loadIntFile() also accepts a binary number file (number-file.h), decoding it instead of parsing.
+
+#include <algorithm>
+#include <cstddef>
+#include <cstring>
+#include <string_view>
+#include <vector>
+
+#include "mapped-input.h"
+#include "number-file.h"
+#include "simd-parse.h"
+#include "thread-pool.h"
+#include "uninitialized-storage.h"
+
+struct LoadResult
+{
+    UninitializedVector<int> values{ }; // every element is copied in from a chunk, so no zero fill first
+    bool ok{ true };
+    std::size_t errorOffset{ 0 }; // offset of the first bad number, when !ok
+};
+
+namespace parallelLoadDetail
+{
+    inline bool isSpace(char c) { return c == ' ' || static_cast<unsigned char>(c - '\t') < 5; }
+
+    // Move a chunk boundary forward to the next whitespace, so the number under it stays in the earlier chunk.
+    inline std::size_t alignToDelimiter(std::string_view text, std::size_t position)
+    {
+        while (position < text.size() && !isSpace(text[position]))
+            ++position;
+        return position;
+    }
+}
+
+// Chunks are made smaller than text.size() / threads so that a thread with a slow chunk doesn't hold up the rest.
+inline LoadResult loadInts(std::string_view text, ThreadPool& pool, std::size_t minimumChunkSize = 1 << 20)
+{
+    const std::size_t wantedChunks{ std::max<std::size_t>(1, pool.threadCount() * 4) };
+    const std::size_t chunkCount{ std::clamp<std::size_t>(text.size() / minimumChunkSize, 1, wantedChunks) };
+
+    std::vector<std::size_t> boundaries(chunkCount + 1);
+    for (std::size_t i{ 1 }; i < chunkCount; ++i)
+        boundaries[i] = parallelLoadDetail::alignToDelimiter(text, text.size() / chunkCount * i);
+    boundaries[chunkCount] = text.size();
+
+    struct Chunk
+    {
+        UninitializedVector<int> values{ }; // scratch space the parser overwrites, so skip the zero fill
+        ParseResult result{ };
+    };
+    std::vector<Chunk> chunks(chunkCount);
+
+    pool.run(chunkCount, [&](std::size_t index) {
+        const char* first{ text.data() + boundaries[index] };
+        const char* last{ text.data() + std::max(boundaries[index], boundaries[index + 1]) };
+
+        Chunk& chunk{ chunks[index] };
+        chunk.values.resize(static_cast<std::size_t>(last - first) / 2 + 1); // enough even for "1-1-1-1..."
+        chunk.result = parseInts(first, last, chunk.values.data(), chunk.values.size());
+    });
+
+    // Stitch the chunks back together, stopping after the first one that hit bad input.
+    LoadResult load{ };
+    std::vector<std::size_t> offsets(chunkCount + 1);
+    std::size_t usedChunks{ 0 };
+    while (usedChunks < chunkCount)
+    {
+        const ParseResult& result{ chunks[usedChunks].result };
+        offsets[usedChunks + 1] = offsets[usedChunks] + result.count;
+        ++usedChunks;
+        if (result.stopped)
+        {
+            load.ok = false;
+            load.errorOffset = static_cast<std::size_t>(result.next - text.data());
+            break;
+        }
+    }
+
+    load.values.resize(offsets[usedChunks]);
+    pool.run(usedChunks, [&](std::size_t index) {
+        const std::size_t count{ offsets[index + 1] - offsets[index] };
+        std::memcpy(load.values.data() + offsets[index], chunks[index].values.data(), count * sizeof(int));
+        UninitializedVector<int>{ }.swap(chunks[index].values); // free each chunk as soon as it has been copied
+    });
+    return load;
+}
+
+// Load the ints in the file at path, parsing straight from the mapped file (see mapped-input.h). Returns false
+// if the file couldn't be opened or read. The file can also be a number file of ints (number-file.h), which needs
+// no parsing at all; one that is damaged or holds doubles loads no values, with errorOffset 0.
+inline bool loadIntFile(const char* path, ThreadPool& pool, LoadResult& load, MapOptions options = { })
+{
+    const MappedInput input{ path, options };
+    const std::string_view text{ input.text() };
+    if (!input)
+        return false;
+    if (isNumberFile(text))
+    {
+        const NumberFile file{ text };
+        load = { };
+        load.values.resize(file.column() == NumberColumn::int32 ? file.size() : 0);
+        load.ok = file.readInts(load.values.data());
+        if (!load.ok)
+            load.values.clear();
+        return true;
+    }
+    load = loadInts(text, pool);
+    return true;
+}
+
+#endif
@@ -0,0 +1,221 @@
+//** Pipelined version of the "enter two numbers" program **//
+
+// The second program in iostream.cpp reads one pair of numbers, prints "You entered x and y", and exits. This
+// version keeps going until the input ends, for feeding it a continuous stream of pairs:
+
+//     ./pipelined-pairs < pairs.txt
+//     5 6
+//     7 8
+//     ...
+//     You entered 5 and 6
+//     You entered 7 and 8
+
+// Build:
+//     g++ -std=c++20 -O2 -pthread pipelined-pairs.cpp -o pipelined-pairs
+
+// The work is split into three stages, each on its own thread:
+    // reader:  read(2) large blocks of text from standard input, cut at the last whitespace so no number is split.
+    // parser:  turn each block into a batch of ints with the SIMD kernels from simd-parse.h.
+    // printer: pair the values up and format them with FastWriter (this runs on the main thread).
+
+// The stages are connected by SpscRing queues (spsc-ring.h). Whole blocks and batches move through the rings, not
+// single numbers, so the threads synchronize once per few thousand values. Each ring has a partner ring running the
+// other way that hands the emptied buffers back, so once the pipeline is warm nothing is allocated, and a slow
+// stage makes the faster ones wait instead of piling up memory. While the reader waits on the disk or a pipe, the
+// parser and printer keep working, so the total time is set by the slowest stage instead of the sum of all three.
+
+// As with std::cin >> x >> y, input that isn't a number stops the program, and a number missing its partner (at the
+// end, or before bad input) is printed with 0, which is what std::cin leaves in y when the extraction fails. A number
+// too big for an int also stops the program, but is first used as INT_MAX (or INT_MIN), which is what std::cin
+// stores for it. So is a "number" longer than a whole block (64 KB), as for numbers() in number-stream.h.
+
+#include <atomic>
+#include <cerrno>
+#include <climits>
+#include <cstdlib>
+#include <cstring>
+#include <thread>
+#include <unistd.h>
+#include <utility>
+#include <vector>
+
+#include "fast-output.h"
+#include "simd-parse.h"
+#include "spsc-ring.h"
+#include "uninitialized-storage.h"
+
+constexpr std::size_t blockSize{ 1 << 16 };
+constexpr std::size_t ringSize{ 8 };
+
+// The buffers are resized before every fill, so they skip the zero fill std::vector would do.
+struct TextBlock
+{
+    UninitializedVector<char> text{ };
+    bool last{ false };    // no more blocks follow
+    bool tooLong{ false }; // the input went on to a token longer than blockSize: stop as at bad input
+};
+
+struct ValueBatch
+{
+    UninitializedVector<int> values{ };
+    bool last{ false };
+};
+
+template <typename T>
+using Ring = SpscRing<T, ringSize>;
+
+// Set when the parser ends early (bad input). It also closes the reader's rings, so the reader stops waiting for
+// buffers that will never come back.
+std::atomic<bool> stopping{ false };
+
+bool isSpace(char c) { return c == ' ' || static_cast<unsigned char>(c - '\t') < 5; }
+
+// parseInts() stopped at p. If that's only because the number there doesn't fit in an int, set value to what
+// std::cin >> value would store for it.
+bool saturatedValue(const char* p, const char* last, int& value)
+{
+    const bool negative{ p != last && *p == '-' };
+    if (p != last && (*p == '-' || *p == '+'))
+        ++p;
+    if (p == last || static_cast<unsigned char>(*p - '0') >= 10)
+        return false; // a sign without digits, or not a number at all
+    value = negative ? INT_MIN : INT_MAX;
+    return true;
+}
+
+void readStage(int fd, Ring<TextBlock>& filled, Ring<TextBlock>& emptied)
+{
+    std::vector<char> carry{ }; // the start of a number that was cut off at the end of the previous block
+    for (;;)
+    {
+        TextBlock block{ };
+        if (!emptied.pop(block))
+            return;
+
+        block.text.resize(carry.size() + blockSize);
+        std::memcpy(block.text.data(), carry.data(), carry.size());
+
+        ssize_t count{ };
+        do
+        {
+            count = ::read(fd, block.text.data() + carry.size(), blockSize);
+        } while (count < 0 && errno == EINTR);
+
+        if (count <= 0)
+        {
+            block.text.resize(carry.size());
+            block.last = true;
+            filled.push(block);
+            return;
+        }
+
+        // Keep whatever follows the last whitespace for the next block: it may be the first half of a number.
+        const std::size_t size{ carry.size() + static_cast<std::size_t>(count) };
+        std::size_t cut{ size };
+        while (cut != 0 && !isSpace(block.text[cut - 1]))
+            --cut;
+
+        carry.assign(block.text.begin() + static_cast<std::ptrdiff_t>(cut),
+                     block.text.begin() + static_cast<std::ptrdiff_t>(size));
+        block.text.resize(cut);
+        block.tooLong = carry.size() > blockSize;
+        block.last = block.tooLong;
+        if (!filled.push(block) || block.last)
+            return;
+    }
+}
+
+void parseStage(Ring<TextBlock>& textIn, Ring<TextBlock>& textBack, Ring<ValueBatch>& valuesOut,
+                Ring<ValueBatch>& valuesBack)
+{
+    for (;;)
+    {
+        TextBlock block{ };
+        textIn.pop(block);
+        ValueBatch batch{ };
+        valuesBack.pop(batch);
+
+        // Every number needs at least one digit plus a separator (or a sign), so this is always enough room.
+        batch.values.resize(block.text.size() / 2 + 1);
+        const char* first{ block.text.data() };
+        const ParseResult result{ parseInts(first, first + block.text.size(), batch.values.data(), batch.values.size()) };
+        batch.values.resize(result.count);
+        int saturated{ };
+        if (result.stopped && saturatedValue(result.next, first + block.text.size(), saturated))
+            batch.values.push_back(saturated);
+        batch.last = block.last || result.stopped;
+
+        if (result.stopped || block.tooLong)
+        {
+            stopping.store(true, std::memory_order_relaxed);
+            textIn.close();
+            textBack.close();
+        }
+
+        block.text.clear();
+        textBack.push(block);
+        valuesOut.push(batch);
+        if (batch.last)
+            return;
+    }
+}
+
+int main()
+{
+    Ring<TextBlock> filledText{ };
+    Ring<TextBlock> emptiedText{ };
+    Ring<ValueBatch> filledValues{ };
+    Ring<ValueBatch> emptiedValues{ };
+
+    // Prime the return rings with the buffers that will circulate through the pipeline.
+    for (std::size_t i{ 0 }; i < ringSize; ++i)
+    {
+        TextBlock block{ };
+        block.text.reserve(2 * blockSize);
+        emptiedText.push(block);
+
+        ValueBatch batch{ };
+        batch.values.reserve(blockSize / 2 + 1);
+        emptiedValues.push(batch);
+    }
+
+    std::thread reader{ readStage, STDIN_FILENO, std::ref(filledText), std::ref(emptiedText) };
+    std::thread parser{ parseStage, std::ref(filledText), std::ref(emptiedText), std::ref(filledValues),
+                        std::ref(emptiedValues) };
+
+    FastWriter output{ };
+    int x{ };
+    bool haveX{ false };
+    for (;;)
+    {
+        ValueBatch batch{ };
+        filledValues.pop(batch);
+        for (const int value : batch.values)
+        {
+            if (haveX)
+                output << "You entered " << x << " and " << value << '\n';
+            else
+                x = value;
+            haveX = !haveX;
+        }
+
+        const bool last{ batch.last };
+        batch.values.clear();
+        emptiedValues.push(batch);
+        if (last)
+            break;
+    }
+    if (haveX)
+        output << "You entered " << x << " and " << 0 << '\n';
+    output.flush();
+
+    parser.join();
+
+    // After bad input the reader may be blocked in read(2) on a terminal, and there is nothing left for it to do.
+    // Everything has been written, so leave without waiting for it.
+    if (stopping.load())
+        std::_Exit(0);
+
+    reader.join();
+    return 0;
+}
@@ -0,0 +1,178 @@
+//** Benchmark: parsing whitespace-separated integers **//
+
+// Build and run (AVX2 is selected at runtime, no -mavx2 needed):
+//     g++ -std=c++20 -O2 simd-parse-benchmark.cpp -o simd-parse-benchmark
+//     ./simd-parse-benchmark [count] [repetitions]
+
+// Before timing anything, every parser is checked against std::istringstream >> int, which goes through the same
+// extraction code as std::cin >> x. A handful of awkward inputs (5-6, overflow, stray characters) are checked
+// through FastReader as well, including the failure state it ends in.
+
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <iostream>
+#include <random>
+#include <sstream>
+#include <string>
+#include <vector>
+
+#include "fast-input.h"
+#include "simd-parse.h"
+
+struct ReferenceResult
+{
+    std::vector<int> values{ };
+    bool failed{ false };
+};
+
+ReferenceResult parseWithStream(const std::string& text)
+{
+    ReferenceResult result{ };
+    std::istringstream input{ text };
+    int value{ };
+    while (input >> value)
+        result.values.push_back(value);
+    result.failed = !input.eof(); // stopped at something other than the end of the input
+    return result;
+}
+
+// Run text through FastReader::readInts by way of a temporary file, the same way it would read from std::cin.
+ReferenceResult parseWithFastReader(const std::string& text, std::size_t bufferSize)
+{
+    std::FILE* file{ std::tmpfile() };
+    std::fwrite(text.data(), 1, text.size(), file);
+    std::fflush(file);
+    std::rewind(file);
+
+    ReferenceResult result{ };
+    FastReader input{ fileno(file), bufferSize };
+    std::vector<int> block(1000);
+    std::size_t count{ };
+    while ((count = input.readInts(block.data(), block.size())) != 0)
+        result.values.insert(result.values.end(), block.begin(), block.begin() + static_cast<std::ptrdiff_t>(count));
+    result.failed = !input.eof();
+
+    std::fclose(file);
+    return result;
+}
+
+std::string makeInput(std::size_t count)
+{
+    std::mt19937 random{ 12345 };
+    std::uniform_int_distribution<int> digits{ 1, 100 };
+    std::uniform_int_distribution<int> anyInt{ INT_MIN, INT_MAX };
+
+    std::string text{ };
+    text.reserve(count * 6);
+    for (std::size_t i{ 0 }; i < count; ++i)
+    {
+        // Mostly small numbers, like the feeds this was written for, with the occasional large or negative one.
+        const int shape{ digits(random) };
+        int value{ };
+        if (shape <= 60)
+            value = shape * 7 % 1000;
+        else if (shape <= 90)
+            value = -(shape * 131 % 100000);
+        else
+            value = anyInt(random);
+
+        text += std::to_string(value);
+        text += (shape % 10 == 0) ? '\n' : ' ';
+    }
+    return text;
+}
+
+bool checkEdgeCases()
+{
+    const char* cases[]{
+        "5-6", " +12 -0 2147483647 -2147483648 x", "2147483648 1", "-2147483649", "  -  5", "+-3",
+        "1 2 3\n4\t5\r\n", "99999999999999999999 3", "", "   ", "7", "00000000000000000000000000042 8",
+    };
+
+    bool ok{ true };
+    for (const char* text : cases)
+    {
+        // Also pad each case out past a whole SIMD window so the block kernels see it too.
+        for (const std::string& input : { std::string{ text }, std::string(100, ' ') + text })
+        {
+            for (std::size_t bufferSize : { std::size_t{ 3 }, std::size_t{ 1 << 16 } })
+            {
+                const ReferenceResult expected{ parseWithStream(input) };
+                const ReferenceResult actual{ parseWithFastReader(input, bufferSize) };
+                if (expected.values != actual.values || expected.failed != actual.failed)
+                {
+                    std::cout << "MISMATCH on \"" << text << "\" (buffer " << bufferSize << ")\n";
+                    ok = false;
+                }
+            }
+        }
+    }
+    return ok;
+}
+
+int main(int argc, char* argv[])
+{
+    const std::size_t count{ argc > 1 ? std::strtoull(argv[1], nullptr, 10) : 20'000'000 };
+    const int repetitions{ argc > 2 ? std::atoi(argv[2]) : 5 };
+
+    const std::string text{ makeInput(count) };
+    const double gigabytes{ static_cast<double>(text.size()) / 1e9 };
+    std::cout << count << " integers, " << text.size() << " bytes\n";
+
+    bool ok{ checkEdgeCases() };
+
+    const ReferenceResult expected{ parseWithStream(text) };
+    if (parseWithFastReader(text, FastReader::defaultBufferSize).values != expected.values)
+    {
+        std::cout << "MISMATCH: FastReader::readInts\n";
+        ok = false;
+    }
+
+    struct Kernel
+    {
+        const char* name{ };
+        ParseIntsFunction parse{ };
+    };
+
+    std::vector<Kernel> kernels{ { "scalar", parseIntsScalar } };
+#ifdef SIMD_PARSE_X86
+    kernels.push_back({ "sse2", parseIntsSse2 });
+    if (__builtin_cpu_supports("avx2"))
+        kernels.push_back({ "avx2", parseIntsAvx2 });
+#endif
+    kernels.push_back({ "dispatched", parseInts });
+
+    std::vector<int> values(count);
+    for (const Kernel& kernel : kernels)
+    {
+        const ParseResult result{ kernel.parse(text.data(), text.data() + text.size(), values.data(), values.size()) };
+        if (result.stopped || values != expected.values)
+        {
+            std::cout << "MISMATCH: " << kernel.name << '\n';
+            ok = false;
+        }
+    }
+
+    if (!ok)
+        return 1;
+    std::cout << "all parsers agree with std::istringstream\n\n";
+
+    auto timeIt{ [&](const char* name, auto&& run) {
+        double best{ 1e30 };
+        for (int i{ 0 }; i < repetitions; ++i)
+        {
+            const auto start{ std::chrono::steady_clock::now() };
+            run();
+            const std::chrono::duration<double> elapsed{ std::chrono::steady_clock::now() - start };
+            best = std::min(best, elapsed.count());
+        }
+        std::printf("%-14s %8.3f GB/s  %8.2f ns/int\n", name, gigabytes / best, best * 1e9 / static_cast<double>(count));
+    } };
+
+    timeIt("istringstream", [&] { parseWithStream(text); });
+    for (const Kernel& kernel : kernels)
+        timeIt(kernel.name, [&] { kernel.parse(text.data(), text.data() + text.size(), values.data(), values.size()); });
+
+    return 0;
+}
@@ -0,0 +1,307 @@
+#ifndef SIMD_PARSE_H
+#define SIMD_PARSE_H
+
+//** Parsing many integers at once **//
+
+// FastReader::readInt looks at one byte at a time: is it a space, a sign, a digit? When the input holds tens of
+// millions of small numbers, those per-byte branches are where all the time goes.
+
+// The kernels in this file classify 64 bytes of input at once. SIMD compares turn the bytes into three 64-bit
+// masks (which bytes are digits, which are whitespace, which are signs), and simple bit tricks on those masks find
+// where every number starts and ends. The digits of each number are then converted with a SWAR ("SIMD within a
+// register") multiply that turns up to 8 ASCII digits into an integer without a loop.
+
+// The rules are the same as std::cin >> x (and FastReader): optional whitespace, an optional sign, then digits.
+// Anything unusual (a stray character, a number too large for an int, a number cut off by the end of a block) is
+// handed to the scalar parser, which is the reference implementation. A number the block code can't convert is
+// parsed on its own and the block loop carries on after it; only a stray character ends the block loop.
+
+// Three versions are provided: scalar (any CPU), SSE2 (every x86-64 CPU) and AVX2. parseInts() picks the best
+// one for the running CPU the first time it is called.
+
+#include <climits>
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+
+#if defined(__x86_64__) || defined(_M_X64)
+#define SIMD_PARSE_X86 1
+#include <immintrin.h>
+#endif
+
+struct ParseResult
+{
+    std::size_t count{ };  // number of values written
+    const char* next{ };   // where parsing stopped
+    bool stopped{ false }; // true if parsing stopped at something that isn't a valid int (next points at it)
+};
+
+namespace simdParseDetail
+{
+    inline bool isDigit(char c) { return static_cast<unsigned char>(c - '0') < 10; }
+    inline bool isSpace(char c) { return c == ' ' || static_cast<unsigned char>(c - '\t') < 5; }
+
+    // Parse one [+-]digits token at p. On success advances p past it; on failure leaves p alone.
+    inline bool parseOne(const char*& p, const char* last, int& value)
+    {
+        const char* q{ p };
+        bool negative{ false };
+        if (q != last && (*q == '+' || *q == '-'))
+        {
+            negative = (*q == '-');
+            ++q;
+        }
+        if (q == last || !isDigit(*q))
+            return false;
+
+        std::int64_t magnitude{ 0 };
+        while (q != last && isDigit(*q))
+        {
+            magnitude = magnitude * 10 + (*q - '0');
+            if (magnitude > static_cast<std::int64_t>(INT_MAX) + 1)
+                return false;
+            ++q;
+        }
+        if (!negative && magnitude > INT_MAX)
+            return false;
+
+        value = static_cast<int>(negative ? -magnitude : magnitude);
+        p = q;
+        return true;
+    }
+
+    // Convert digitCount (1 to 8) ASCII digits at digits to an integer. Reads 8 bytes, so at least 8 bytes must
+    // be readable at digits even when digitCount is smaller.
+    inline std::uint64_t convertDigits(const char* digits, int digitCount)
+    {
+        std::uint64_t chunk{ };
+        std::memcpy(&chunk, digits, sizeof(chunk));
+        chunk -= 0x3030303030303030ULL;      // '0' -> 0 in each byte (bytes past the number are shifted out below)
+        chunk <<= 8 * (8 - digitCount);      // right-align the digits, leading bytes become 0
+        chunk = (chunk * 10) + (chunk >> 8); // pairs of digits
+        chunk = (((chunk & 0x000000FF000000FFULL) * (100 + (1000000ULL << 32)))
+                 + (((chunk >> 16) & 0x000000FF000000FFULL) * (1 + (10000ULL << 32)))) >> 32;
+        return chunk;
+    }
+
+    struct BlockMasks
+    {
+        std::uint64_t digit{ };
+        std::uint64_t space{ };
+        std::uint64_t sign{ };
+    };
+
+    // Bytes a block-based kernel needs beyond the 64-byte window, so convertDigits never reads past the end.
+    constexpr std::ptrdiff_t blockSlack{ 8 };
+}
+
+inline ParseResult parseIntsScalar(const char* first, const char* last, int* out, std::size_t capacity)
+{
+    const char* p{ first };
+    std::size_t count{ 0 };
+    while (count < capacity)
+    {
+        while (p != last && simdParseDetail::isSpace(*p))
+            ++p;
+        if (p == last)
+            break;
+        if (!simdParseDetail::parseOne(p, last, out[count]))
+            return { count, p, true };
+        ++count;
+    }
+    return { count, p, false };
+}
+
+namespace simdParseDetail
+{
+    // The shared block walker. ClassifyBlock::masks(p) returns the masks for the 64 bytes at p.
+    template <typename ClassifyBlock>
+    [[gnu::always_inline]] inline ParseResult parseBlocks(const char* first, const char* last, int* out,
+                                                          std::size_t capacity)
+    {
+        const char* p{ first };
+        std::size_t count{ 0 };
+
+        // Every window starts on a token boundary (the first byte is whitespace, a sign or a fresh number).
+        while (last - p >= 64 + blockSlack && count < capacity)
+        {
+            const BlockMasks masks{ ClassifyBlock::masks(p) };
+            if ((masks.digit | masks.space | masks.sign) != ~0ULL)
+                break; // a character that isn't part of any number: let the scalar parser deal with it
+
+            const std::uint64_t tokenBytes{ masks.digit | masks.sign };
+            std::uint64_t starts{ masks.sign | (masks.digit & ~(tokenBytes << 1)) };
+            const char* resume{ p + 64 };
+            bool fallBack{ false };
+
+            while (starts != 0)
+            {
+                const int start{ __builtin_ctzll(starts) };
+                starts &= starts - 1;
+
+                int digitStart{ start };
+                bool negative{ false };
+                if ((masks.sign >> start) & 1)
+                {
+                    negative = (p[start] == '-');
+                    ++digitStart;
+                }
+
+                const std::uint64_t notDigit{ digitStart < 64 ? (~masks.digit) >> digitStart : 0 };
+                if (notDigit == 0)
+                {
+                    // The number runs into the next window; start the next window at it.
+                    resume = p + start;
+                    fallBack = (start == 0);
+                    break;
+                }
+
+                const int digitCount{ __builtin_ctzll(notDigit) };
+                if (digitCount == 0 || digitCount > 18)
+                {
+                    // A sign without digits, or a huge run of digits: the scalar parser decides.
+                    resume = p + start;
+                    fallBack = true;
+                    break;
+                }
+
+                const char* digits{ p + digitStart };
+                int head{ digitCount % 8 == 0 ? 8 : digitCount % 8 };
+                std::uint64_t magnitude{ convertDigits(digits, head) };
+                for (int i{ head }; i < digitCount; i += 8)
+                    magnitude = magnitude * 100000000 + convertDigits(digits + i, 8);
+
+                if (magnitude > static_cast<std::uint64_t>(INT_MAX) + (negative ? 1 : 0))
+                {
+                    resume = p + start;
+                    fallBack = true;
+                    break;
+                }
+
+                out[count] = static_cast<int>(negative ? -static_cast<std::int64_t>(magnitude)
+                                                       : static_cast<std::int64_t>(magnitude));
+                if (++count == capacity)
+                    return { count, digits + digitCount, false };
+            }
+
+            p = resume;
+            if (fallBack)
+            {
+                // Hand just this token to the scalar parser, then go back to whole blocks, so that one odd token
+                // (a long zero-padded number, say) doesn't slow down the rest of the input.
+                if (!parseOne(p, last, out[count]))
+                    return { count, p, true };
+                if (++count == capacity)
+                    return { count, p, false };
+            }
+        }
+
+        ParseResult rest{ parseIntsScalar(p, last, out + count, capacity - count) };
+        rest.count += count;
+        return rest;
+    }
+
+#ifdef SIMD_PARSE_X86
+    struct Sse2Classify
+    {
+        static std::uint64_t bits(__m128i mask)
+        {
+            return static_cast<std::uint16_t>(_mm_movemask_epi8(mask));
+        }
+
+        static BlockMasks masks(const char* p)
+        {
+            BlockMasks result{ };
+            for (int i{ 0 }; i < 4; ++i)
+            {
+                const __m128i bytes{ _mm_loadu_si128(reinterpret_cast<const __m128i*>(p + 16 * i)) };
+
+                const __m128i fromZero{ _mm_sub_epi8(bytes, _mm_set1_epi8('0')) };
+                const __m128i digit{ _mm_cmpeq_epi8(_mm_min_epu8(fromZero, _mm_set1_epi8(9)), fromZero) };
+
+                const __m128i fromTab{ _mm_sub_epi8(bytes, _mm_set1_epi8('\t')) };
+                const __m128i space{ _mm_or_si128(_mm_cmpeq_epi8(bytes, _mm_set1_epi8(' ')),
+                                                  _mm_cmpeq_epi8(_mm_min_epu8(fromTab, _mm_set1_epi8(4)), fromTab)) };
+
+                const __m128i sign{ _mm_or_si128(_mm_cmpeq_epi8(bytes, _mm_set1_epi8('-')),
+                                                 _mm_cmpeq_epi8(bytes, _mm_set1_epi8('+'))) };
+
+                result.digit |= bits(digit) << (16 * i);
+                result.space |= bits(space) << (16 * i);
+                result.sign |= bits(sign) << (16 * i);
+            }
+            return result;
+        }
+    };
+
+    struct Avx2Classify
+    {
+        [[gnu::target("avx2")]] static std::uint64_t bits(__m256i mask)
+        {
+            return static_cast<std::uint32_t>(_mm256_movemask_epi8(mask));
+        }
+
+        [[gnu::target("avx2")]] static BlockMasks masks(const char* p)
+        {
+            BlockMasks result{ };
+            for (int i{ 0 }; i < 2; ++i)
+            {
+                const __m256i bytes{ _mm256_loadu_si256(reinterpret_cast<const __m256i*>(p + 32 * i)) };
+
+                const __m256i fromZero{ _mm256_sub_epi8(bytes, _mm256_set1_epi8('0')) };
+                const __m256i digit{ _mm256_cmpeq_epi8(_mm256_min_epu8(fromZero, _mm256_set1_epi8(9)), fromZero) };
+
+                const __m256i fromTab{ _mm256_sub_epi8(bytes, _mm256_set1_epi8('\t')) };
+                const __m256i space{ _mm256_or_si256(
+                    _mm256_cmpeq_epi8(bytes, _mm256_set1_epi8(' ')),
+                    _mm256_cmpeq_epi8(_mm256_min_epu8(fromTab, _mm256_set1_epi8(4)), fromTab)) };
+
+                const __m256i sign{ _mm256_or_si256(_mm256_cmpeq_epi8(bytes, _mm256_set1_epi8('-')),
+                                                    _mm256_cmpeq_epi8(bytes, _mm256_set1_epi8('+'))) };
+
+                result.digit |= bits(digit) << (32 * i);
+                result.space |= bits(space) << (32 * i);
+                result.sign |= bits(sign) << (32 * i);
+            }
+            return result;
+        }
+    };
+#endif
+}
+
+#ifdef SIMD_PARSE_X86
+inline ParseResult parseIntsSse2(const char* first, const char* last, int* out, std::size_t capacity)
+{
+    return simdParseDetail::parseBlocks<simdParseDetail::Sse2Classify>(first, last, out, capacity);
+}
+
+[[gnu::target("avx2")]] inline ParseResult parseIntsAvx2(const char* first, const char* last, int* out,
+                                                         std::size_t capacity)
+{
+    return simdParseDetail::parseBlocks<simdParseDetail::Avx2Classify>(first, last, out, capacity);
+}
+#endif
+
+using ParseIntsFunction = ParseResult (*)(const char* first, const char* last, int* out, std::size_t capacity);
+
+inline ParseIntsFunction selectParseInts()
+{
+#ifdef SIMD_PARSE_X86
+    __builtin_cpu_init();
+    if (__builtin_cpu_supports("avx2"))
+        return parseIntsAvx2;
+    return parseIntsSse2;
+#else
+    return parseIntsScalar;
+#endif
+}
+
+// Parse whitespace-separated ints from [first, last) into out (at most capacity of them), treating last as the
+// end of the input. Uses the fastest kernel the CPU supports.
+inline ParseResult parseInts(const char* first, const char* last, int* out, std::size_t capacity)
+{
+    static const ParseIntsFunction best{ selectParseInts() };
+    return best(first, last, out, capacity);
+}
+
+#endif
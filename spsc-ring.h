@@ -0,0 +1,146 @@
+#ifndef SPSC_RING_H
+#define SPSC_RING_H
+
+//** A single-producer, single-consumer ring buffer **//
+
+// A fixed-size queue that connects exactly two threads: one pushes, the other pops. Because each index is only
+// ever written by one side, no locks are needed; the two atomics below are the only shared state, and each sits in
+// its own cache line so the threads don't slow each other down by writing to the same line.
+
+// Each side also keeps a cached copy of the other side's index and only re-reads the real one when the cached
+// value says the ring is full (or empty). In steady state that means a push or pop touches no shared cache line
+// except its own.
+
+// Elements are moved in and out, so a ring of std::vector can pass whole batches of records between threads
+// without copying them.
+
+// push() and pop() wait when the ring is full (or empty): they spin for a moment, in case the other side is about
+// to catch up, and then sleep in std::atomic::wait until it does. To find out whether anyone needs waking, a push
+// or pop reads a count of sleeping threads, which only changes when a thread goes to sleep. That line is only read
+// in steady state, so it stays in both threads' caches. close() wakes both sides for good, for a pipeline that has
+// to stop early.
+
+#include <array>
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <utility>
+
+template <typename T, std::size_t Capacity>
+class SpscRing
+{
+    static_assert(Capacity >= 2 && (Capacity & (Capacity - 1)) == 0, "Capacity must be a power of two");
+
+public:
+    // Producer side. Returns false (leaving value alone) if the ring is full.
+    bool tryPush(T& value)
+    {
+        const std::size_t tail{ m_tail.load(std::memory_order_relaxed) };
+        if (tail - m_cachedHead == Capacity)
+        {
+            m_cachedHead = m_head.load(std::memory_order_acquire);
+            if (tail - m_cachedHead == Capacity)
+                return false;
+        }
+        m_slots[tail & (Capacity - 1)] = std::move(value);
+        m_tail.store(tail + 1, std::memory_order_release);
+        wakeSleepers();
+        return true;
+    }
+
+    // Consumer side. Returns false if the ring is empty.
+    bool tryPop(T& value)
+    {
+        const std::size_t head{ m_head.load(std::memory_order_relaxed) };
+        if (head == m_cachedTail)
+        {
+            m_cachedTail = m_tail.load(std::memory_order_acquire);
+            if (head == m_cachedTail)
+                return false;
+        }
+        value = std::move(m_slots[head & (Capacity - 1)]);
+        m_head.store(head + 1, std::memory_order_release);
+        wakeSleepers();
+        return true;
+    }
+
+    // Blocking versions: wait until there's room (or a value). Once the ring is closed they don't wait any more:
+    // each returns false (leaving value alone) where it would have had to.
+    bool push(T& value)
+    {
+        return retry([&] { return tryPush(value); });
+    }
+
+    bool pop(T& value)
+    {
+        return retry([&] { return tryPop(value); });
+    }
+
+    // Either side, or a third thread. Wakes a push() or pop() that is waiting, and stops them waiting from now on.
+    void close()
+    {
+        m_closed.store(true, std::memory_order_release);
+        m_events.fetch_add(1, std::memory_order_release);
+        m_events.notify_all();
+    }
+
+private:
+    static constexpr int spinLimit{ 64 };
+
+    // Call attempt() until it succeeds (true) or the ring is closed (false), going to sleep after spinLimit tries.
+    template <typename Attempt>
+    bool retry(Attempt attempt)
+    {
+        for (int spins{ 0 };; ++spins)
+        {
+            const bool sleepy{ spins >= spinLimit };
+            std::uint32_t seenEvents{ };
+            if (sleepy)
+            {
+                // Announce the sleep before the last attempt, so that a push or pop that attempt misses sees it.
+                seenEvents = m_events.load(std::memory_order_acquire);
+                m_sleepers.fetch_add(1, std::memory_order_relaxed);
+                std::atomic_thread_fence(std::memory_order_seq_cst);
+            }
+            const bool done{ attempt() };
+            const bool closed{ m_closed.load(std::memory_order_acquire) };
+            if (sleepy)
+            {
+                if (!done && !closed)
+                    m_events.wait(seenEvents, std::memory_order_acquire);
+                m_sleepers.fetch_sub(1, std::memory_order_relaxed);
+            }
+            if (done)
+                return true;
+            if (closed)
+                return false;
+        }
+    }
+
+    // After a push or pop: wake the other side if it has gone to sleep waiting for one.
+    void wakeSleepers()
+    {
+        std::atomic_thread_fence(std::memory_order_seq_cst); // pairs with the fence in retry()
+        if (m_sleepers.load(std::memory_order_relaxed) != 0)
+        {
+            m_events.fetch_add(1, std::memory_order_release);
+            m_events.notify_all();
+        }
+    }
+
+    static constexpr std::size_t cacheLine{ 64 };
+
+    alignas(cacheLine) std::atomic<std::size_t> m_head{ 0 }; // next slot to pop, written by the consumer
+    std::size_t m_cachedTail{ 0 };                           // consumer's copy of m_tail
+
+    alignas(cacheLine) std::atomic<std::size_t> m_tail{ 0 }; // next slot to push, written by the producer
+    std::size_t m_cachedHead{ 0 };                           // producer's copy of m_head
+
+    alignas(cacheLine) std::atomic<std::uint32_t> m_sleepers{ 0 }; // threads in retry() that may be asleep
+    std::atomic<std::uint32_t> m_events{ 0 };                      // what they sleep on: bumped to wake them
+    std::atomic<bool> m_closed{ false };
+
+    alignas(cacheLine) std::array<T, Capacity> m_slots{ };
+};
+
+#endif
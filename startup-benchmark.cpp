@@ -0,0 +1,150 @@
+//** Benchmark: how long a tiny program takes from exec to exit **//
+
+// Build and run:
+//     g++ -std=c++20 -O2 statements-functions.cpp -o statements-functions
+//     g++ -std=c++20 -O2 -static hello-fast.cpp -o hello-fast
+//     g++ -std=c++20 -O2 startup-benchmark.cpp -o startup-benchmark
+//     ./startup-benchmark [runs, default 2000] [program ...]   (default: ./statements-functions ./hello-fast)
+
+// Each program is started with posix_spawn, its standard output going to /dev/null, and the time from just before
+// the spawn until waitpid() returns is one sample: loading and linking, static initialization, main() and exit.
+// The programs take turns, one run each, so that anything else happening on the machine affects all of them alike.
+// Before anything is timed, every program must print exactly "Hello world!" and exit with status 0.
+
+// The report gives the median (p50), the 99th percentile (p99), the fastest run and the mean for each program, and
+// how much faster than the first one each of the others is at the median.
+
+#include <algorithm>
+#include <cerrno>
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <fcntl.h>
+#include <spawn.h>
+#include <string>
+#include <sys/wait.h>
+#include <unistd.h>
+#include <vector>
+
+extern char** environ;
+
+// Start program with its standard output going to outputFd (or to /dev/null if outputFd is -1), and wait for it.
+// Returns its exit status, or -1 if it couldn't be started or didn't exit normally.
+int runProgram(const char* program, int outputFd)
+{
+    posix_spawn_file_actions_t actions{ };
+    ::posix_spawn_file_actions_init(&actions);
+    if (outputFd >= 0)
+        ::posix_spawn_file_actions_adddup2(&actions, outputFd, STDOUT_FILENO);
+    else
+        ::posix_spawn_file_actions_addopen(&actions, STDOUT_FILENO, "/dev/null", O_WRONLY, 0);
+
+    char* const arguments[]{ const_cast<char*>(program), nullptr };
+    pid_t child{ };
+    const int error{ ::posix_spawn(&child, program, &actions, nullptr, arguments, environ) };
+    ::posix_spawn_file_actions_destroy(&actions);
+    if (error != 0)
+        return -1;
+
+    int status{ };
+    while (::waitpid(child, &status, 0) < 0)
+    {
+        if (errno != EINTR)
+            return -1;
+    }
+    return WIFEXITED(status) ? WEXITSTATUS(status) : -1;
+}
+
+// Whether program prints exactly "Hello world!" and exits with status 0.
+bool printsHello(const char* program)
+{
+    int fds[2]{ };
+    if (::pipe(fds) != 0)
+        return false;
+    const int status{ runProgram(program, fds[1]) };
+    ::close(fds[1]);
+
+    std::string output{ };
+    char buffer[256]{ };
+    ssize_t got{ };
+    while ((got = ::read(fds[0], buffer, sizeof(buffer))) > 0)
+        output.append(buffer, static_cast<std::size_t>(got));
+    ::close(fds[0]);
+    return status == 0 && output == "Hello world!";
+}
+
+struct Samples
+{
+    const char* program{ };
+    std::vector<double> microseconds{ };
+
+    double percentile(double fraction) const
+    {
+        return microseconds[static_cast<std::size_t>(fraction * static_cast<double>(microseconds.size() - 1))];
+    }
+};
+
+int main(int argc, char* argv[])
+{
+    const int runs{ argc > 1 ? std::max(1, std::atoi(argv[1])) : 2000 };
+    constexpr int warmupRuns{ 50 };
+
+    std::vector<Samples> programs{ };
+    for (int i{ 2 }; i < argc; ++i)
+        programs.push_back({ argv[i], { } });
+    if (programs.empty())
+    {
+        programs.push_back({ "./statements-functions", { } });
+        programs.push_back({ "./hello-fast", { } });
+    }
+
+    for (const Samples& samples : programs)
+    {
+        if (!printsHello(samples.program))
+        {
+            std::printf("%s didn't print \"Hello world!\" and exit with 0 (is it built?)\n", samples.program);
+            return 1;
+        }
+    }
+
+    // Warm the page cache and the dynamic linker's caches, so the first program isn't the only one paying for them.
+    for (int run{ 0 }; run < warmupRuns; ++run)
+    {
+        for (const Samples& samples : programs)
+            runProgram(samples.program, -1);
+    }
+
+    for (Samples& samples : programs)
+        samples.microseconds.reserve(static_cast<std::size_t>(runs));
+    for (int run{ 0 }; run < runs; ++run)
+    {
+        for (Samples& samples : programs)
+        {
+            const auto start{ std::chrono::steady_clock::now() };
+            if (runProgram(samples.program, -1) != 0)
+            {
+                std::printf("%s failed on run %d\n", samples.program, run);
+                return 1;
+            }
+            const std::chrono::duration<double, std::micro> elapsed{ std::chrono::steady_clock::now() - start };
+            samples.microseconds.push_back(elapsed.count());
+        }
+    }
+
+    std::printf("%d runs each, exec to exit\n", runs);
+    std::printf("%-28s %10s %10s %10s %10s\n", "program", "p50 us", "p99 us", "min us", "mean us");
+    for (Samples& samples : programs)
+    {
+        std::sort(samples.microseconds.begin(), samples.microseconds.end());
+        double total{ 0 };
+        for (const double sample : samples.microseconds)
+            total += sample;
+        std::printf("%-28s %10.1f %10.1f %10.1f %10.1f", samples.program, samples.percentile(0.5),
+                    samples.percentile(0.99), samples.microseconds.front(),
+                    total / static_cast<double>(samples.microseconds.size()));
+        if (&samples != &programs.front())
+            std::printf("   %.1fx faster at p50", programs.front().percentile(0.5) / samples.percentile(0.5));
+        std::printf("\n");
+    }
+    return 0;
+}
@@ -0,0 +1,187 @@
+//** Benchmark: summarizing a large column of numbers **//
+
+// Build and run:
+//     g++ -std=c++20 -O2 -pthread stream-aggregate-benchmark.cpp -o stream-aggregate-benchmark
+//     ./stream-aggregate-benchmark [millions of numbers, default 100] [repetitions, default 3]
+
+// Ints from -1,000,000 to 1,000,000, and doubles around 1e9 with a spread of about 0.6 (readings from a sensor with
+// a large offset, the case that breaks the textbook variance formula). Each column is summarized with a
+// 20-bucket histogram by:
+    // read only      a sum in eight lanes, like columnSum: about the least any pass over the values can cost
+    // naive loop     one loop updating the sum, sum of squares, min, max and histogram for each value in turn
+    // stream         StreamAggregator::add(value), one value at a time
+    // aggregate(1)   aggregate() on one thread, then on every hardware thread
+// Before timing, StreamAggregator and aggregate() on 1, 2, 3 and 8 threads must agree bit for bit, and their mean
+// and variance are compared with a long double reference next to the naive loop's.
+
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <random>
+#include <span>
+#include <thread>
+#include <vector>
+
+#include "stream-aggregate.h"
+#include "thread-pool.h"
+
+volatile double benchmarkSink{ };
+
+template <typename Run>
+double bestOf(int repetitions, Run&& run)
+{
+    double best{ 1e30 };
+    for (int i{ 0 }; i < repetitions; ++i)
+    {
+        const auto start{ std::chrono::steady_clock::now() };
+        run();
+        const std::chrono::duration<double> elapsed{ std::chrono::steady_clock::now() - start };
+        best = std::min(best, elapsed.count());
+    }
+    return best;
+}
+
+template <typename T>
+bool sameResult(const Aggregate<T>& a, const Aggregate<T>& b)
+{
+    return a.count == b.count && std::memcmp(&a.sum, &b.sum, sizeof(a.sum)) == 0 && a.min == b.min && a.max == b.max
+           && std::memcmp(&a.mean, &b.mean, sizeof(a.mean)) == 0
+           && std::memcmp(&a.variance, &b.variance, sizeof(a.variance)) == 0 && a.histogram == b.histogram
+           && a.belowRange == b.belowRange && a.aboveRange == b.aboveRange;
+}
+
+// The loop most people would write: one pass, and the variance from the sum of squares.
+template <typename T>
+Aggregate<T> naiveAggregate(std::span<const T> values, const HistogramRange<T>& range)
+{
+    Aggregate<T> result{ };
+    result.histogram.assign(range.buckets, 0);
+    result.min = values[0];
+    result.max = values[0];
+    double sumOfSquares{ 0 };
+    const double scale{ static_cast<double>(range.buckets) / static_cast<double>(range.high - range.low) };
+    for (const T value : values)
+    {
+        result.sum += value;
+        sumOfSquares += static_cast<double>(value) * static_cast<double>(value);
+        result.min = std::min(result.min, value);
+        result.max = std::max(result.max, value);
+        if (value < range.low)
+            ++result.belowRange;
+        else if (value >= range.high)
+            ++result.aboveRange;
+        else
+            ++result.histogram[static_cast<std::size_t>(static_cast<double>(value - range.low) * scale)];
+    }
+    result.count = values.size();
+    result.mean = static_cast<double>(result.sum) / static_cast<double>(values.size());
+    result.variance = sumOfSquares / static_cast<double>(values.size()) - result.mean * result.mean;
+    return result;
+}
+
+template <typename T>
+bool run(const char* name, const std::vector<T>& column, const HistogramRange<T>& range, int repetitions)
+{
+    const std::span<const T> values{ column };
+
+    StreamAggregator<T> stream{ range };
+    for (const T value : values)
+        stream.add(value);
+    const Aggregate<T> expected{ stream.result() };
+    for (const std::size_t threads : { 1, 2, 3, 8 })
+    {
+        ThreadPool pool{ threads };
+        if (!sameResult(aggregate(values, pool, range), expected))
+        {
+            std::printf("MISMATCH: %s: aggregate() on %zu threads differs from StreamAggregator\n", name, threads);
+            return false;
+        }
+    }
+
+    long double sum{ 0 };
+    for (const T value : values)
+        sum += value;
+    const long double mean{ sum / static_cast<long double>(values.size()) };
+    long double squares{ 0 };
+    for (const T value : values)
+        squares += (value - mean) * (value - mean);
+    const long double variance{ squares / static_cast<long double>(values.size()) };
+    const Aggregate<T> naive{ naiveAggregate(values, range) };
+    if (naive.histogram != expected.histogram || naive.min != expected.min || naive.max != expected.max)
+    {
+        std::printf("MISMATCH: %s: the naive loop and StreamAggregator disagree\n", name);
+        return false;
+    }
+
+    std::printf("\n%s: %zu values, mean %.17g, variance %.17g\n", name, values.size(), expected.mean,
+                expected.variance);
+    std::printf("%-16s relative error of mean %.1e, of variance %.1e\n", "aggregate",
+                static_cast<double>(std::fabs((expected.mean - mean) / mean)),
+                static_cast<double>(std::fabs((expected.variance - variance) / variance)));
+    std::printf("%-16s relative error of mean %.1e, of variance %.1e\n", "naive loop",
+                static_cast<double>(std::fabs((naive.mean - mean) / mean)),
+                static_cast<double>(std::fabs((naive.variance - variance) / variance)));
+
+    const double bytes{ static_cast<double>(values.size() * sizeof(T)) };
+    const auto report{ [&](const char* variant, double seconds) {
+        std::printf("%-16s %9.1f ms %6.2f ns/value %7.2f GB/s\n", variant, seconds * 1e3,
+                    seconds * 1e9 / static_cast<double>(values.size()), bytes / seconds / 1e9);
+    } };
+
+    report("read only", bestOf(repetitions, [&] {
+        typename Aggregate<T>::Sum sums[8]{ };
+        std::size_t i{ 0 };
+        for (; i + 8 <= values.size(); i += 8)
+        {
+            for (std::size_t lane{ 0 }; lane < 8; ++lane)
+                sums[lane] += values[i + lane];
+        }
+        for (; i < values.size(); ++i)
+            sums[0] += values[i];
+        benchmarkSink = static_cast<double>(((sums[0] + sums[4]) + (sums[1] + sums[5]))
+                                            + ((sums[2] + sums[6]) + (sums[3] + sums[7])));
+    }));
+    report("naive loop", bestOf(repetitions, [&] { benchmarkSink = naiveAggregate(values, range).variance; }));
+    report("stream", bestOf(repetitions, [&] {
+        StreamAggregator<T> aggregator{ range };
+        for (const T value : values)
+            aggregator.add(value);
+        benchmarkSink = aggregator.result().variance;
+    }));
+    ThreadPool single{ 1 };
+    report("aggregate(1)", bestOf(repetitions, [&] { benchmarkSink = aggregate(values, single, range).variance; }));
+    ThreadPool all{ };
+    char label[32]{ };
+    std::snprintf(label, sizeof label, "aggregate(%zu)", all.threadCount());
+    report(label, bestOf(repetitions, [&] { benchmarkSink = aggregate(values, all, range).variance; }));
+    return true;
+}
+
+int main(int argc, char* argv[])
+{
+    const std::size_t count{ static_cast<std::size_t>((argc > 1 ? std::atof(argv[1]) : 100) * 1e6) };
+    const int repetitions{ argc > 2 ? std::atoi(argv[2]) : 3 };
+    std::printf("%u hardware threads, best of %d\n", std::thread::hardware_concurrency(), repetitions);
+
+    std::mt19937_64 random{ 12345 };
+    {
+        std::vector<int> ints(count);
+        std::uniform_int_distribution<int> anywhere{ -1'000'000, 1'000'000 };
+        for (int& value : ints)
+            value = anywhere(random);
+        if (!run<int>("ints", ints, { -1'000'000, 1'000'001, 20 }, repetitions))
+            return 1;
+    }
+    {
+        std::vector<double> doubles(count);
+        std::uniform_real_distribution<double> reading{ 1e9 - 1.0, 1e9 + 1.0 };
+        for (double& value : doubles)
+            value = reading(random);
+        if (!run<double>("doubles", doubles, { 1e9 - 1.0, 1e9 + 1.0, 20 }, repetitions))
+            return 1;
+    }
+    return 0;
+}
@@ -0,0 +1,449 @@
+#ifndef STREAM_AGGREGATE_H
+#define STREAM_AGGREGATE_H
+
+//** Sum, minimum, maximum, mean, variance and a histogram, in one pass **//
+
+// iostream.cpp reads numbers and echoes them back. Most programs that read a long stream of numbers want a summary
+// of them instead: how many, their sum, smallest and largest, mean and variance, and how they're spread out.
+// StreamAggregator computes all of it as the numbers arrive, without keeping them; aggregate() does the same for
+// numbers already in memory (from loadIntFile, parallel-load.h, say) on every thread of a ThreadPool:
+
+//     StreamAggregator<int> summary{ { 0, 1000, 10 } };   // histogram: 10 buckets of 100 over [0, 1000)
+//     for (int x : numbers(std::cin))
+//         summary.add(x);
+//     const Aggregate<int> result{ summary.result() };
+//
+//     const Aggregate<int> all{ aggregate(std::span<const int>{ load.values }, pool) };
+
+// The numbers are taken in blocks of 4096. Each block is summarized in quick passes while it's in the cache: one for
+// the sum, minimum and maximum, with eight independent accumulators the compiler turns into vector instructions (as
+// columnSum does in variable-store.h), one for the squared distances from the block's mean, and, with a histogram, one
+// that works out every value's bucket and one that counts them. On x86-64 CPUs with AVX2 the passes are compiled for it
+// too, picked at run time as simd-parse.h does. Block summaries are then merged pairwise, in a tree, with Chan's
+// formula for combining variances. Merging pairwise keeps rounding errors growing with the log of the count instead of
+// the count, as does the two-pass variance (the one-pass sum of squares formula can lose every digit when the mean is
+// large). Sums of doubles are also Kahan compensated within each block; sums of ints are exact.
+
+// Results are deterministic: the blocks always start every 4096 values from the start of the input, and the tree
+// that merges them depends only on how many there are, so a StreamAggregator and aggregate() on any number of
+// threads give the same result, bit for bit, for the same numbers.
+
+#include <algorithm>
+#include <cstddef>
+#include <cstdint>
+#include <limits>
+#include <span>
+#include <type_traits>
+#include <utility>
+#include <vector>
+
+#include "thread-pool.h"
+
+#if defined(__x86_64__) || defined(_M_X64)
+#define STREAM_AGGREGATE_X86 1
+#endif
+
+// A histogram of buckets equal buckets over [low, high). No histogram if buckets is 0; at most 2^31 - 2 of them. For
+// ints, a value is counted in exactly the bucket integer arithmetic would put it in, as long as buckets * (high - low)
+// is less than 2^53.
+template <typename T>
+struct HistogramRange
+{
+    T low{ };
+    T high{ };
+    std::size_t buckets{ 0 };
+};
+
+template <typename T>
+struct Aggregate
+{
+    using Sum = std::conditional_t<std::is_integral_v<T>, std::int64_t, double>; // exact for ints
+
+    std::uint64_t count{ 0 };
+    Sum sum{ };
+    T min{ }; // min and max are only meaningful if count isn't 0. They leave out NaNs (and are +inf and -inf if
+    T max{ }; // every value was one); the sum, mean and variance are NaN if any value was.
+    double mean{ };
+    double variance{ }; // the population variance: the mean squared distance from the mean
+
+    std::vector<std::uint64_t> histogram{ }; // how many values fell in each bucket
+    std::uint64_t belowRange{ 0 };           // values below low
+    std::uint64_t aboveRange{ 0 };           // values at or above high (and for doubles, NaNs)
+};
+
+namespace streamAggregateDetail
+{
+    constexpr std::size_t blockSize{ 4096 };
+    constexpr std::size_t lanes{ 8 };
+
+    template <typename T>
+    struct Partial
+    {
+        std::uint64_t count{ 0 };
+        typename Aggregate<T>::Sum sum{ };
+        T min{ };
+        T max{ };
+        double mean{ };
+        double squaredDistances{ }; // from mean
+    };
+
+    template <typename Value>
+    Value reduceLanes(const Value (&values)[lanes])
+    {
+        return ((values[0] + values[4]) + (values[1] + values[5]))
+               + ((values[2] + values[6]) + (values[3] + values[7]));
+    }
+
+    // Count values (at most blockSize) into counts: [0] below the range, [1 ... buckets] the buckets, [buckets + 1]
+    // above it. Each value's place in counts is worked out first, eight at a time so that the compiler vectorizes it
+    // (ints are converted to double in a loop of their own, or it won't), and then counted.
+    template <typename T, typename Slot>
+    [[gnu::always_inline]] inline void countSlots(const T* values, std::size_t count, std::uint64_t* counts, Slot slot)
+    {
+        std::int32_t slots[blockSize];
+        std::size_t i{ 0 };
+        for (; i + lanes <= count; i += lanes)
+        {
+            if constexpr (std::is_integral_v<T>)
+            {
+                double converted[lanes];
+                for (std::size_t lane{ 0 }; lane < lanes; ++lane)
+                    converted[lane] = static_cast<double>(values[i + lane]);
+                for (std::size_t lane{ 0 }; lane < lanes; ++lane)
+                    slots[i + lane] = slot(converted[lane]);
+            }
+            else
+            {
+                for (std::size_t lane{ 0 }; lane < lanes; ++lane)
+                    slots[i + lane] = slot(values[i + lane]);
+            }
+        }
+        for (; i < count; ++i)
+            slots[i] = slot(static_cast<double>(values[i]));
+        for (i = 0; i < count; ++i)
+            ++counts[slots[i]];
+    }
+
+    // Count values into counts, laid out as for countSlots, by the bucket of range each one falls in.
+    template <typename T>
+    [[gnu::always_inline]] inline void countBuckets(const T* values, std::size_t count, const HistogramRange<T>& range,
+                                                    std::uint64_t* counts)
+    {
+        const double buckets{ static_cast<double>(range.buckets) };
+        const double low{ static_cast<double>(range.low) };
+        if constexpr (std::is_integral_v<T>)
+        {
+            // The bucket is offset * buckets / width rounded down. Multiplying by a slightly smaller buckets / width
+            // instead gives a guess that's right or one too low, and comparing with offset * buckets settles it.
+            // Every product compared is an integer below 2^53, so the comparison is exact.
+            const double width{ static_cast<double>(range.high) - low };
+            const double scale{ buckets / width * (1 - 0x1p-50) };
+            countSlots(values, count, counts, [=](double value) {
+                const double offset{ value - low };
+                double bucket{ offset * scale };
+                bucket = bucket >= 0 ? bucket : -1.0;
+                bucket = static_cast<double>(static_cast<std::int32_t>(std::min(bucket, buckets)));
+                bucket = (bucket + 1) * width <= offset * buckets ? bucket + 1 : bucket;
+                return static_cast<std::int32_t>(std::min(bucket, buckets)) + 1;
+            });
+        }
+        else
+        {
+            const double high{ range.high };
+            const double scale{ buckets / (high - low) };
+            const double lastBucket{ buckets - 0.5 }; // rounds down to the last bucket
+            countSlots(values, count, counts, [=](double value) {
+                double position{ (value - low) * scale };
+                position = position >= 0 ? position : -1.0;
+                position = value < high ? std::min(position, lastBucket) : buckets; // NaN: not below high
+                return static_cast<std::int32_t>(position) + 1;
+            });
+        }
+    }
+
+    // Summarize count (1 to blockSize) values, and count them into counts if there's a histogram. Always inlined,
+    // so that each wrapper below compiles it for its own instruction set.
+    template <typename T>
+    [[gnu::always_inline]] inline Partial<T> summarizeBlock(const T* values, std::size_t count,
+                                                            const HistogramRange<T>& range, std::uint64_t* counts)
+    {
+        using Sum = typename Aggregate<T>::Sum;
+
+        Sum sums[lanes]{ };
+        Sum compensations[lanes]{ }; // Kahan: what each lane's sum has lost to rounding (doubles only)
+        // Seeded with values that every number replaces, rather than with values[0]: a NaN never compares less or
+        // greater, so wherever it is in the block it's left out, instead of sticking when it happens to come first.
+        using Limits = std::numeric_limits<T>;
+        T mins[lanes]{ };
+        T maxes[lanes]{ };
+        std::fill(std::begin(mins), std::end(mins), Limits::has_infinity ? Limits::infinity() : Limits::max());
+        std::fill(std::begin(maxes), std::end(maxes), Limits::has_infinity ? -Limits::infinity() : Limits::lowest());
+        const auto accumulate{ [&](std::size_t lane, T value) {
+            if constexpr (std::is_floating_point_v<T>)
+            {
+                const Sum adjusted{ value - compensations[lane] };
+                const Sum total{ sums[lane] + adjusted };
+                compensations[lane] = (total - sums[lane]) - adjusted;
+                sums[lane] = total;
+            }
+            else
+                sums[lane] += static_cast<Sum>(value);
+            mins[lane] = value < mins[lane] ? value : mins[lane];
+            maxes[lane] = value > maxes[lane] ? value : maxes[lane];
+        } };
+
+        std::size_t i{ 0 };
+        for (; i + lanes <= count; i += lanes)
+        {
+            for (std::size_t lane{ 0 }; lane < lanes; ++lane)
+                accumulate(lane, values[i + lane]);
+        }
+        for (; i < count; ++i)
+            accumulate(i % lanes, values[i]);
+
+        Partial<T> partial{ };
+        partial.count = count;
+        if constexpr (std::is_floating_point_v<T>)
+        {
+            for (std::size_t lane{ 0 }; lane < lanes; ++lane)
+                sums[lane] -= compensations[lane];
+        }
+        partial.sum = reduceLanes(sums);
+        partial.min = *std::min_element(std::begin(mins), std::end(mins));
+        partial.max = *std::max_element(std::begin(maxes), std::end(maxes));
+        partial.mean = static_cast<double>(partial.sum) / static_cast<double>(count);
+
+        double squares[lanes]{ };
+        for (i = 0; i + lanes <= count; i += lanes)
+        {
+            for (std::size_t lane{ 0 }; lane < lanes; ++lane)
+            {
+                const double distance{ static_cast<double>(values[i + lane]) - partial.mean };
+                squares[lane] += distance * distance;
+            }
+        }
+        for (; i < count; ++i)
+        {
+            const double distance{ static_cast<double>(values[i]) - partial.mean };
+            squares[i % lanes] += distance * distance;
+        }
+        partial.squaredDistances = reduceLanes(squares);
+
+        if (range.buckets != 0)
+            countBuckets(values, count, range, counts);
+        return partial;
+    }
+
+    template <typename T>
+    Partial<T> summarizeBaseline(const T* values, std::size_t count, const HistogramRange<T>& range,
+                                 std::uint64_t* counts)
+    {
+        return summarizeBlock(values, count, range, counts);
+    }
+
+#ifdef STREAM_AGGREGATE_X86
+    // AVX2 has 8-lane int32 min and max and widening adds, which SSE2 lacks. It doesn't include FMA, so the
+    // floating point arithmetic, and with it the result, is the same as the baseline version's.
+    template <typename T>
+    [[gnu::target("avx2")]] Partial<T> summarizeAvx2(const T* values, std::size_t count, const HistogramRange<T>& range,
+                                                     std::uint64_t* counts)
+    {
+        return summarizeBlock(values, count, range, counts);
+    }
+#endif
+
+    template <typename T>
+    using SummarizeFunction = Partial<T> (*)(const T* values, std::size_t count, const HistogramRange<T>& range,
+                                             std::uint64_t* counts);
+
+    template <typename T>
+    SummarizeFunction<T> selectSummarize()
+    {
+#ifdef STREAM_AGGREGATE_X86
+        __builtin_cpu_init();
+        if (__builtin_cpu_supports("avx2"))
+            return summarizeAvx2<T>;
+#endif
+        return summarizeBaseline<T>;
+    }
+
+    // Summarize a block with the fastest version the CPU supports.
+    template <typename T>
+    Partial<T> summarize(const T* values, std::size_t count, const HistogramRange<T>& range, std::uint64_t* counts)
+    {
+        static const SummarizeFunction<T> best{ selectSummarize<T>() };
+        return best(values, count, range, counts);
+    }
+
+    // Chan, Golub and LeVeque's formula for the variance of two groups combined.
+    template <typename T>
+    Partial<T> merge(const Partial<T>& a, const Partial<T>& b)
+    {
+        if (a.count == 0)
+            return b;
+        if (b.count == 0)
+            return a;
+        Partial<T> merged{ };
+        merged.count = a.count + b.count;
+        merged.sum = a.sum + b.sum;
+        merged.min = b.min < a.min ? b.min : a.min;
+        merged.max = b.max > a.max ? b.max : a.max;
+        const double total{ static_cast<double>(merged.count) };
+        const double delta{ b.mean - a.mean };
+        merged.mean = a.mean + delta * (static_cast<double>(b.count) / total);
+        const double weight{ static_cast<double>(a.count) * static_cast<double>(b.count) / total };
+        merged.squaredDistances = a.squaredDistances + b.squaredDistances + delta * delta * weight;
+        return merged;
+    }
+
+    // Merges block summaries, given in order, in a fixed tree: like a binary counter, two subtrees are merged as
+    // soon as they cover the same number of blocks, so the shape depends only on the number of blocks.
+    template <typename T>
+    class Reduction
+    {
+    public:
+        void push(Partial<T> partial)
+        {
+            std::size_t blocks{ 1 };
+            while (!m_subtrees.empty() && m_subtrees.back().second == blocks)
+            {
+                partial = merge(m_subtrees.back().first, partial);
+                blocks *= 2;
+                m_subtrees.pop_back();
+            }
+            m_subtrees.emplace_back(partial, blocks);
+        }
+
+        // Everything pushed so far (and then last, if it has any values), merged.
+        Partial<T> total(const Partial<T>& last = { }) const
+        {
+            Partial<T> result{ last };
+            for (auto subtree{ m_subtrees.rbegin() }; subtree != m_subtrees.rend(); ++subtree)
+                result = merge(subtree->first, result);
+            return result;
+        }
+
+    private:
+        std::vector<std::pair<Partial<T>, std::size_t>> m_subtrees{ }; // with how many blocks each covers
+    };
+
+    template <typename T>
+    Aggregate<T> finish(const Partial<T>& total, const HistogramRange<T>& range,
+                        const std::vector<std::uint64_t>& counts)
+    {
+        Aggregate<T> result{ };
+        result.count = total.count;
+        result.sum = total.sum;
+        result.min = total.min;
+        result.max = total.max;
+        if (total.count != 0)
+        {
+            result.mean = static_cast<double>(total.sum) / static_cast<double>(total.count);
+            result.variance = total.squaredDistances / static_cast<double>(total.count);
+        }
+        if (range.buckets != 0)
+        {
+            result.belowRange = counts[0];
+            const auto buckets{ counts.begin() + 1 };
+            result.histogram.assign(buckets, buckets + static_cast<std::ptrdiff_t>(range.buckets));
+            result.aboveRange = counts[range.buckets + 1];
+        }
+        return result;
+    }
+}
+
+// Summarizes numbers handed to it one at a time (or a few at a time), keeping only the current block of them.
+template <typename T>
+class StreamAggregator
+{
+public:
+    explicit StreamAggregator(HistogramRange<T> range = { })
+        : m_range{ range }
+        , m_counts(range.buckets != 0 ? range.buckets + 2 : 0)
+    {
+        m_block.reserve(streamAggregateDetail::blockSize);
+    }
+
+    void add(T value)
+    {
+        m_block.push_back(value);
+        if (m_block.size() == streamAggregateDetail::blockSize)
+            finishBlock();
+    }
+
+    void add(std::span<const T> values)
+    {
+        while (!values.empty())
+        {
+            const std::size_t taken{ std::min(values.size(), streamAggregateDetail::blockSize - m_block.size()) };
+            m_block.insert(m_block.end(), values.begin(), values.begin() + static_cast<std::ptrdiff_t>(taken));
+            values = values.subspan(taken);
+            if (m_block.size() == streamAggregateDetail::blockSize)
+                finishBlock();
+        }
+    }
+
+    // The summary of everything added so far. More can be added afterwards.
+    Aggregate<T> result() const
+    {
+        using namespace streamAggregateDetail;
+        std::vector<std::uint64_t> counts{ m_counts };
+        Partial<T> last{ };
+        if (!m_block.empty())
+            last = summarize(m_block.data(), m_block.size(), m_range, counts.data());
+        return finish(m_reduction.total(last), m_range, counts);
+    }
+
+private:
+    void finishBlock()
+    {
+        using namespace streamAggregateDetail;
+        m_reduction.push(summarize(m_block.data(), m_block.size(), m_range, m_counts.data()));
+        m_block.clear();
+    }
+
+    HistogramRange<T> m_range{ };
+    std::vector<T> m_block{ };
+    std::vector<std::uint64_t> m_counts{ };
+    streamAggregateDetail::Reduction<T> m_reduction{ };
+};
+
+// Summarize values on every thread of pool. Each task takes a run of whole blocks; the block summaries are merged
+// afterwards in the same tree StreamAggregator uses, so the result doesn't depend on the number of threads.
+template <typename T>
+Aggregate<T> aggregate(std::span<const T> values, ThreadPool& pool, HistogramRange<T> range = { })
+{
+    using namespace streamAggregateDetail;
+
+    constexpr std::size_t blocksPerTask{ 64 }; // 256K values: enough to make handing out a task cheap
+    const std::size_t blockCount{ (values.size() + blockSize - 1) / blockSize };
+    const std::size_t taskCount{ (blockCount + blocksPerTask - 1) / blocksPerTask };
+    const std::size_t countsSize{ range.buckets != 0 ? range.buckets + 2 : 0 };
+
+    std::vector<Partial<T>> partials(blockCount);
+    std::vector<std::vector<std::uint64_t>> taskCounts(taskCount);
+    pool.run(taskCount, [&](std::size_t task) {
+        std::vector<std::uint64_t>& counts{ taskCounts[task] };
+        counts.assign(countsSize, 0);
+        const std::size_t lastBlock{ std::min(blockCount, (task + 1) * blocksPerTask) };
+        for (std::size_t block{ task * blocksPerTask }; block < lastBlock; ++block)
+        {
+            const std::size_t first{ block * blockSize };
+            const std::size_t count{ std::min(blockSize, values.size() - first) };
+            partials[block] = summarize(values.data() + first, count, range, counts.data());
+        }
+    });
+
+    Reduction<T> reduction{ };
+    for (const Partial<T>& partial : partials)
+        reduction.push(partial);
+    std::vector<std::uint64_t> counts(countsSize);
+    for (const std::vector<std::uint64_t>& task : taskCounts)
+    {
+        for (std::size_t i{ 0 }; i < countsSize; ++i)
+            counts[i] += task[i];
+    }
+    return finish(reduction.total(), range, counts);
+}
+
+#endif
@@ -0,0 +1,177 @@
+//** Benchmark: identifiers as std::string vs interned Symbols **//
+
+// Build and run:
+//     g++ -std=c++20 -O2 -pthread symbol-table-benchmark.cpp -o symbol-table-benchmark
+//     ./symbol-table-benchmark [megabytes, default 64] [threads, default all cores] [source files...]
+
+// The corpus is made by repeating the given source files (by default, every .cpp and .h file in the current
+// directory) until it reaches the requested size, and every identifier in it is stored two ways:
+    // strings: a std::vector<std::string> with one string per occurrence
+    // symbols: a std::vector<Symbol> with one 4-byte id per occurrence, plus the SymbolTable
+// Memory is measured as the growth of the heap (mallinfo2) while building each. Then both are searched for every
+// occurrence of one name, and finally the corpus is interned again on several threads into one shared table.
+
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <filesystem>
+#include <malloc.h>
+#include <string>
+#include <string_view>
+#include <thread>
+#include <vector>
+
+#include "identifier-lexer.h"
+#include "mapped-input.h"
+#include "symbol-table.h"
+
+std::atomic<std::size_t> benchmarkSink{ };
+
+template <typename Run>
+double timeIt(Run&& run)
+{
+    const auto start{ std::chrono::steady_clock::now() };
+    run();
+    const std::chrono::duration<double> elapsed{ std::chrono::steady_clock::now() - start };
+    return elapsed.count();
+}
+
+// Bytes allocated with malloc, including big blocks that malloc got directly from mmap.
+std::size_t heapInUse()
+{
+    const struct mallinfo2 info{ mallinfo2() };
+    return info.uordblks + info.hblkhd;
+}
+
+template <typename Callback>
+void forEachIdentifier(std::string_view text, Callback&& onIdentifier)
+{
+    lexWords(text, [&](const Token& token) {
+        if (token.kind == TokenKind::identifier)
+            onIdentifier(token.text);
+    });
+}
+
+int main(int argc, char* argv[])
+{
+    const double megabytes{ argc > 1 ? std::atof(argv[1]) : 64 };
+    const unsigned threads{ argc > 2 ? static_cast<unsigned>(std::atoi(argv[2]))
+                                     : std::max(1u, std::thread::hardware_concurrency()) };
+
+    std::vector<std::string> paths{ };
+    for (int i{ 3 }; i < argc; ++i)
+        paths.emplace_back(argv[i]);
+    if (paths.empty())
+    {
+        for (const auto& entry : std::filesystem::directory_iterator{ "." })
+        {
+            const std::string extension{ entry.path().extension().string() };
+            if (entry.is_regular_file() && (extension == ".cpp" || extension == ".h"))
+                paths.push_back(entry.path().string());
+        }
+    }
+
+    std::string sample{ };
+    for (const std::string& path : paths)
+    {
+        const MappedInput input{ path.c_str() };
+        sample.append(input.text());
+        sample += '\n';
+    }
+    if (sample.size() <= paths.size())
+    {
+        std::printf("no source files found\n");
+        return 1;
+    }
+    std::string corpus{ };
+    while (corpus.size() < megabytes * 1e6)
+        corpus += sample;
+
+    // One std::string per occurrence.
+    std::vector<std::string> strings{ };
+    std::size_t stringBytes{ heapInUse() };
+    const double stringSeconds{ timeIt([&] {
+        forEachIdentifier(corpus, [&](std::string_view name) { strings.emplace_back(name); });
+        strings.shrink_to_fit();
+    }) };
+    stringBytes = heapInUse() - stringBytes;
+
+    // One Symbol per occurrence.
+    std::vector<Symbol> symbols{ };
+    std::size_t symbolBytes{ heapInUse() };
+    SymbolTable* table{ };
+    const double symbolSeconds{ timeIt([&] {
+        table = new SymbolTable{ };
+        forEachIdentifier(corpus, [&](std::string_view name) { symbols.push_back(table->intern(name)); });
+        symbols.shrink_to_fit();
+    }) };
+    symbolBytes = heapInUse() - symbolBytes;
+
+    for (std::size_t i{ 0 }; i < strings.size(); ++i)
+    {
+        if (table->text(symbols[i]) != strings[i])
+        {
+            std::printf("MISMATCH at occurrence %zu\n", i);
+            return 1;
+        }
+    }
+
+    std::printf("%.1f MB corpus, %zu identifier occurrences, %zu distinct\n", static_cast<double>(corpus.size()) / 1e6,
+                strings.size(), table->size());
+    std::printf("%-8s %10.1f MB  %8.1f ms to build\n", "strings", static_cast<double>(stringBytes) / 1e6,
+                stringSeconds * 1e3);
+    std::printf("%-8s %10.1f MB  %8.1f ms to build   (%.1fx less memory; table alone %.2f MB)\n", "symbols",
+                static_cast<double>(symbolBytes) / 1e6, symbolSeconds * 1e3,
+                static_cast<double>(stringBytes) / static_cast<double>(symbolBytes),
+                static_cast<double>(table->bytesUsed()) / 1e6);
+
+    // Count the occurrences of one name (whichever is in the middle of the corpus).
+    const std::string target{ strings[strings.size() / 2] };
+    const Symbol targetSymbol{ *table->find(target) };
+    std::size_t stringMatches{ 0 };
+    std::size_t symbolMatches{ 0 };
+    const double stringCompare{ timeIt([&] {
+        for (int repetition{ 0 }; repetition < 10; ++repetition)
+            stringMatches = static_cast<std::size_t>(std::count(strings.begin(), strings.end(), target));
+    }) };
+    const double symbolCompare{ timeIt([&] {
+        for (int repetition{ 0 }; repetition < 10; ++repetition)
+            symbolMatches = static_cast<std::size_t>(std::count(symbols.begin(), symbols.end(), targetSymbol));
+    }) };
+    benchmarkSink = stringMatches + symbolMatches;
+    std::printf("count \"%s\": strings %.2f ns/occurrence, symbols %.2f ns/occurrence (%zu matches, %s)\n",
+                target.c_str(), stringCompare * 1e9 / (10.0 * static_cast<double>(strings.size())),
+                symbolCompare * 1e9 / (10.0 * static_cast<double>(symbols.size())), symbolMatches,
+                stringMatches == symbolMatches ? "agree" : "DISAGREE");
+    delete table;
+
+    // Concurrent interning: each thread takes a slice of the corpus, cut at line ends.
+    for (unsigned threadCount{ 1 }; threadCount <= threads; threadCount *= 2)
+    {
+        SymbolTable shared{ };
+        const double seconds{ timeIt([&] {
+            std::vector<std::thread> workers{ };
+            std::size_t begin{ 0 };
+            for (unsigned i{ 0 }; i < threadCount; ++i)
+            {
+                std::size_t end{ i + 1 == threadCount ? corpus.size() : corpus.find('\n', corpus.size() * (i + 1) / threadCount) };
+                end = std::min(end, corpus.size());
+                workers.emplace_back([&shared, slice{ std::string_view{ corpus }.substr(begin, end - begin) }] {
+                    std::size_t sum{ 0 };
+                    forEachIdentifier(slice, [&](std::string_view name) { sum += shared.intern(name).id; });
+                    benchmarkSink += sum;
+                });
+                begin = end;
+            }
+            for (std::thread& worker : workers)
+                worker.join();
+        }) };
+        std::printf("%2u threads: %8.1f MB/s interned (%zu distinct)\n", threadCount,
+                    static_cast<double>(corpus.size()) / seconds / 1e6, shared.size());
+        if (threadCount * 2 > threads && threadCount != threads)
+            threadCount = threads / 2;
+    }
+    return 0;
+}
@@ -0,0 +1,291 @@
+#ifndef SYMBOL_TABLE_H
+#define SYMBOL_TABLE_H
+
+//** Storing each identifier once **//
+
+// A name like numberOfChars (keywords-identifiers.cpp) is written out every time it's used, so a tool that keeps a
+// std::string for each occurrence stores the same characters thousands of times, and comparing two names means
+// comparing their characters. A symbol table stores each distinct name once and hands out a small id for it:
+
+//     SymbolTable symbols{ };
+//     const Symbol a{ symbols.intern("numberOfChars") };
+//     const Symbol b{ symbols.intern("numberOfChars") };   // same name, so the same id: a == b
+//     symbols.text(a);                                     // "numberOfChars"
+
+// A Symbol is 4 bytes, and comparing two of them is one integer compare. The characters of all names are packed
+// together in MonotonicArena blocks (arena.h), with no per-name allocation or header.
+
+// intern() may be called from many threads at once. The table is split into shards by hash, each with its own lock,
+// hash table and arena. Most calls are for names seen before, and those take no lock at all: a name's hash table
+// slot is written only after its text is in place, and a shard's old hash tables are kept (they add up to less than
+// the current one) so a thread still reading one after the shard grew is safe. Only adding a new name locks its
+// shard. text() takes no lock either: the id-to-text entries live in segments that are never moved once created.
+
+// Ids are not consecutive (the low bits say which shard a name is in), but every id is below 2^32 and stays valid
+// for as long as the table exists.
+
+#include <array>
+#include <atomic>
+#include <bit>
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <optional>
+#include <stdexcept>
+#include <string_view>
+#include <vector>
+
+#include "arena.h"
+
+struct Symbol
+{
+    std::uint32_t id{ };
+
+    friend bool operator==(Symbol, Symbol) = default;
+    friend auto operator<=>(Symbol, Symbol) = default; // by id, not alphabetical
+};
+
+template <>
+struct std::hash<Symbol>
+{
+    std::size_t operator()(Symbol symbol) const { return symbol.id * 0x9E3779B97F4A7C15ull; }
+};
+
+class SymbolTable
+{
+public:
+    static constexpr unsigned shardBits{ 6 };
+    static constexpr std::size_t shardCount{ std::size_t{ 1 } << shardBits };
+
+    SymbolTable() = default;
+    SymbolTable(const SymbolTable&) = delete;
+    SymbolTable& operator=(const SymbolTable&) = delete;
+
+    ~SymbolTable()
+    {
+        for (Shard& shard : m_shards)
+        {
+            for (std::atomic<Entry*>& segment : shard.segments)
+                delete[] segment.load(std::memory_order_relaxed);
+        }
+    }
+
+    // The symbol for text, adding it if it's new. Safe to call from several threads at once.
+    Symbol intern(std::string_view text)
+    {
+        const std::uint64_t hash{ hashText(text) };
+        Shard& shard{ m_shards[hash & (shardCount - 1)] };
+        const std::uint32_t slotHash{ static_cast<std::uint32_t>(hash >> 32) };
+
+        // Names seen before are found without taking the lock.
+        if (const std::uint32_t index{ lookup(shard, text, slotHash) }; index != 0)
+            return makeSymbol(hash, index - 1);
+
+        std::lock_guard lock{ shard.mutex };
+        if (const std::uint32_t index{ lookup(shard, text, slotHash) }; index != 0)
+            return makeSymbol(hash, index - 1); // another thread added it first
+
+        if (shard.count == maxPerShard)
+            throw std::length_error{ "SymbolTable: too many symbols" };
+
+        char* copy{ static_cast<char*>(shard.text.allocate(text.size() ? text.size() : 1, 1)) };
+        std::memcpy(copy, text.data(), text.size());
+        const std::uint32_t index{ shard.count++ };
+        entryAt(shard, index) = Entry{ copy, static_cast<std::uint32_t>(text.size()) };
+
+        if (shard.tables.empty() || 2 * shard.count > shard.tables.back()->size()) // keep the table at most half full
+            grow(shard);
+        insertSlot(*shard.tables.back(), packSlot(slotHash, index + 1));
+        return makeSymbol(hash, index);
+    }
+
+    // The symbol for text if it has been interned.
+    std::optional<Symbol> find(std::string_view text) const
+    {
+        const std::uint64_t hash{ hashText(text) };
+        const Shard& shard{ m_shards[hash & (shardCount - 1)] };
+        const std::uint32_t slotHash{ static_cast<std::uint32_t>(hash >> 32) };
+        std::uint32_t index{ lookup(shard, text, slotHash) };
+        if (index == 0)
+        {
+            std::lock_guard lock{ shard.mutex };
+            index = lookup(shard, text, slotHash);
+        }
+        if (index == 0)
+            return std::nullopt;
+        return makeSymbol(hash, index - 1);
+    }
+
+    // The text of a symbol from this table. Takes no lock.
+    std::string_view text(Symbol symbol) const
+    {
+        const Shard& shard{ m_shards[symbol.id & (shardCount - 1)] };
+        const Entry& entry{ entryAt(shard, symbol.id >> shardBits) };
+        return { entry.data, entry.size };
+    }
+
+    // The number of distinct symbols.
+    std::size_t size() const
+    {
+        std::size_t total{ 0 };
+        for (const Shard& shard : m_shards)
+        {
+            std::lock_guard lock{ shard.mutex };
+            total += shard.count;
+        }
+        return total;
+    }
+
+    // Memory held by the table: text, hash tables and id-to-text entries.
+    std::size_t bytesUsed() const
+    {
+        std::size_t total{ sizeof(*this) };
+        for (const Shard& shard : m_shards)
+        {
+            std::lock_guard lock{ shard.mutex };
+            total += shard.text.bytesReserved();
+            for (const std::unique_ptr<SlotTable>& table : shard.tables)
+                total += table->size() * sizeof(std::uint64_t);
+            for (std::size_t segment{ 0 }; segment < maxSegments; ++segment)
+            {
+                if (shard.segments[segment].load(std::memory_order_relaxed))
+                    total += (firstSegmentSize << segment) * sizeof(Entry);
+            }
+        }
+        return total;
+    }
+
+private:
+    struct Entry
+    {
+        const char* data{ };
+        std::uint32_t size{ };
+    };
+
+    // A hash table slot: the high half of the name's 64-bit hash (to skip most string compares) in the upper 32 bits,
+    // and 1 + the name's index in its shard in the lower 32. 0 means empty.
+    using SlotTable = std::vector<std::atomic<std::uint64_t>>;
+
+    // Shard entries live in segments of 256, 512, 1024, ... entries, so existing entries never move.
+    static constexpr unsigned firstSegmentBits{ 8 };
+    static constexpr std::size_t firstSegmentSize{ std::size_t{ 1 } << firstSegmentBits };
+    static constexpr std::uint32_t maxPerShard{ std::uint32_t{ 1 } << (32 - shardBits) };
+    static constexpr std::size_t maxSegments{ 32 - shardBits - firstSegmentBits + 1 };
+
+    struct alignas(64) Shard
+    {
+        mutable std::mutex mutex{ };
+        MonotonicArena text{ 4096 };
+        std::uint32_t count{ 0 };
+        std::atomic<const SlotTable*> table{ nullptr }; // the current one, for lookups without the lock
+        std::vector<std::unique_ptr<SlotTable>> tables{ }; // every one so far: a lookup may still be reading an old one
+        std::array<std::atomic<Entry*>, maxSegments> segments{ };
+    };
+
+    // FNV-1a over the text, then a final mix so that both halves of the result are well distributed.
+    static std::uint64_t hashText(std::string_view text)
+    {
+        std::uint64_t hash{ 0xCBF29CE484222325ull };
+        for (const char c : text)
+            hash = (hash ^ static_cast<unsigned char>(c)) * 0x100000001B3ull;
+        hash ^= hash >> 29;
+        hash *= 0xBF58476D1CE4E5B9ull;
+        return hash ^ (hash >> 32);
+    }
+
+    static Symbol makeSymbol(std::uint64_t hash, std::uint32_t index)
+    {
+        return Symbol{ (index << shardBits) | static_cast<std::uint32_t>(hash & (shardCount - 1)) };
+    }
+
+    static std::size_t segmentOf(std::size_t index, std::size_t& offset)
+    {
+        const std::size_t shifted{ index + firstSegmentSize };
+        const std::size_t segment{ static_cast<std::size_t>(std::bit_width(shifted)) - 1 - firstSegmentBits };
+        offset = shifted - (firstSegmentSize << segment);
+        return segment;
+    }
+
+    static const Entry& entryAt(const Shard& shard, std::size_t index)
+    {
+        std::size_t offset{ };
+        const std::size_t segment{ segmentOf(index, offset) };
+        return shard.segments[segment].load(std::memory_order_acquire)[offset];
+    }
+
+    // Called with the shard locked; creates the segment if this is its first entry.
+    static Entry& entryAt(Shard& shard, std::size_t index)
+    {
+        std::size_t offset{ };
+        const std::size_t segment{ segmentOf(index, offset) };
+        Entry* entries{ shard.segments[segment].load(std::memory_order_relaxed) };
+        if (!entries)
+        {
+            entries = new Entry[firstSegmentSize << segment];
+            shard.segments[segment].store(entries, std::memory_order_release);
+        }
+        return entries[offset];
+    }
+
+    static std::uint64_t packSlot(std::uint32_t slotHash, std::uint32_t index)
+    {
+        return (static_cast<std::uint64_t>(slotHash) << 32) | index;
+    }
+
+    // 1 + the shard index of text, or 0 if it isn't in the shard's current table. Linear probing. Without the lock
+    // this may miss a name that's being added at the same moment, but never returns a wrong one: a slot is only
+    // published after its entry is written.
+    static std::uint32_t lookup(const Shard& shard, std::string_view text, std::uint32_t slotHash)
+    {
+        const SlotTable* table{ shard.table.load(std::memory_order_acquire) };
+        if (!table)
+            return 0;
+        const std::size_t mask{ table->size() - 1 };
+        for (std::size_t position{ slotHash & mask };; position = (position + 1) & mask)
+        {
+            const std::uint64_t slot{ (*table)[position].load(std::memory_order_acquire) };
+            if (slot == 0)
+                return 0;
+            if (static_cast<std::uint32_t>(slot >> 32) == slotHash)
+            {
+                const std::uint32_t index{ static_cast<std::uint32_t>(slot) };
+                const Entry& entry{ entryAt(shard, index - 1) };
+                if (std::string_view{ entry.data, entry.size } == text)
+                    return index;
+            }
+        }
+    }
+
+    static void insertSlot(SlotTable& table, std::uint64_t slot)
+    {
+        const std::size_t mask{ table.size() - 1 };
+        std::size_t position{ static_cast<std::uint32_t>(slot >> 32) & mask };
+        while (table[position].load(std::memory_order_relaxed) != 0)
+            position = (position + 1) & mask;
+        table[position].store(slot, std::memory_order_release);
+    }
+
+    // Called with the shard locked. The new table is filled before it's published, and the old one stays alive.
+    static void grow(Shard& shard)
+    {
+        const SlotTable* old{ shard.tables.empty() ? nullptr : shard.tables.back().get() };
+        auto table{ std::make_unique<SlotTable>(old ? old->size() * 2 : 64) };
+        if (old)
+        {
+            for (const std::atomic<std::uint64_t>& slot : *old)
+            {
+                if (const std::uint64_t value{ slot.load(std::memory_order_relaxed) }; value != 0)
+                    insertSlot(*table, value);
+            }
+        }
+        shard.table.store(table.get(), std::memory_order_release);
+        shard.tables.push_back(std::move(table));
+    }
+
+    std::array<Shard, shardCount> m_shards{ };
+};
+
+#endif
@@ -0,0 +1,158 @@
+#ifndef THREAD_POOL_H
+#define THREAD_POOL_H
+
+//** A small fixed-size thread pool **//
+
+// ThreadPool starts its worker threads once and reuses them, so a program that runs many parallel steps doesn't
+// pay for creating threads each time. Work is given as a number of tasks and a function that runs one task by
+// index:
+
+//     ThreadPool pool{ };                          // one thread per core
+//     pool.run(chunkCount, [&](std::size_t chunk) { parseChunk(chunk); });
+
+// run() returns once every task has finished. The calling thread works on tasks too, and tasks are handed out one
+// at a time from a shared counter, so a thread that finishes early just takes the next task instead of sitting idle.
+
+// Any number of threads may share one pool: the pool works on one run() at a time, and a run() called while another
+// is in progress waits for it to finish first. A task must not call run() on its own pool, which would wait forever.
+
+#include <algorithm>
+#include <atomic>
+#include <condition_variable>
+#include <cstddef>
+#include <functional>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+class ThreadPool
+{
+public:
+    // threadCount includes the thread that calls run(); 0 means one per hardware thread.
+    explicit ThreadPool(std::size_t threadCount = 0)
+    {
+        if (threadCount == 0)
+            threadCount = std::max(1u, std::thread::hardware_concurrency());
+
+        for (std::size_t i{ 1 }; i < threadCount; ++i)
+            m_workers.emplace_back([this] { workerLoop(); });
+    }
+
+    ThreadPool(const ThreadPool&) = delete;
+    ThreadPool& operator=(const ThreadPool&) = delete;
+
+    ~ThreadPool()
+    {
+        {
+            std::lock_guard lock{ m_mutex };
+            m_shuttingDown = true;
+        }
+        m_wake.notify_all();
+        for (std::thread& worker : m_workers)
+            worker.join();
+    }
+
+    std::size_t threadCount() const { return m_workers.size() + 1; }
+
+    // Run task(0) ... task(taskCount - 1) across the pool and wait for all of them.
+    void run(std::size_t taskCount, const std::function<void(std::size_t)>& task)
+    {
+        if (taskCount == 0)
+            return;
+        std::lock_guard runLock{ m_runMutex }; // held until every task and worker is done with this run
+        runTasks(taskCount, task);
+    }
+
+    // Like run(), but if the pool is busy with another caller's run(), return false at once instead of waiting (and
+    // run none of the tasks), so the caller can do the work some other way.
+    bool tryRun(std::size_t taskCount, const std::function<void(std::size_t)>& task)
+    {
+        std::unique_lock runLock{ m_runMutex, std::try_to_lock };
+        if (!runLock.owns_lock())
+            return false;
+        if (taskCount != 0)
+            runTasks(taskCount, task);
+        return true;
+    }
+
+private:
+    void runTasks(std::size_t taskCount, const std::function<void(std::size_t)>& task)
+    {
+        {
+            std::lock_guard lock{ m_mutex };
+            m_task = &task;
+            m_taskCount = taskCount;
+            m_nextTask.store(0, std::memory_order_relaxed);
+            m_unfinished = taskCount;
+            ++m_generation;
+        }
+        m_wake.notify_all();
+
+        workOnTasks(task, taskCount);
+
+        std::unique_lock lock{ m_mutex };
+        // Also wait for workers to leave workOnTasks, so none of them can pick up the next run's tasks with this task.
+        m_done.wait(lock, [this] { return m_unfinished == 0 && m_activeWorkers == 0; });
+        m_task = nullptr;
+    }
+
+    void workOnTasks(const std::function<void(std::size_t)>& task, std::size_t taskCount)
+    {
+        std::size_t finished{ 0 };
+        for (std::size_t index{ m_nextTask.fetch_add(1) }; index < taskCount; index = m_nextTask.fetch_add(1))
+        {
+            task(index);
+            ++finished;
+        }
+
+        if (finished != 0)
+        {
+            std::lock_guard lock{ m_mutex };
+            m_unfinished -= finished;
+            if (m_unfinished == 0)
+                m_done.notify_all();
+        }
+    }
+
+    void workerLoop()
+    {
+        std::size_t seenGeneration{ 0 };
+        for (;;)
+        {
+            const std::function<void(std::size_t)>* task{ };
+            std::size_t taskCount{ };
+            {
+                std::unique_lock lock{ m_mutex };
+                m_wake.wait(lock, [&] { return m_shuttingDown || (m_generation != seenGeneration && m_task); });
+                if (m_shuttingDown)
+                    return;
+                seenGeneration = m_generation;
+                task = m_task;
+                taskCount = m_taskCount;
+                ++m_activeWorkers;
+            }
+            workOnTasks(*task, taskCount);
+            {
+                std::lock_guard lock{ m_mutex };
+                --m_activeWorkers;
+            }
+            m_done.notify_all();
+        }
+    }
+
+    std::vector<std::thread> m_workers{ };
+    std::mutex m_runMutex{ }; // one run() at a time
+    std::mutex m_mutex{ };
+    std::condition_variable m_wake{ };
+    std::condition_variable m_done{ };
+
+    const std::function<void(std::size_t)>* m_task{ };
+    std::size_t m_taskCount{ 0 };
+    std::atomic<std::size_t> m_nextTask{ 0 };
+    std::size_t m_unfinished{ 0 };
+    std::size_t m_activeWorkers{ 0 };
+    std::size_t m_generation{ 0 };
+    bool m_shuttingDown{ false };
+};
+
+#endif
@@ -0,0 +1,132 @@
+//** type-layout-report: the layouts of this repository's structs **//
+
+// Build and run:
+//     g++ -std=c++20 -O2 -pthread type-layout-report.cpp -o type-layout-report
+//     ./type-layout-report
+
+// Prints the members, padding, a smaller member order (if there is one) and the cache lines touched for the structs
+// the tools here keep many of, or pass around on hot paths, together with two examples: a struct declared in a
+// wasteful order, and a pair of counters written by different threads, with and without a cache line each.
+
+// The same facts are checked at compile time below, so a change that adds padding to one of these structs, or
+// pushes one past a cache line, doesn't build until it's fixed or the check is changed on purpose.
+
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <cstdio>
+
+#include "analysis-cache.h"
+#include "bulk-zero.h"
+#include "identifier-lexer.h"
+#include "naming-rules.h"
+#include "narrowing-convert.h"
+#include "type-layout.h"
+
+// A struct written in the order someone thought of its members.
+struct Reading
+{
+    bool valid{ };
+    double value{ };
+    char unit{ };
+    std::int64_t timestamp{ };
+    std::int16_t sensor{ };
+};
+
+// Two counters, one written by a producer thread and one by a consumer.
+struct SharedCounters
+{
+    std::atomic<std::size_t> produced{ 0 };
+    std::atomic<std::size_t> consumed{ 0 };
+};
+
+struct PaddedCounters
+{
+    alignas(cacheLineSize) std::atomic<std::size_t> produced{ 0 };
+    alignas(cacheLineSize) std::atomic<std::size_t> consumed{ 0 };
+};
+
+constexpr auto tokenLayout{ typeLayout<Token>("Token", {
+    LAYOUT_MEMBER(Token, text),
+    LAYOUT_MEMBER(Token, offset),
+    LAYOUT_MEMBER(Token, kind),
+}) };
+
+constexpr auto violationLayout{ typeLayout<NamingViolation>("NamingViolation", {
+    LAYOUT_MEMBER(NamingViolation, line),
+    LAYOUT_MEMBER(NamingViolation, column),
+    LAYOUT_MEMBER(NamingViolation, name),
+    LAYOUT_MEMBER(NamingViolation, rule),
+}) };
+
+constexpr auto cacheEntryLayout{ typeLayout<CacheEntry>("CacheEntry", {
+    LAYOUT_MEMBER(CacheEntry, pathHash),
+    LAYOUT_MEMBER(CacheEntry, contentHash),
+    LAYOUT_MEMBER(CacheEntry, stamp),
+    LAYOUT_MEMBER(CacheEntry, dataOffset),
+    LAYOUT_MEMBER(CacheEntry, pathSize),
+    LAYOUT_MEMBER(CacheEntry, analysisSize),
+}) };
+
+constexpr auto narrowingResultLayout{ typeLayout<NarrowingResult>("NarrowingResult", {
+    LAYOUT_MEMBER(NarrowingResult, count),
+    LAYOUT_MEMBER(NarrowingResult, offending),
+    LAYOUT_MEMBER(NarrowingResult, stopped),
+}) };
+
+constexpr auto bulkZeroOptionsLayout{ typeLayout<BulkZeroOptions>("BulkZeroOptions", {
+    LAYOUT_MEMBER(BulkZeroOptions, streamingThreshold),
+    LAYOUT_MEMBER(BulkZeroOptions, parallelThreshold),
+    LAYOUT_MEMBER(BulkZeroOptions, pool),
+    LAYOUT_MEMBER(BulkZeroOptions, kernel),
+}) };
+
+constexpr auto readingLayout{ typeLayout<Reading>("Reading", {
+    LAYOUT_MEMBER(Reading, valid),
+    LAYOUT_MEMBER(Reading, value),
+    LAYOUT_MEMBER(Reading, unit),
+    LAYOUT_MEMBER(Reading, timestamp),
+    LAYOUT_MEMBER(Reading, sensor),
+}) };
+
+constexpr auto sharedCountersLayout{ typeLayout<SharedCounters>("SharedCounters", {
+    LAYOUT_MEMBER(SharedCounters, produced),
+    LAYOUT_MEMBER(SharedCounters, consumed),
+}) };
+
+constexpr auto paddedCountersLayout{ typeLayout<PaddedCounters>("PaddedCounters", {
+    LAYOUT_MEMBER_ALIGNED(PaddedCounters, produced, cacheLineSize),
+    LAYOUT_MEMBER_ALIGNED(PaddedCounters, consumed, cacheLineSize),
+}) };
+
+// The repository's own structs have no padding that another order would remove.
+static_assert(tokenLayout.size == tokenLayout.compactSize());
+static_assert(violationLayout.size == violationLayout.compactSize());
+static_assert(cacheEntryLayout.size == cacheEntryLayout.compactSize() && cacheEntryLayout.padding() == 0);
+static_assert(narrowingResultLayout.size == narrowingResultLayout.compactSize());
+static_assert(bulkZeroOptionsLayout.size == bulkZeroOptionsLayout.compactSize());
+
+// Tokens are passed by value for every word lexed, and cache entries are searched through: one line each.
+static_assert(fitsInCacheLine<Token> && fitsInCacheLine<CacheEntry>);
+
+// The examples are what they claim to be.
+static_assert(readingLayout.size == 40 && readingLayout.compactSize() == 24);
+static_assert(!sharedCountersLayout.onSeparateCacheLines("produced", "consumed"));
+static_assert(paddedCountersLayout.onSeparateCacheLines("produced", "consumed"));
+
+int main()
+{
+    printTypeLayout(stdout, tokenLayout);
+    printTypeLayout(stdout, violationLayout);
+    printTypeLayout(stdout, cacheEntryLayout);
+    printTypeLayout(stdout, narrowingResultLayout);
+    printTypeLayout(stdout, bulkZeroOptionsLayout);
+    printTypeLayout(stdout, readingLayout);
+    printTypeLayout(stdout, sharedCountersLayout);
+    std::printf("    produced and consumed %s share a cache line\n",
+                sharedCountersLayout.onSeparateCacheLines("produced", "consumed") ? "never" : "can");
+    printTypeLayout(stdout, paddedCountersLayout);
+    std::printf("    produced and consumed %s share a cache line\n",
+                paddedCountersLayout.onSeparateCacheLines("produced", "consumed") ? "never" : "can");
+    return 0;
+}
@@ -0,0 +1,236 @@
+#ifndef TYPE_LAYOUT_H
+#define TYPE_LAYOUT_H
+
+//** Where a struct's bytes go: members, padding and cache lines **//
+
+// obj-var.cpp says a variable's type is fixed at compile time, and with it how much storage the variable takes.
+// For a struct that is more than the sum of its members: each member starts at a multiple of its alignment
+// (alignof), so the compiler leaves unused bytes, padding, in front of a member that would otherwise start in the
+// wrong place, and at the end so that the next element of an array starts in the right place too. A struct of a
+// bool, a double and another bool is 24 bytes (sizeof), 14 of them padding; with the bools last it is 16.
+
+// TypeLayout describes a struct at compile time, member by member. C++ can't list a struct's members by itself, so
+// they are named once, next to the struct:
+
+//     constexpr auto readingLayout{ typeLayout<Reading>("Reading", {
+//         LAYOUT_MEMBER(Reading, valid),
+//         LAYOUT_MEMBER(Reading, value),
+//         LAYOUT_MEMBER(Reading, unit),
+//     }) };
+//     static_assert(readingLayout.size == readingLayout.compactSize(), "reorder Reading: see compactOrder()");
+//     static_assert(fitsInCacheLine<Reading>);
+//     printTypeLayout(stdout, readingLayout);    // offsets, holes, a smaller order and the cache lines it can touch
+
+// From the members' offsets, sizes and alignments a layout gives:
+    // paddingBefore(i), tailPadding(), padding()    the holes, and the bytes they add up to
+    // compactOrder(), compactSize()                 an order of the members that makes the struct as small as it
+    //                                               can be, and that size: biggest alignment first
+    // onSeparateCacheLines("a", "b")                whether two members can never share a cache line, however the
+    //                                               struct is placed in memory: members written by different
+    //                                               threads should be, or each write slows the other thread down
+    //                                               (false sharing)
+// And for any type, fitsInCacheLine<T> (it is no bigger than one line) and staysInOneCacheLine<T> (its alignment
+// also keeps it from straddling two).
+
+// Every member must be listed: bytes that belong to no listed member are counted as padding. Members are found with
+// offsetof, so the struct must be standard-layout, and bit-fields can't be listed. alignof gives the alignment of a
+// member's type, not an alignas on the member itself; LAYOUT_MEMBER_ALIGNED takes that alignment explicitly.
+
+#include <array>
+#include <bit>
+#include <cstddef>
+#include <cstdio>
+#include <string_view>
+
+constexpr std::size_t cacheLineSize{ 64 };
+
+struct MemberLayout
+{
+    std::string_view name{ };
+    std::size_t offset{ };
+    std::size_t size{ };
+    std::size_t alignment{ };
+};
+
+#define LAYOUT_MEMBER(Type, member)                                                                                   \
+    MemberLayout{ #member, offsetof(Type, member), sizeof(Type::member), alignof(decltype(Type::member)) }
+
+#define LAYOUT_MEMBER_ALIGNED(Type, member, memberAlignment)                                                          \
+    MemberLayout{ #member, offsetof(Type, member), sizeof(Type::member), memberAlignment }
+
+namespace typeLayoutDetail
+{
+    constexpr std::size_t roundUp(std::size_t value, std::size_t alignment)
+    {
+        return (value + alignment - 1) / alignment * alignment;
+    }
+}
+
+template <typename T, std::size_t count>
+struct TypeLayout
+{
+    static constexpr std::size_t size{ sizeof(T) };
+    static constexpr std::size_t alignment{ alignof(T) };
+
+    std::string_view name{ };
+    std::array<MemberLayout, count> members{ }; // in order of offset
+
+    // Unused bytes between the end of the previous member (or the start) and members[index].
+    constexpr std::size_t paddingBefore(std::size_t index) const
+    {
+        const std::size_t end{ index == 0 ? 0 : members[index - 1].offset + members[index - 1].size };
+        return members[index].offset > end ? members[index].offset - end : 0;
+    }
+
+    constexpr std::size_t tailPadding() const
+    {
+        const std::size_t end{ count == 0 ? 0 : members[count - 1].offset + members[count - 1].size };
+        return size > end ? size - end : 0;
+    }
+
+    constexpr std::size_t padding() const
+    {
+        std::size_t total{ tailPadding() };
+        for (std::size_t i{ 0 }; i < count; ++i)
+            total += paddingBefore(i);
+        return total;
+    }
+
+    // Indices into members, in an order that needs the least padding: largest alignment first, and otherwise as
+    // declared. Each member's size is a multiple of its alignment, so laid out this way no member needs a hole in
+    // front of it, and only the tail padding up to alignof(T) is left.
+    constexpr std::array<std::size_t, count> compactOrder() const
+    {
+        std::array<std::size_t, count> order{ };
+        for (std::size_t i{ 0 }; i < count; ++i)
+        {
+            std::size_t position{ i };
+            for (; position > 0 && members[order[position - 1]].alignment < members[i].alignment; --position)
+                order[position] = order[position - 1];
+            order[position] = i;
+        }
+        return order;
+    }
+
+    // sizeof(T) if the members were declared in compactOrder().
+    constexpr std::size_t compactSize() const
+    {
+        std::size_t end{ 0 };
+        for (const std::size_t index : compactOrder())
+            end = typeLayoutDetail::roundUp(end, members[index].alignment) + members[index].size;
+        return typeLayoutDetail::roundUp(end, alignment);
+    }
+
+    // The member called name, or nullptr.
+    constexpr const MemberLayout* member(std::string_view memberName) const
+    {
+        for (const MemberLayout& candidate : members)
+        {
+            if (candidate.name == memberName)
+                return &candidate;
+        }
+        return nullptr;
+    }
+
+    // Whether no cache line can hold bytes of both members, wherever a T starts (at some multiple of its alignment).
+    // False if either name isn't a member.
+    constexpr bool onSeparateCacheLines(std::string_view first, std::string_view second) const
+    {
+        const MemberLayout* const a{ member(first) };
+        const MemberLayout* const b{ member(second) };
+        if (!a || !b)
+            return false;
+        const std::size_t step{ alignment < cacheLineSize ? alignment : cacheLineSize };
+        for (std::size_t start{ 0 }; start < cacheLineSize; start += step)
+        {
+            const std::size_t aFirst{ (start + a->offset) / cacheLineSize };
+            const std::size_t aLast{ (start + a->offset + a->size - 1) / cacheLineSize };
+            const std::size_t bFirst{ (start + b->offset) / cacheLineSize };
+            const std::size_t bLast{ (start + b->offset + b->size - 1) / cacheLineSize };
+            if (aFirst <= bLast && bFirst <= aLast)
+                return false;
+        }
+        return true;
+    }
+};
+
+// The layout of T from its members, listed in any order.
+template <typename T, std::size_t count>
+constexpr TypeLayout<T, count> typeLayout(std::string_view name, const MemberLayout (&members)[count])
+{
+    TypeLayout<T, count> layout{ name, { } };
+    for (std::size_t i{ 0 }; i < count; ++i)
+    {
+        std::size_t position{ i };
+        for (; position > 0 && layout.members[position - 1].offset > members[i].offset; --position)
+            layout.members[position] = layout.members[position - 1];
+        layout.members[position] = members[i];
+    }
+    return layout;
+}
+
+// Whether a T is no bigger than a cache line.
+template <typename T>
+constexpr bool fitsInCacheLine{ sizeof(T) <= cacheLineSize };
+
+// Whether every T is inside a single cache line. One that fits can still start near the end of a line and spill
+// into the next, unless its alignment rules that out: only when sizeof(T) is no more than alignof(T) can't it.
+template <typename T>
+constexpr bool staysInOneCacheLine{ sizeof(T) <= cacheLineSize && sizeof(T) <= alignof(T) };
+
+// A table of the members and holes of a layout, the order compactOrder() suggests if it saves anything, and how many
+// cache lines a T can touch.
+template <typename T, std::size_t count>
+void printTypeLayout(std::FILE* out, const TypeLayout<T, count>& layout)
+{
+    const std::size_t padding{ layout.padding() };
+    std::fprintf(out, "%.*s: %zu bytes, aligned to %zu, %zu bytes of padding (%.0f%%)\n",
+                 static_cast<int>(layout.name.size()), layout.name.data(), layout.size, layout.alignment, padding,
+                 100.0 * static_cast<double>(padding) / static_cast<double>(layout.size));
+    std::fprintf(out, "    %6s %6s %6s  %s\n", "offset", "size", "align", "member");
+    for (std::size_t i{ 0 }; i < count; ++i)
+    {
+        const MemberLayout& member{ layout.members[i] };
+        if (const std::size_t hole{ layout.paddingBefore(i) })
+            std::fprintf(out, "    %6zu %6zu %6s  (padding)\n", member.offset - hole, hole, "");
+        std::fprintf(out, "    %6zu %6zu %6zu  %.*s\n", member.offset, member.size, member.alignment,
+                     static_cast<int>(member.name.size()), member.name.data());
+    }
+    if (const std::size_t tail{ layout.tailPadding() })
+        std::fprintf(out, "    %6zu %6zu %6s  (tail padding)\n", layout.size - tail, tail, "");
+
+    const std::size_t compactSize{ layout.compactSize() };
+    if (compactSize < layout.size)
+    {
+        std::fprintf(out, "    reordered as");
+        const char* separator{ " " };
+        for (const std::size_t index : layout.compactOrder())
+        {
+            const std::string_view name{ layout.members[index].name };
+            std::fprintf(out, "%s%.*s", separator, static_cast<int>(name.size()), name.data());
+            separator = ", ";
+        }
+        std::fprintf(out, ": %zu bytes, %zu fewer\n", compactSize, layout.size - compactSize);
+    }
+    else
+    {
+        std::fprintf(out, "    no order of the members is smaller\n");
+    }
+
+    // The most lines a T can touch, over every start it can have within a line.
+    std::size_t mostLines{ 0 };
+    const std::size_t step{ layout.alignment < cacheLineSize ? layout.alignment : cacheLineSize };
+    for (std::size_t start{ 0 }; start < cacheLineSize; start += step)
+    {
+        const std::size_t lines{ (start + layout.size - 1) / cacheLineSize + 1 };
+        mostLines = lines > mostLines ? lines : mostLines;
+    }
+    const std::size_t fewestLines{ (layout.size + cacheLineSize - 1) / cacheLineSize };
+    if (mostLines == fewestLines)
+        std::fprintf(out, "    always touches %zu cache line%s\n", mostLines, mostLines == 1 ? "" : "s");
+    else
+        std::fprintf(out, "    touches up to %zu cache lines; alignas(%zu) would make that %zu\n", mostLines,
+                     fewestLines == 1 ? std::bit_ceil(layout.size) : cacheLineSize, fewestLines);
+}
+
+#endif
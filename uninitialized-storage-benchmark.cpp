@@ -0,0 +1,81 @@
+//** Benchmark: loading values into std::vector vs UninitializedVector **//
+
+// Build and run (NDEBUG matters: without it UninitializedVector does its debug pattern fill):
+//     g++ -std=c++20 -O2 -DNDEBUG uninitialized-storage-benchmark.cpp -o uninitialized-storage-benchmark
+//     ./uninitialized-storage-benchmark [largest size, default 1e8] [repetitions, default 5]
+
+// For each size from 1e5 up to the largest (1e9 ints needs 4 GB of memory), this times three ways of creating a
+// vector of that many ints and then loading a value into every element:
+    // std::vector<int>(n)        value-initializes (zero fills) first, then the load overwrites everything
+    // reserve(n) + push_back     no zero fill, but a capacity check on every element
+    // UninitializedVector<int>(n) no zero fill, and the load is a plain loop over the array
+
+#include <algorithm>
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <vector>
+
+#include "uninitialized-storage.h"
+
+// Stands in for parsing: cheap enough that the cost of the zero fill is visible.
+inline int loadedValue(std::size_t index) { return static_cast<int>(index * 2654435761u); }
+
+volatile int benchmarkSink{ };
+
+template <typename Run>
+double bestOf(int repetitions, Run&& run)
+{
+    double best{ 1e30 };
+    for (int i{ 0 }; i < repetitions; ++i)
+    {
+        const auto start{ std::chrono::steady_clock::now() };
+        run();
+        const std::chrono::duration<double> elapsed{ std::chrono::steady_clock::now() - start };
+        best = std::min(best, elapsed.count());
+    }
+    return best;
+}
+
+int main(int argc, char* argv[])
+{
+    const double largest{ argc > 1 ? std::atof(argv[1]) : 1e8 };
+    const int repetitions{ argc > 2 ? std::atoi(argv[2]) : 5 };
+
+#ifndef NDEBUG
+    std::printf("note: NDEBUG is not defined, so UninitializedVector pattern-fills (debug behaviour)\n");
+#endif
+    std::printf("%12s %14s %14s %14s %9s\n", "elements", "vector(n) ms", "push_back ms", "uninit ms", "speedup");
+
+    for (double size{ 1e5 }; size <= largest * 1.0001; size *= 10)
+    {
+        const std::size_t count{ static_cast<std::size_t>(size) };
+
+        const double zeroFilled{ bestOf(repetitions, [&] {
+            std::vector<int> values(count);
+            for (std::size_t i{ 0 }; i < count; ++i)
+                values[i] = loadedValue(i);
+            benchmarkSink = values[count / 2];
+        }) };
+
+        const double pushedBack{ bestOf(repetitions, [&] {
+            std::vector<int> values{ };
+            values.reserve(count);
+            for (std::size_t i{ 0 }; i < count; ++i)
+                values.push_back(loadedValue(i));
+            benchmarkSink = values[count / 2];
+        }) };
+
+        const double uninitialized{ bestOf(repetitions, [&] {
+            UninitializedVector<int> values(count);
+            for (std::size_t i{ 0 }; i < count; ++i)
+                values[i] = loadedValue(i);
+            assertWritten(values.data(), values.data() + values.size());
+            benchmarkSink = values[count / 2];
+        }) };
+
+        std::printf("%12zu %14.3f %14.3f %14.3f %8.2fx\n", count, zeroFilled * 1e3, pushedBack * 1e3,
+                    uninitialized * 1e3, zeroFilled / uninitialized);
+    }
+    return 0;
+}
@@ -0,0 +1,105 @@
+#ifndef UNINITIALIZED_STORAGE_H
+#define UNINITIALIZED_STORAGE_H
+
+//** Vectors that skip initializing values you're about to overwrite **//
+
+// uninitialized-undefined.cpp explains that C++ doesn't initialize int x; because initializing 100,000 values that
+// are about to be read from a file would be wasted work. std::vector doesn't get that benefit: std::vector<int>(n)
+// and resize(n) value-initialize, so every new element is set to 0 first, and then overwritten by the load.
+
+// DefaultInitAllocator changes that. A vector that uses it default-initializes new elements instead, which for int
+// and double (and other types without a constructor) means leaving them alone, exactly like int x;
+
+//     UninitializedVector<int> values(count); // no zero fill
+//     loadValuesInto(values.data(), count);   // every element is written before it is read
+
+// Types with a default constructor still get it run, and elements constructed from a value (push_back(5),
+// resize(n, 5)) are unaffected.
+
+// Reading an element before writing it is undefined behaviour, just like reading an uninitialized int. To help
+// catch that, debug builds (NDEBUG not defined) fill new elements with the byte 0xCC, the same pattern Visual
+// Studio's debug builds use for uninitialized stack memory (an int filled with it reads as -858993460). Release
+// builds skip the fill entirely. assertWritten() checks a range for elements that still hold the pattern; it
+// compiles to nothing in release builds. (Memory Sanitizer, -fsanitize=memory with clang, catches the reads
+// themselves, and works best in a release-style build where the fill doesn't hide them.)
+
+#include <cassert>
+#include <cstddef>
+#include <cstring>
+#include <memory>
+#include <new>
+#include <type_traits>
+#include <utility>
+#include <vector>
+
+constexpr unsigned char uninitializedPattern{ 0xCC };
+
+template <typename T, typename Base = std::allocator<T>>
+class DefaultInitAllocator : public Base
+{
+    using Traits = std::allocator_traits<Base>;
+
+public:
+    template <typename U>
+    struct rebind
+    {
+        using other = DefaultInitAllocator<U, typename Traits::template rebind_alloc<U>>;
+    };
+
+    using Base::Base;
+
+    DefaultInitAllocator() = default;
+
+    template <typename U, typename OtherBase>
+    DefaultInitAllocator(const DefaultInitAllocator<U, OtherBase>& other) noexcept
+        : Base{ static_cast<const OtherBase&>(other) }
+    {
+    }
+
+    // Called for elements created without a value (vector(n), resize(n)): default-initialize.
+    template <typename U>
+    void construct(U* pointer) noexcept(std::is_nothrow_default_constructible_v<U>)
+    {
+#ifndef NDEBUG
+        if constexpr (std::is_trivially_default_constructible_v<U>)
+            std::memset(static_cast<void*>(pointer), uninitializedPattern, sizeof(U));
+#endif
+        ::new (static_cast<void*>(pointer)) U;
+    }
+
+    // Anything constructed from arguments is handled as usual.
+    template <typename U, typename... Args>
+    void construct(U* pointer, Args&&... args)
+    {
+        Traits::construct(static_cast<Base&>(*this), pointer, std::forward<Args>(args)...);
+    }
+};
+
+template <typename T>
+using UninitializedVector = std::vector<T, DefaultInitAllocator<T>>;
+
+// Debug builds only: the first element in [first, last) whose bytes are all still the fill pattern, or last if
+// there is none. A real value that happens to be all 0xCC bytes is reported too, so treat a hit as a strong hint.
+template <typename T>
+const T* findUnwritten(const T* first, const T* last)
+{
+    static_assert(std::is_trivially_copyable_v<T>, "the fill pattern is only meaningful for plain data");
+    unsigned char pattern[sizeof(T)];
+    std::memset(pattern, uninitializedPattern, sizeof(T));
+    for (; first != last; ++first)
+    {
+        if (std::memcmp(first, pattern, sizeof(T)) == 0)
+            return first;
+    }
+    return last;
+}
+
+template <typename T>
+void assertWritten([[maybe_unused]] const T* first, [[maybe_unused]] const T* last)
+{
+#ifndef NDEBUG
+    assert(findUnwritten(first, last) == last && "element read before it was written");
+#endif
+}
+
+#endif
@@ -0,0 +1,214 @@
+//** Benchmark: std::map of std::variant vs VariableStore **//
+
+// Build and run:
+//     g++ -std=c++20 -O2 variable-store-benchmark.cpp -o variable-store-benchmark
+//     ./variable-store-benchmark [millions of variables, default 1] [repetitions, default 5]
+
+// Half the variables are ints and half are doubles, named "v0", "v1", ... in a shuffled order, and they are kept
+// two ways:
+    // map    std::map<std::string, std::variant<int, double>>, what a program that makes variables at run time
+    //        often uses
+    // store  VariableStore<int, double>
+// Each is timed defining every variable, looking every name up, reading and writing each variable through what the
+// lookup gave (an iterator, a Variable<T>), summing all the doubles and all the ints, and scaling all the doubles.
+// The sums must agree before anything is reported.
+
+#include <algorithm>
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <map>
+#include <numeric>
+#include <random>
+#include <string>
+#include <variant>
+#include <vector>
+
+#include "variable-store.h"
+
+volatile double benchmarkSink{ };
+
+template <typename Run>
+double bestOf(int repetitions, Run&& run)
+{
+    double best{ 1e30 };
+    for (int i{ 0 }; i < repetitions; ++i)
+    {
+        const auto start{ std::chrono::steady_clock::now() };
+        run();
+        const std::chrono::duration<double> elapsed{ std::chrono::steady_clock::now() - start };
+        best = std::min(best, elapsed.count());
+    }
+    return best;
+}
+
+using VariantMap = std::map<std::string, std::variant<int, double>>;
+using Store = VariableStore<int, double>;
+
+// Even-numbered variables are ints, odd-numbered ones doubles.
+int intValue(std::size_t i) { return static_cast<int>(i % 1000); }
+double doubleValue(std::size_t i) { return static_cast<double>(i % 1000) * 0.25; }
+
+void report(const char* name, double mapSeconds, double storeSeconds, std::size_t count)
+{
+    std::printf("%-8s map %9.2f ms %7.1f ns/variable   store %9.2f ms %7.1f ns/variable   %6.1fx\n", name,
+                mapSeconds * 1e3, mapSeconds * 1e9 / count, storeSeconds * 1e3, storeSeconds * 1e9 / count,
+                mapSeconds / storeSeconds);
+}
+
+int main(int argc, char* argv[])
+{
+    const std::size_t count{ static_cast<std::size_t>((argc > 1 ? std::atof(argv[1]) : 1) * 1e6) };
+    const int repetitions{ argc > 2 ? std::atoi(argv[2]) : 5 };
+
+    std::vector<std::size_t> order(count);
+    std::iota(order.begin(), order.end(), 0);
+    std::shuffle(order.begin(), order.end(), std::mt19937_64{ 12345 });
+    std::vector<std::string> names(count);
+    for (std::size_t i{ 0 }; i < count; ++i)
+        names[i] = "v" + std::to_string(i);
+
+    // Defining: each repetition starts from an empty container, and the last one is kept.
+    VariantMap map{ };
+    const double mapDefine{ bestOf(repetitions, [&] {
+        map = VariantMap{ };
+        for (const std::size_t i : order)
+        {
+            if (i % 2 == 0)
+                map.try_emplace(names[i], intValue(i));
+            else
+                map.try_emplace(names[i], doubleValue(i));
+        }
+    }) };
+    Store* store{ };
+    const double storeDefine{ bestOf(repetitions, [&] {
+        delete store;
+        store = new Store{ };
+        for (const std::size_t i : order)
+        {
+            if (i % 2 == 0)
+                store->define<int>(names[i], intValue(i));
+            else
+                store->define<double>(names[i], doubleValue(i));
+        }
+    }) };
+    if (map.size() != count || store->size() != count)
+    {
+        std::printf("MISMATCH: %zu and %zu variables defined, expected %zu\n", map.size(), store->size(), count);
+        return 1;
+    }
+
+    // Looking up every name, in the shuffled order, and keeping what the lookup gave.
+    std::vector<VariantMap::iterator> mapHandles(count);
+    std::vector<Variable<double>> doubleHandles(count / 2);
+    std::vector<Variable<int>> intHandles(count - count / 2);
+    const double mapLookup{ bestOf(repetitions, [&] {
+        for (const std::size_t i : order)
+            mapHandles[i] = map.find(names[i]);
+    }) };
+    const double storeLookup{ bestOf(repetitions, [&] {
+        for (const std::size_t i : order)
+        {
+            if (i % 2 == 0)
+                intHandles[i / 2] = *store->find<int>(names[i]);
+            else
+                doubleHandles[i / 2] = *store->find<double>(names[i]);
+        }
+    }) };
+    report("lookup", mapLookup, storeLookup, count);
+
+    // Reading and writing each variable through its handle.
+    const double mapAccess{ bestOf(repetitions, [&] {
+        for (const std::size_t i : order)
+        {
+            if (double* value{ std::get_if<double>(&mapHandles[i]->second) })
+                *value += 1;
+        }
+        for (const std::size_t i : order)
+        {
+            if (double* value{ std::get_if<double>(&mapHandles[i]->second) })
+                *value -= 1;
+        }
+    }) };
+    const double storeAccess{ bestOf(repetitions, [&] {
+        for (const std::size_t i : order)
+        {
+            if (i % 2 != 0)
+                (*store)[doubleHandles[i / 2]] += 1;
+        }
+        for (const std::size_t i : order)
+        {
+            if (i % 2 != 0)
+                (*store)[doubleHandles[i / 2]] -= 1;
+        }
+    }) };
+    report("access", mapAccess / 2, storeAccess / 2, count);
+
+    // Whole-column sums. Both sums are exact (multiples of 0.25 well below 2^53), so the order doesn't matter.
+    double expectedDoubles{ 0 };
+    long long expectedInts{ 0 };
+    for (std::size_t i{ 0 }; i < count; ++i)
+    {
+        if (i % 2 == 0)
+            expectedInts += intValue(i);
+        else
+            expectedDoubles += doubleValue(i);
+    }
+    double mapDoubles{ 0 };
+    long long mapInts{ 0 };
+    const double mapSum{ bestOf(repetitions, [&] {
+        mapDoubles = 0;
+        mapInts = 0;
+        for (const auto& [name, value] : map)
+        {
+            if (const double* number{ std::get_if<double>(&value) })
+                mapDoubles += *number;
+            else
+                mapInts += std::get<int>(value);
+        }
+        benchmarkSink = mapDoubles;
+    }) };
+    double storeDoubles{ 0 };
+    long long storeInts{ 0 };
+    const double storeSum{ bestOf(repetitions, [&] {
+        storeDoubles = columnSum(store->column<double>());
+        storeInts = columnSum(store->column<int>());
+        benchmarkSink = storeDoubles;
+    }) };
+    if (mapDoubles != expectedDoubles || storeDoubles != expectedDoubles || mapInts != expectedInts
+        || storeInts != expectedInts)
+    {
+        std::printf("MISMATCH: sums of doubles %.17g %.17g %.17g, of ints %lld %lld %lld\n", expectedDoubles,
+                    mapDoubles, storeDoubles, expectedInts, mapInts, storeInts);
+        return 1;
+    }
+    report("sum", mapSum, storeSum, count);
+
+    // Scaling every double, by 2 and back by 0.5 so the values stay as they were.
+    const double mapScale{ bestOf(repetitions, [&] {
+        for (const double factor : { 2.0, 0.5 })
+        {
+            for (auto& [name, value] : map)
+            {
+                if (double* number{ std::get_if<double>(&value) })
+                    *number *= factor;
+            }
+        }
+        benchmarkSink = std::get<double>(mapHandles[1]->second);
+    }) };
+    const double storeScale{ bestOf(repetitions, [&] {
+        for (const double factor : { 2.0, 0.5 })
+            scaleColumn(store->column<double>(), factor);
+        benchmarkSink = store->column<double>()[0];
+    }) };
+    if (columnSum(store->column<double>()) != expectedDoubles)
+    {
+        std::printf("MISMATCH: scaling changed the doubles\n");
+        return 1;
+    }
+    report("scale", mapScale / 2, storeScale / 2, count);
+    report("define", mapDefine, storeDefine, count);
+    std::printf("%zu variables; sums agree: %.17g and %lld\n", count, expectedDoubles, expectedInts);
+    delete store;
+    return 0;
+}
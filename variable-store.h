@@ -0,0 +1,247 @@
+#ifndef VARIABLE_STORE_H
+#define VARIABLE_STORE_H
+
+//** Named variables at run time, one column per type **//
+
+// obj-var.cpp describes memory as numbered mailboxes, and a variable as a named mailbox of a given type (int x;,
+// double width;). A program that creates variables while it runs often models that as
+// std::map<std::string, std::variant<int, double>>: every value is a separate tree node, every access compares
+// strings, and adding up all the doubles means visiting every node and checking its type.
+
+// VariableStore keeps each type's values in their own contiguous column instead (a "structure of arrays"), and turns
+// a name into a small typed handle once, when the variable is defined or first looked up:
+
+//     VariableStore<int, double> store{ };
+//     const Variable<double> width{ *store.define<double>("width", 2.5) };   // nullopt if "width" already exists
+//     store[width] *= 2;                                                    // an index into the double column
+//     const double total{ columnSum(store.column<double>()) };              // every double, in one tight loop
+//     scaleColumn(store.column<double>(), 0.5);
+
+// A Variable<T> is a 4-byte index into T's column, so using one is an array access with no name lookup and no type
+// check. Whole-column operations run over a plain array of T, which the compiler vectorizes. Names are interned in a
+// SymbolTable (symbol-table.h), so each is stored once.
+
+// Variables are never removed, so a handle stays valid for as long as the store exists. Pointers and references to
+// values don't: a column moves when it grows, like a std::vector. A store is not thread-safe while variables are
+// being defined; once they are, any number of threads may read it, and write values in different variables.
+
+#include <cstddef>
+#include <cstdint>
+#include <optional>
+#include <span>
+#include <string_view>
+#include <tuple>
+#include <type_traits>
+#include <unordered_map>
+#include <utility>
+#include <vector>
+
+#include "symbol-table.h"
+
+template <typename T>
+struct Variable
+{
+    std::uint32_t index{ };
+
+    friend bool operator==(Variable, Variable) = default;
+};
+
+namespace variableStoreDetail
+{
+    template <typename T, typename... Types>
+    constexpr std::size_t typeIndex()
+    {
+        constexpr bool matches[]{ std::is_same_v<T, Types>... };
+        for (std::size_t i{ 0 }; i < sizeof...(Types); ++i)
+        {
+            if (matches[i])
+                return i;
+        }
+        return sizeof...(Types);
+    }
+
+    // Whether each type's first position in the list is its own, i.e. no type is listed twice.
+    template <typename... Types, std::size_t... index>
+    constexpr bool allDistinct(std::index_sequence<index...>)
+    {
+        return ((typeIndex<Types, Types...>() == index) && ...);
+    }
+}
+
+template <typename... Types>
+class VariableStore
+{
+    static_assert(sizeof...(Types) > 0, "a VariableStore needs at least one type");
+    static_assert(variableStoreDetail::allDistinct<Types...>(std::index_sequence_for<Types...>{ }),
+                  "each type may only be listed once");
+
+    template <typename T>
+    static constexpr std::size_t typeIndex{ variableStoreDetail::typeIndex<T, Types...>() };
+
+    template <typename T>
+    static constexpr bool isStored{ typeIndex<T> < sizeof...(Types) };
+
+public:
+    VariableStore() = default;
+    VariableStore(const VariableStore&) = delete;
+    VariableStore& operator=(const VariableStore&) = delete;
+
+    // Define a new variable of type T. Returns nullopt if a variable with this name already exists (of any type),
+    // just as defining the same name twice doesn't compile.
+    template <typename T>
+    std::optional<Variable<T>> define(std::string_view name, T value = T{ })
+    {
+        static_assert(isStored<T>, "T isn't one of this store's types");
+        const Symbol symbol{ m_symbols.intern(name) };
+        std::vector<T>& values{ std::get<typeIndex<T>>(m_columns) };
+        const auto [slot, added]{ m_slots.try_emplace(
+            symbol, Slot{ static_cast<std::uint32_t>(typeIndex<T>), static_cast<std::uint32_t>(values.size()) }) };
+        if (!added)
+            return std::nullopt;
+
+        try
+        {
+            values.push_back(std::move(value));
+            m_names[typeIndex<T>].push_back(symbol);
+        }
+        catch (...)
+        {
+            // Leave the store as it was, rather than with a name whose slot points past the end of its column.
+            if (values.size() > slot->second.index)
+                values.pop_back();
+            m_slots.erase(slot);
+            throw;
+        }
+        return Variable<T>{ slot->second.index };
+    }
+
+    // The variable called name, if there is one and it has type T.
+    template <typename T>
+    std::optional<Variable<T>> find(std::string_view name) const
+    {
+        static_assert(isStored<T>, "T isn't one of this store's types");
+        const std::optional<Symbol> symbol{ m_symbols.find(name) };
+        if (!symbol)
+            return std::nullopt;
+        const auto slot{ m_slots.find(*symbol) };
+        if (slot == m_slots.end() || slot->second.type != typeIndex<T>)
+            return std::nullopt;
+        return Variable<T>{ slot->second.index };
+    }
+
+    template <typename T>
+    T& operator[](Variable<T> variable)
+    {
+        return std::get<typeIndex<T>>(m_columns)[variable.index];
+    }
+
+    template <typename T>
+    const T& operator[](Variable<T> variable) const
+    {
+        return std::get<typeIndex<T>>(m_columns)[variable.index];
+    }
+
+    template <typename T>
+    std::string_view name(Variable<T> variable) const
+    {
+        return m_symbols.text(m_names[typeIndex<T>][variable.index]);
+    }
+
+    // Every value of type T, in the order the variables were defined: Variable<T>{ i } is column<T>()[i].
+    template <typename T>
+    std::span<T> column()
+    {
+        static_assert(isStored<T>, "T isn't one of this store's types");
+        return std::get<typeIndex<T>>(m_columns);
+    }
+
+    template <typename T>
+    std::span<const T> column() const
+    {
+        static_assert(isStored<T>, "T isn't one of this store's types");
+        return std::get<typeIndex<T>>(m_columns);
+    }
+
+    // Make room for count variables of type T in all, so defining them doesn't move the column again.
+    template <typename T>
+    void reserve(std::size_t count)
+    {
+        std::get<typeIndex<T>>(m_columns).reserve(count);
+        m_names[typeIndex<T>].reserve(count);
+        m_slots.reserve(m_slots.size() + count);
+    }
+
+    // The number of variables, in all columns.
+    std::size_t size() const { return m_slots.size(); }
+
+private:
+    struct Slot
+    {
+        std::uint32_t type{ };
+        std::uint32_t index{ };
+    };
+
+    SymbolTable m_symbols{ };
+    std::unordered_map<Symbol, Slot> m_slots{ };
+    std::tuple<std::vector<Types>...> m_columns{ };
+    std::vector<Symbol> m_names[sizeof...(Types)]{ };
+};
+
+// The sum of a column. Integers are added up in 64 bits, so a column of ints can't overflow. The values are added
+// in eight interleaved running sums (combined at the end), which the compiler keeps in SIMD registers even at -O2,
+// where it won't vectorize a loop of unknown length; and a single floating-point running sum can't be vectorized
+// without changing its result, so it wouldn't at all. A floating-point result can differ from adding the values in
+// order by rounding, but it's the same every time.
+template <typename T>
+auto columnSum(std::span<const T> values)
+{
+    if constexpr (std::is_floating_point_v<T>)
+    {
+        T sums[8]{ };
+        std::size_t i{ 0 };
+        for (; i + 8 <= values.size(); i += 8)
+        {
+            for (std::size_t lane{ 0 }; lane < 8; ++lane)
+                sums[lane] += values[i + lane];
+        }
+        for (; i < values.size(); ++i)
+            sums[i % 8] += values[i];
+        return ((sums[0] + sums[4]) + (sums[1] + sums[5])) + ((sums[2] + sums[6]) + (sums[3] + sums[7]));
+    }
+    else
+    {
+        using Sum = std::conditional_t<std::is_signed_v<T>, std::int64_t, std::uint64_t>;
+        Sum sums[8]{ };
+        std::size_t i{ 0 };
+        for (; i + 8 <= values.size(); i += 8)
+        {
+            for (std::size_t lane{ 0 }; lane < 8; ++lane)
+                sums[lane] += static_cast<Sum>(values[i + lane]);
+        }
+        for (; i < values.size(); ++i)
+            sums[0] += static_cast<Sum>(values[i]);
+        return ((sums[0] + sums[4]) + (sums[1] + sums[5])) + ((sums[2] + sums[6]) + (sums[3] + sums[7]));
+    }
+}
+
+template <typename T>
+auto columnSum(std::span<T> values)
+{
+    return columnSum(std::span<const T>{ values });
+}
+
+// Multiply every value in a column by factor, eight at a time for the same reason.
+template <typename T>
+void scaleColumn(std::span<T> values, T factor)
+{
+    std::size_t i{ 0 };
+    for (; i + 8 <= values.size(); i += 8)
+    {
+        for (std::size_t lane{ 0 }; lane < 8; ++lane)
+            values[i + lane] *= factor;
+    }
+    for (; i < values.size(); ++i)
+        values[i] *= factor;
+}
+
+#endif
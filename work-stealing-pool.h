@@ -0,0 +1,214 @@
+#ifndef WORK_STEALING_POOL_H
+#define WORK_STEALING_POOL_H
+
+//** A thread pool for work that creates more work **//
+
+// ThreadPool (thread-pool.h) runs a number of tasks known in advance. Some work only discovers its tasks as it goes:
+// walking a directory tree finds subdirectories, and each of those has to be walked too. WorkStealingPool lets a
+// running task submit new tasks:
+
+//     WorkStealingPool pool{ };
+//     pool.submit([&](std::size_t worker) { walk(root); });   // walk() calls pool.submit() for each subdirectory
+//     pool.wait();                                             // returns once every task, old and new, has finished
+
+// Each thread has its own queue of tasks. A task submitted from inside a task goes on the submitting thread's own
+// queue, and a thread takes its newest task first, so related work tends to stay on one thread while its data is
+// still in cache. A thread whose queue is empty steals the oldest task from another thread's queue. Oldest tasks are
+// usually the biggest (a directory near the root of the tree), so one steal moves a lot of work. Since threads
+// mostly touch only their own queue, a plain mutex per queue is rarely contended.
+
+// Tasks are given the index of the thread running them (0 to threadCount() - 1), so results can be collected in
+// per-thread storage without any locking. The thread that calls wait() works on tasks as thread 0.
+
+#include <algorithm>
+#include <atomic>
+#include <condition_variable>
+#include <cstddef>
+#include <deque>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <utility>
+#include <vector>
+
+class WorkStealingPool
+{
+public:
+    using Task = std::function<void(std::size_t worker)>;
+
+    // threadCount includes the thread that calls wait(); 0 means one per hardware thread.
+    explicit WorkStealingPool(std::size_t threadCount = 0)
+    {
+        if (threadCount == 0)
+            threadCount = std::max(1u, std::thread::hardware_concurrency());
+
+        for (std::size_t i{ 0 }; i < threadCount; ++i)
+            m_queues.push_back(std::make_unique<Queue>());
+        for (std::size_t i{ 1 }; i < threadCount; ++i)
+            m_workers.emplace_back([this, i] { workerLoop(i); });
+    }
+
+    WorkStealingPool(const WorkStealingPool&) = delete;
+    WorkStealingPool& operator=(const WorkStealingPool&) = delete;
+
+    ~WorkStealingPool()
+    {
+        {
+            std::lock_guard lock{ m_mutex };
+            m_shuttingDown = true;
+        }
+        m_wake.notify_all();
+        for (std::thread& worker : m_workers)
+            worker.join();
+    }
+
+    std::size_t threadCount() const { return m_queues.size(); }
+
+    // Queue a task. From inside a task it goes on this thread's own queue; otherwise queues are taken in turn.
+    void submit(Task task)
+    {
+        const std::size_t queue{ currentPool() == this ? currentWorker()
+                                                        : m_nextQueue.fetch_add(1, std::memory_order_relaxed)
+                                                              % m_queues.size() };
+        m_pending.fetch_add(1);
+        m_queued.fetch_add(1); // before the push, so a thread taking the task never sees the count go below zero
+        {
+            std::lock_guard lock{ m_queues[queue]->mutex };
+            m_queues[queue]->tasks.push_back(std::move(task));
+        }
+
+        // A sleeping thread either sees m_queued above, or is counted in m_sleeping and gets woken here.
+        if (m_sleeping.load() > 0)
+        {
+            { std::lock_guard lock{ m_mutex }; }
+            m_wake.notify_one();
+        }
+    }
+
+    // Work on tasks until every submitted task (including those submitted by tasks) has finished.
+    void wait()
+    {
+        const Scope scope{ this, 0 };
+        while (m_pending.load() != 0)
+        {
+            if (!runOne(0))
+                sleep([this] { return m_pending.load() == 0; });
+        }
+    }
+
+private:
+    struct Queue
+    {
+        std::mutex mutex{ };
+        std::deque<Task> tasks{ };
+    };
+
+    // Which pool and worker the current thread belongs to, for submit() from inside a task.
+    static WorkStealingPool*& currentPool()
+    {
+        thread_local WorkStealingPool* pool{ nullptr };
+        return pool;
+    }
+
+    static std::size_t& currentWorker()
+    {
+        thread_local std::size_t worker{ 0 };
+        return worker;
+    }
+
+    struct Scope
+    {
+        Scope(WorkStealingPool* pool, std::size_t worker)
+            : previousPool{ currentPool() }
+            , previousWorker{ currentWorker() }
+        {
+            currentPool() = pool;
+            currentWorker() = worker;
+        }
+
+        ~Scope()
+        {
+            currentPool() = previousPool;
+            currentWorker() = previousWorker;
+        }
+
+        WorkStealingPool* previousPool{ };
+        std::size_t previousWorker{ };
+    };
+
+    // Take the newest task from our own queue, or steal the oldest from another's; run it. False if none was found.
+    bool runOne(std::size_t worker)
+    {
+        Task task{ };
+        {
+            Queue& own{ *m_queues[worker] };
+            std::lock_guard lock{ own.mutex };
+            if (!own.tasks.empty())
+            {
+                task = std::move(own.tasks.back());
+                own.tasks.pop_back();
+            }
+        }
+
+        for (std::size_t i{ 1 }; !task && i < m_queues.size(); ++i)
+        {
+            Queue& victim{ *m_queues[(worker + i) % m_queues.size()] };
+            std::lock_guard lock{ victim.mutex };
+            if (!victim.tasks.empty())
+            {
+                task = std::move(victim.tasks.front());
+                victim.tasks.pop_front();
+            }
+        }
+
+        if (!task)
+            return false;
+
+        m_queued.fetch_sub(1);
+        task(worker);
+        if (m_pending.fetch_sub(1) == 1)
+        {
+            // That was the last task: wake the thread in wait().
+            { std::lock_guard lock{ m_mutex }; }
+            m_wake.notify_all();
+        }
+        return true;
+    }
+
+    // Sleep until a task is queued, or until done() is true. Returns whether the pool is shutting down.
+    template <typename Done>
+    bool sleep(Done&& done)
+    {
+        std::unique_lock lock{ m_mutex };
+        m_sleeping.fetch_add(1);
+        m_wake.wait(lock, [&] { return m_shuttingDown || m_queued.load() > 0 || done(); });
+        m_sleeping.fetch_sub(1);
+        return m_shuttingDown;
+    }
+
+    void workerLoop(std::size_t worker)
+    {
+        const Scope scope{ this, worker };
+        for (;;)
+        {
+            if (runOne(worker))
+                continue;
+            if (sleep([] { return false; }) && m_queued.load() == 0)
+                return;
+        }
+    }
+
+    std::vector<std::unique_ptr<Queue>> m_queues{ }; // one per thread; m_queues[0] belongs to the thread in wait()
+    std::vector<std::thread> m_workers{ };
+    std::atomic<std::size_t> m_nextQueue{ 0 };
+    std::atomic<std::size_t> m_pending{ 0 };  // submitted and not yet finished
+    std::atomic<std::size_t> m_queued{ 0 };   // submitted and not yet taken by a thread
+    std::atomic<std::size_t> m_sleeping{ 0 };
+
+    std::mutex m_mutex{ }; // only for sleeping and waking
+    std::condition_variable m_wake{ };
+    bool m_shuttingDown{ false };
+};
+
+#endif
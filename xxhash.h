@@ -0,0 +1,113 @@
+#ifndef XXHASH_H
+#define XXHASH_H
+
+//** A fast 64-bit hash of a block of bytes **//
+
+// xxHash64() computes XXH64 (the 64-bit xxHash by Yann Collet), a non-cryptographic hash that runs at several GB/s,
+// so hashing a file costs far less than reading it. It's for telling whether data has changed, not for security:
+// anyone can make two inputs with the same hash on purpose.
+
+//     const std::uint64_t hash{ xxHash64(text.data(), text.size()) };
+
+// The result matches the reference implementation (XXH64 with the same seed), so hashes can be checked with the
+// xxhsum tool.
+
+#include <bit>
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+
+namespace xxHashDetail
+{
+    constexpr std::uint64_t prime1{ 0x9E3779B185EBCA87ull };
+    constexpr std::uint64_t prime2{ 0xC2B2AE3D27D4EB4Full };
+    constexpr std::uint64_t prime3{ 0x165667B19E3779F9ull };
+    constexpr std::uint64_t prime4{ 0x85EBCA77C2B2AE63ull };
+    constexpr std::uint64_t prime5{ 0x27D4EB2F165667C5ull };
+
+    // Little-endian loads, as the reference implementation does on every machine.
+    inline std::uint64_t read64(const unsigned char* p)
+    {
+        std::uint64_t value{ };
+        std::memcpy(&value, p, sizeof(value));
+        if constexpr (std::endian::native == std::endian::big)
+            value = __builtin_bswap64(value);
+        return value;
+    }
+
+    inline std::uint32_t read32(const unsigned char* p)
+    {
+        std::uint32_t value{ };
+        std::memcpy(&value, p, sizeof(value));
+        if constexpr (std::endian::native == std::endian::big)
+            value = __builtin_bswap32(value);
+        return value;
+    }
+
+    inline std::uint64_t round(std::uint64_t accumulator, std::uint64_t input)
+    {
+        accumulator += input * prime2;
+        return std::rotl(accumulator, 31) * prime1;
+    }
+
+    inline std::uint64_t mergeRound(std::uint64_t hash, std::uint64_t accumulator)
+    {
+        hash ^= round(0, accumulator);
+        return hash * prime1 + prime4;
+    }
+}
+
+inline std::uint64_t xxHash64(const void* data, std::size_t size, std::uint64_t seed = 0)
+{
+    using namespace xxHashDetail;
+
+    const unsigned char* p{ static_cast<const unsigned char*>(data) };
+    const unsigned char* const end{ p + size };
+    std::uint64_t hash{ };
+
+    if (size >= 32)
+    {
+        // Four independent lanes over 32-byte stripes, so the multiplies can overlap.
+        std::uint64_t lane1{ seed + prime1 + prime2 };
+        std::uint64_t lane2{ seed + prime2 };
+        std::uint64_t lane3{ seed };
+        std::uint64_t lane4{ seed - prime1 };
+        for (; end - p >= 32; p += 32)
+        {
+            lane1 = round(lane1, read64(p));
+            lane2 = round(lane2, read64(p + 8));
+            lane3 = round(lane3, read64(p + 16));
+            lane4 = round(lane4, read64(p + 24));
+        }
+        hash = std::rotl(lane1, 1) + std::rotl(lane2, 7) + std::rotl(lane3, 12) + std::rotl(lane4, 18);
+        hash = mergeRound(hash, lane1);
+        hash = mergeRound(hash, lane2);
+        hash = mergeRound(hash, lane3);
+        hash = mergeRound(hash, lane4);
+    }
+    else
+    {
+        hash = seed + prime5;
+    }
+
+    hash += size;
+    for (; end - p >= 8; p += 8)
+        hash = std::rotl(hash ^ round(0, read64(p)), 27) * prime1 + prime4;
+    if (end - p >= 4)
+    {
+        hash = std::rotl(hash ^ (read32(p) * prime1), 23) * prime2 + prime3;
+        p += 4;
+    }
+    for (; p < end; ++p)
+        hash = std::rotl(hash ^ (*p * prime5), 11) * prime1;
+
+    // Final mix, so every input bit affects every output bit.
+    hash ^= hash >> 33;
+    hash *= prime2;
+    hash ^= hash >> 29;
+    hash *= prime3;
+    hash ^= hash >> 32;
+    return hash;
+}
+
+#endif